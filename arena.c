@@ -0,0 +1,134 @@
+/***********************************************************************************
+ * File: arena.c
+ * Author: Justin Hardy
+ * Procedures:
+ * arenaInit	- Prepares an empty arena.
+ * arenaAlloc	- Allocates aligned memory from an arena.
+ * arenaReset	- Frees every allocation of an arena at once.
+ * arenaFree	- Frees the memory of an arena.
+ *
+ * Every worker thread owns an arena holding the state of the simulation it is
+ * running. Policies carve their frame tables from it once per simulation, in
+ * place of variable length arrays that overflow the stack at large wss, and
+ * the worker resets it between simulations by rewinding a single offset.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include "arena.h"
+
+// Rounds a size up to a multiple of the arena alignment
+#define ARENA_ROUND(bytes)	(((bytes) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/***********************************************************************************
+ * int arenaInit( Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prepares an empty arena with its initial buffer.
+ *
+ * Parameters:
+ * 	arena		O/P	Arena *	The arena to prepare
+ * 	arenaInit	O/P	int		0 on success, -1 on failure
+ ***********************************************************************************/
+int arenaInit( Arena *arena ) {
+	arena->capacity = ARENA_INITIAL_BYTES;
+	arena->used = 0;
+	arena->overflow = NULL;
+	arena->overflowBytes = 0;
+	arena->buffer = aligned_alloc(ARENA_ALIGNMENT, arena->capacity);
+	return arena->buffer != NULL ? 0 : -1;
+}
+
+/***********************************************************************************
+ * void *arenaAlloc( Arena *arena, size_t bytes )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Allocates memory aligned to a cache line from an arena. Memory is
+ *					not initialized. If the buffer is exhausted, the memory comes
+ *					from a separate overflow block, and the buffer is grown to
+ *					fit at the next reset.
+ *
+ * Parameters:
+ * 	arena		I/O	Arena *	The arena to allocate from
+ * 	bytes		I/P	size_t	The number of bytes to allocate
+ * 	arenaAlloc	O/P	void *	The allocated memory, NULL on failure
+ ***********************************************************************************/
+void *arenaAlloc( Arena *arena, size_t bytes ) {
+	bytes = ARENA_ROUND(bytes > 0 ? bytes : 1);
+
+	// Carve from the buffer if it has room
+	if( bytes <= arena->capacity - arena->used ) {
+		void *memory = arena->buffer + arena->used;
+		arena->used += bytes;
+		return memory;
+	}
+
+	// Otherwise allocate an overflow block, with its header in the first line
+	ArenaBlock *block = aligned_alloc(ARENA_ALIGNMENT, ARENA_ALIGNMENT + bytes);
+	if( block == NULL ) {
+		return NULL;
+	}
+	block->next = arena->overflow;
+	arena->overflow = block;
+	arena->overflowBytes += bytes;
+	return (unsigned char *)block + ARENA_ALIGNMENT;
+}
+
+/***********************************************************************************
+ * void arenaReset( Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Frees every allocation of an arena at once. Unless allocations
+ *					overflowed the buffer since the previous reset, this only
+ *					rewinds the buffer; otherwise the buffer is grown to hold all
+ *					of them next time. If growing fails, the old buffer is kept.
+ *
+ * Parameters:
+ * 	arena	I/O	Arena *	The arena to reset
+ ***********************************************************************************/
+void arenaReset( Arena *arena ) {
+	arena->used = 0;
+	if( arena->overflow == NULL ) {
+		return;
+	}
+
+	// Free overflow blocks
+	size_t needed = arena->capacity + arena->overflowBytes;
+	while( arena->overflow != NULL ) {
+		ArenaBlock *next = arena->overflow->next;
+		free(arena->overflow);
+		arena->overflow = next;
+	}
+	arena->overflowBytes = 0;
+
+	// Grow buffer to hold every allocation
+	size_t capacity = arena->capacity;
+	while( capacity < needed ) {
+		capacity *= 2;
+	}
+	unsigned char *buffer = aligned_alloc(ARENA_ALIGNMENT, capacity);
+	if( buffer != NULL ) {
+		free(arena->buffer);
+		arena->buffer = buffer;
+		arena->capacity = capacity;
+	}
+}
+
+/***********************************************************************************
+ * void arenaFree( Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Frees the buffer and every overflow block of an arena.
+ *
+ * Parameters:
+ * 	arena	I/O	Arena *	The arena to free
+ ***********************************************************************************/
+void arenaFree( Arena *arena ) {
+	while( arena->overflow != NULL ) {
+		ArenaBlock *next = arena->overflow->next;
+		free(arena->overflow);
+		arena->overflow = next;
+	}
+	free(arena->buffer);
+	arena->buffer = NULL;
+	arena->capacity = arena->used = arena->overflowBytes = 0;
+}
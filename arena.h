@@ -0,0 +1,39 @@
+/***********************************************************************************
+ * File: arena.h
+ * Author: Justin Hardy
+ * Description: Declarations for the bump allocator holding the state of one
+ *					simulation at a time. See arena.c for implementation and
+ *					details.
+ ***********************************************************************************/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Arena constants
+#define ARENA_ALIGNMENT		64		// Alignment of every allocation (a cache line)
+#define ARENA_INITIAL_BYTES	4096	// Initial capacity of an arena
+
+// Memory that did not fit in an arena's buffer, until its next reset
+typedef struct arenaBlock {
+	struct arenaBlock *next;	// The next overflow block
+} ArenaBlock;
+
+// Bump allocator. Allocations are carved from one buffer and are all freed
+// together by a reset; the buffer grows at a reset if the allocations since
+// the previous one did not fit, so a steady state never calls malloc.
+typedef struct arena {
+	unsigned char *buffer;		// Memory allocations are carved from
+	size_t capacity;			// Size of the buffer
+	size_t used;				// Bytes of the buffer allocated since the last reset
+	ArenaBlock *overflow;		// Allocations that did not fit in the buffer
+	size_t overflowBytes;		// Total size of the overflow allocations
+} Arena;
+
+int arenaInit(Arena*);					// Prepares an empty arena
+void *arenaAlloc(Arena*,size_t);		// Allocates aligned memory from an arena
+void arenaReset(Arena*);				// Frees every allocation of an arena
+void arenaFree(Arena*);					// Frees an arena's memory
+
+#endif
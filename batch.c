@@ -0,0 +1,721 @@
+/***********************************************************************************
+ * File: batch.c
+ * Author: Justin Hardy
+ * Procedures:
+ * fifoBatch	- Performs FIFO for every wss of a range in one trace pass.
+ * clockBatch	- Performs Clock for every wss of a range in one trace pass.
+ * batchStart	- Lays out the frames and page table of a batch.
+ * batchFind	- Finds the entry of a page in the page table of a batch.
+ * batchDrop	- Removes a page from an instance, deleting it if unused.
+ * fifoLazy		- Performs FIFO for every wss of a range, pulling references.
+ * clockLazy	- Performs Clock for every wss of a range, pulling references.
+ * runLazy		- Performs an algorithm for every wss of a range, pulling references.
+ * fifoRun		- Continues FIFO for every instance of a batch.
+ * clockRun		- Continues Clock for every instance of a batch.
+ * speculate	- Simulates the segments of a trace concurrently.
+ * segmentMain	- Simulates a segment from a guessed state.
+ * batchSnapshot	- Records the state of every instance of a batch.
+ *
+ * A batch runs one instance of an algorithm per wss, all advancing in lockstep
+ * over the trace, which is read once for the whole range instead of once per
+ * wss. Instances are bit lanes: a page table maps every page held by any
+ * instance to a word whose bit j is set if instance j holds the page. A single
+ * lookup per reference thus answers the hit test of every instance at once,
+ * and only the instances that miss do any further work, on frames of their own
+ * stored back to back in one array. The sizes and hands of the instances are
+ * likewise stored side by side, as are Clock's second chance bits: the entry
+ * of a page holds them for every instance, so a hit gives every instance
+ * holding the page its second chance with a single OR.
+ *
+ * A long trace can be split into segments simulated concurrently. Every
+ * segment but the first starts from a guess: the state left by the few
+ * thousand references before it, simulated from empty frames. Its state is
+ * recorded every BATCH_INTERVAL references, with the faults so far. Then, in
+ * order, the true state at the end of the previous segment is carried into
+ * the segment one interval at a time, until it matches the guessed run's:
+ * both runs are then bound to fault alike until the end, so the rest of the
+ * segment's faults, and its final state, are the guessed run's. Two states
+ * match when every instance holds the same pages in the same order from its
+ * hand, with the same second chances. A guess usually converges within its
+ * first intervals, so the sequential part is small, and a segment that never
+ * converges is simply simulated again in full: the faults are always exactly
+ * those of a serial pass.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "batch.h"
+
+// Entry of the page table of a batch
+typedef struct batchEntry {
+	PageKey page;				// The page
+	uint64_t members;			// Bit j set if instance j holds the page; 0 if the slot is empty
+	uint64_t referenced;		// Bit j set if the page has a second chance in instance j
+} BatchEntry;
+
+// Frames and page table of every instance of a batch; instance j has wss lower+j
+typedef struct batch {
+	uint64_t all;				// Bit j set for every instance j
+	int frames;					// Number of frames of every instance together
+	int *offset;				// Index of the first frame of each instance
+	int *size;					// Number of filled frames of each instance
+	int *hand;					// Hand of each instance
+	PageKey *pages;				// Page held by each frame
+	BatchEntry *entries;		// Open addressing page table
+	size_t mask;				// Number of slots of the page table minus one
+} Batch;
+
+static int batchStart(Batch*,int,int,Arena*);		// Lays out a batch
+static BatchEntry *batchFind(Batch*,PageKey);		// Finds the entry of a page
+static void batchDrop(Batch*,PageKey,int);			// Removes a page from an instance
+
+// Continues an algorithm for every instance of a batch
+typedef void (*BatchRun)(Batch*,int,const PageKey[],long,long[]);
+
+// One segment of a trace, simulated from a guessed state
+typedef struct batchSegment {
+	pthread_t thread;			// Thread simulating the segment
+	int started;				// Non-zero if the thread was started
+	BatchRun run;				// Algorithm to simulate
+	const PageKey *data;		// References of the segment
+	long length;				// Number of references of the segment
+	long warmup;				// References before the segment to guess its state from
+	int lower;					// The smallest working set size
+	int upper;					// The largest working set size
+	Arena arena;				// Arena of the segment's batch and states
+	Batch batch;				// The guessed run, in its state at the end of the segment
+	int intervals;				// Number of intervals of the segment
+	PageKey *pages;				// Pages held from the hand of every instance after each interval
+	uint8_t *referenced;		// Their second chances
+	int *sizes;					// Filled frames of every instance after each interval
+	long *faults;				// Faults of every instance up to the end of each interval
+	int failed;					// Non-zero if the segment could not be simulated
+} BatchSegment;
+
+static void fifoRun(Batch*,int,const PageKey[],long,long[]);		// Continues FIFO
+static void clockRun(Batch*,int,const PageKey[],long,long[]);		// Continues Clock
+static int speculate(int,int,int,const PageKey[],long,long[],Arena*,BatchRun);	// Runs segments
+static int runLazy(int,int,const PageSource*,long,long[],Arena*,BatchRun);	// Pulls references
+static void *segmentMain(void*);									// Runs one segment
+static void batchSnapshot(Batch*,int,PageKey[],uint8_t[],int[]);	// Records a state
+
+/***********************************************************************************
+ * int fifoBatch( int lower, int upper, const PageKey data[], long length,
+ *				long faults[], const EngineConfig *settings,
+ *				Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the FIFO virtual memory replacement algorithm on a given
+ *					data set for every wss from lower to upper at once, counting
+ *					the page faults of each exactly as FIFO() does.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size, at most
+ *										BATCH_MAX_INSTANCES above lower
+ * 	data		I/P	const PageKey []	The data to perform the algorithm on
+ * 	length		I/P	long				The number of references in the data
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	settings	I/P	const EngineConfig *	The engine settings
+ * 	arena		I/O	Arena *				The arena to allocate the batch from
+ * 	fifoBatch	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int fifoBatch( int lower, int upper, const PageKey data[], long length, long faults[],
+			   const EngineConfig *settings, Arena *arena ) {
+	Batch batch;
+	int wss;
+
+	// Split a long trace into segments simulated concurrently
+	if( settings->threads > 1 && length >= 2 * (long)BATCH_SEGMENT ) {
+		return speculate(settings->threads, lower, upper, data, length, faults, arena, fifoRun);
+	}
+
+	// Lay out empty frames
+	if( batchStart(&batch, lower, upper, arena) != 0 ) {
+		return -1;
+	}
+	for( wss = lower; wss <= upper; wss++ ) {
+		faults[wss] = 0;
+	}
+	fifoRun(&batch, lower, data, length, faults);
+	return 0;
+}
+
+/***********************************************************************************
+ * int fifoLazy( int lower, int upper, const PageSource *source, long length,
+ *				long faults[], Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the FIFO virtual memory replacement algorithm for every
+ *					wss from lower to upper at once, as fifoBatch() does, on
+ *					references pulled from a source a block at a time.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size
+ * 	source		I/P	const PageSource *	The source of the references
+ * 	length		I/P	long				The number of references to pull
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	arena		I/O	Arena *				The arena to allocate the batch from
+ * 	fifoLazy	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int fifoLazy( int lower, int upper, const PageSource *source, long length, long faults[], Arena *arena ) {
+	return runLazy(lower, upper, source, length, faults, arena, fifoRun);
+}
+
+/***********************************************************************************
+ * int clockLazy( int lower, int upper, const PageSource *source, long length,
+ *				long faults[], Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the Clock virtual memory replacement algorithm for every
+ *					wss from lower to upper at once, as clockBatch() does, on
+ *					references pulled from a source a block at a time.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size
+ * 	source		I/P	const PageSource *	The source of the references
+ * 	length		I/P	long				The number of references to pull
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	arena		I/O	Arena *				The arena to allocate the batch from
+ * 	clockLazy	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int clockLazy( int lower, int upper, const PageSource *source, long length, long faults[], Arena *arena ) {
+	return runLazy(lower, upper, source, length, faults, arena, clockRun);
+}
+
+/***********************************************************************************
+ * int runLazy( int lower, int upper, const PageSource *source, long length,
+ *				long faults[], Arena *arena, BatchRun run )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs an algorithm for every wss from lower to upper at once on
+ *					references pulled from a source into one reused block.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size
+ * 	source		I/P	const PageSource *	The source of the references
+ * 	length		I/P	long				The number of references to pull
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	arena		I/O	Arena *				The arena to allocate the batch from
+ * 	run			I/P	BatchRun			The algorithm
+ * 	runLazy		O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+static int runLazy( int lower, int upper, const PageSource *source, long length, long faults[], Arena *arena,
+					BatchRun run ) {
+	Batch batch;
+	long start, count;
+	int wss;
+
+	PageKey *block = arenaAlloc(arena, PAGE_SOURCE_BLOCK * sizeof(PageKey));
+	if( block == NULL || batchStart(&batch, lower, upper, arena) != 0 ) {
+		return -1;
+	}
+	for( wss = lower; wss <= upper; wss++ ) {
+		faults[wss] = 0;
+	}
+	for( start = 0; start < length; start += count ) {
+		count = length - start < PAGE_SOURCE_BLOCK ? length - start : PAGE_SOURCE_BLOCK;
+		source->fill(source, start, block, count);
+		run(&batch, lower, block, count, faults);
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * void fifoRun( Batch *batch, int lower, const PageKey data[], long length,
+ *				long faults[] )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Continues FIFO for every instance of a batch over a given data set.
+ *
+ * Parameters:
+ * 	batch		I/O	Batch *				The batch, in the state left by the previous
+ *										references
+ * 	lower		I/P	int					The wss of the first instance
+ * 	data		I/P	const PageKey []	The data to perform the algorithm on
+ * 	length		I/P	long				The number of references in the data
+ * 	faults		I/O	long []				The page faults, indexed by wss, added to
+ ***********************************************************************************/
+static void fifoRun( Batch *batch, int lower, const PageKey data[], long length, long faults[] ) {
+	PageKey victims[BATCH_MAX_INSTANCES];	// Pages evicted by the current reference
+	int victimLanes[BATCH_MAX_INSTANCES];	// Instances they were evicted from
+	long i;
+	int wss, j, k, evicted;
+
+	// Run FIFO Algorithm on the array, every wss in lockstep
+	for( i = 0; i < length; i++ ) {
+		PageKey page = data[i];
+
+		// Find the instances without the page
+		BatchEntry *entry = batchFind(batch, page);
+		uint64_t missing = batch->all & ~entry->members;
+
+		// Let each of them take the page in
+		evicted = 0;
+		for( uint64_t lanes = missing; lanes != 0; lanes &= lanes - 1 ) {
+			j = __builtin_ctzll(lanes);
+			wss = lower + j;
+
+			// Check if set has room for more pages
+			if( batch->size[j] != wss ) {
+				batch->pages[batch->offset[j] + batch->size[j]++] = page;
+			}
+			else {
+				// Page fault has occurred; replace using first-in-first-out index
+				k = batch->offset[j] + batch->hand[j];
+				victims[evicted] = batch->pages[k];
+				victimLanes[evicted++] = j;
+				batch->pages[k] = page;
+				batch->hand[j] = batch->hand[j] == wss - 1 ? 0 : batch->hand[j] + 1;
+				faults[wss]++;
+			}
+		}
+		if( missing == 0 ) {
+			continue;
+		}
+		entry->page = page;
+		entry->members |= missing;
+
+		// Remove the evicted pages from their instances
+		while( evicted > 0 ) {
+			evicted--;
+			batchDrop(batch, victims[evicted], victimLanes[evicted]);
+		}
+	}
+}
+
+/***********************************************************************************
+ * int clockBatch( int lower, int upper, const PageKey data[], long length,
+ *				long faults[], const EngineConfig *settings,
+ *				Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the Clock virtual memory replacement algorithm on a given
+ *					data set for every wss from lower to upper at once, counting
+ *					the page faults of each exactly as Clock() does.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size, at most
+ *										BATCH_MAX_INSTANCES above lower
+ * 	data		I/P	const PageKey []	The data to perform the algorithm on
+ * 	length		I/P	long				The number of references in the data
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	settings	I/P	const EngineConfig *	The engine settings
+ * 	arena		I/O	Arena *				The arena to allocate the batch from
+ * 	clockBatch	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int clockBatch( int lower, int upper, const PageKey data[], long length, long faults[],
+			   const EngineConfig *settings, Arena *arena ) {
+	Batch batch;
+	int wss;
+
+	// Split a long trace into segments simulated concurrently
+	if( settings->threads > 1 && length >= 2 * (long)BATCH_SEGMENT ) {
+		return speculate(settings->threads, lower, upper, data, length, faults, arena, clockRun);
+	}
+
+	// Lay out empty frames
+	if( batchStart(&batch, lower, upper, arena) != 0 ) {
+		return -1;
+	}
+	for( wss = lower; wss <= upper; wss++ ) {
+		faults[wss] = 0;
+	}
+	clockRun(&batch, lower, data, length, faults);
+	return 0;
+}
+
+/***********************************************************************************
+ * void clockRun( Batch *batch, int lower, const PageKey data[], long length,
+ *				long faults[] )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Continues Clock for every instance of a batch over a given data set.
+ *
+ * Parameters:
+ * 	batch		I/O	Batch *				The batch, in the state left by the previous
+ *										references
+ * 	lower		I/P	int					The wss of the first instance
+ * 	data		I/P	const PageKey []	The data to perform the algorithm on
+ * 	length		I/P	long				The number of references in the data
+ * 	faults		I/O	long []				The page faults, indexed by wss, added to
+ ***********************************************************************************/
+static void clockRun( Batch *batch, int lower, const PageKey data[], long length, long faults[] ) {
+	PageKey victims[BATCH_MAX_INSTANCES];	// Pages evicted by the current reference
+	int victimLanes[BATCH_MAX_INSTANCES];	// Instances they were evicted from
+	long i;
+	int wss, j, k, evicted;
+
+	// Run Clock Algorithm on the array, every wss in lockstep
+	for( i = 0; i < length; i++ ) {
+		PageKey page = data[i];
+
+		// Give the page a second chance in every instance holding it
+		BatchEntry *entry = batchFind(batch, page);
+		uint64_t missing = batch->all & ~entry->members;
+		entry->referenced |= entry->members;
+		if( missing == 0 ) {
+			continue;
+		}
+
+		// Let each instance without it take the page in
+		evicted = 0;
+		for( uint64_t lanes = missing; lanes != 0; lanes &= lanes - 1 ) {
+			j = __builtin_ctzll(lanes);
+			wss = lower + j;
+			uint64_t lane = (uint64_t)1 << j;
+
+			// Check if set has room for more pages
+			if( batch->size[j] != wss ) {
+				batch->pages[batch->offset[j] + batch->size[j]++] = page;
+				continue;
+			}
+
+			// Page fault has occurred; advance the hand past the pages with a
+			// second chance, removing it
+			for( ;; ) {
+				k = batch->offset[j] + batch->hand[j];
+				BatchEntry *held = batchFind(batch, batch->pages[k]);
+				if( !(held->referenced & lane) ) {
+					break;
+				}
+				held->referenced &= ~lane;
+				batch->hand[j] = batch->hand[j] == wss - 1 ? 0 : batch->hand[j] + 1;
+			}
+
+			// Replace the page under the hand
+			victims[evicted] = batch->pages[k];
+			victimLanes[evicted++] = j;
+			batch->pages[k] = page;
+			batch->hand[j] = batch->hand[j] == wss - 1 ? 0 : batch->hand[j] + 1;
+			faults[wss]++;
+		}
+		entry->page = page;
+		entry->members |= missing;
+
+		// Remove the evicted pages from their instances
+		while( evicted > 0 ) {
+			evicted--;
+			batchDrop(batch, victims[evicted], victimLanes[evicted]);
+		}
+	}
+}
+
+/***********************************************************************************
+ * int batchStart( Batch *batch, int lower, int upper, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Allocates the frames of one instance per wss from lower to upper
+ *					back to back, all empty, with every hand at the first frame,
+ *					and an empty page table large enough to stay under half
+ *					full.
+ *
+ * Parameters:
+ * 	batch		O/P	Batch *	The batch to lay out
+ * 	lower		I/P	int		The smallest working set size
+ * 	upper		I/P	int		The largest working set size
+ * 	arena		I/O	Arena *	The arena to allocate the batch from
+ * 	batchStart	O/P	int		0 on success, -1 on failure
+ ***********************************************************************************/
+static int batchStart( Batch *batch, int lower, int upper, Arena *arena ) {
+	int instances = upper - lower + 1, j;
+	if( instances < 1 || instances > BATCH_MAX_INSTANCES ) {
+		return -1;
+	}
+	batch->all = instances == 64 ? ~(uint64_t)0 : ((uint64_t)1 << instances) - 1;
+
+	// Place the frames of each instance after the previous one
+	batch->offset = arenaAlloc(arena, instances * sizeof(int));
+	batch->size = arenaAlloc(arena, instances * sizeof(int));
+	batch->hand = arenaAlloc(arena, instances * sizeof(int));
+	if( batch->offset == NULL || batch->size == NULL || batch->hand == NULL ) {
+		return -1;
+	}
+	batch->frames = 0;
+	for( j = 0; j < instances; j++ ) {
+		batch->offset[j] = batch->frames;
+		batch->size[j] = 0;
+		batch->hand[j] = 0;
+		batch->frames += lower + j;
+	}
+	batch->pages = arenaAlloc(arena, batch->frames * sizeof(PageKey));
+
+	// Size the page table for every frame holding a different page
+	batch->mask = 1;
+	while( batch->mask < 2 * (size_t)batch->frames ) {
+		batch->mask *= 2;
+	}
+	batch->entries = arenaAlloc(arena, batch->mask * sizeof(BatchEntry));
+	if( batch->pages == NULL || batch->entries == NULL ) {
+		return -1;
+	}
+	memset(batch->entries, 0, batch->mask * sizeof(BatchEntry));
+	batch->mask--;
+	return 0;
+}
+
+/***********************************************************************************
+ * BatchEntry *batchFind( Batch *batch, PageKey page )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Finds the entry of a page in the page table of a batch. If no
+ *					instance holds the page, the empty slot where its entry
+ *					belongs is returned, with no members.
+ *
+ * Parameters:
+ * 	batch		I/P	Batch *			The batch to search
+ * 	page		I/P	PageKey			The page to find
+ * 	batchFind	O/P	BatchEntry *	The entry of the page
+ ***********************************************************************************/
+static BatchEntry *batchFind( Batch *batch, PageKey page ) {
+	size_t slot = (size_t)((page * 0x9E3779B97F4A7C15ULL) >> 32) & batch->mask;
+	while( batch->entries[slot].members != 0 && batch->entries[slot].page != page ) {
+		slot = (slot + 1) & batch->mask;
+	}
+	return &batch->entries[slot];
+}
+
+/***********************************************************************************
+ * void batchDrop( Batch *batch, PageKey page, int instance )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Removes a page from an instance. Once no instance holds the page,
+ *					its entry is deleted, shifting back the entries after it
+ *					that would otherwise no longer be found.
+ *
+ * Parameters:
+ * 	batch		I/O	Batch *		The batch to update
+ * 	page		I/P	PageKey		The page to remove
+ * 	instance	I/P	int			The index of the instance (wss - lower)
+ ***********************************************************************************/
+static void batchDrop( Batch *batch, PageKey page, int instance ) {
+	BatchEntry *entries = batch->entries;
+	size_t hole = batchFind(batch, page) - entries, slot, home;
+
+	// Remove from the instance
+	entries[hole].members &= ~((uint64_t)1 << instance);
+	entries[hole].referenced &= ~((uint64_t)1 << instance);
+	if( entries[hole].members != 0 ) {
+		return;
+	}
+
+	// Delete the entry, moving back every later entry of the cluster whose
+	// home slot is not between the hole and itself
+	for( slot = (hole + 1) & batch->mask; entries[slot].members != 0; slot = (slot + 1) & batch->mask ) {
+		home = (size_t)((entries[slot].page * 0x9E3779B97F4A7C15ULL) >> 32) & batch->mask;
+		if( ((slot - home) & batch->mask) >= ((slot - hole) & batch->mask) ) {
+			entries[hole] = entries[slot];
+			hole = slot;
+		}
+	}
+	entries[hole].members = 0;
+	entries[hole].referenced = 0;
+}
+
+/***********************************************************************************
+ * int speculate( int threads, int lower, int upper, const PageKey data[],
+ *				long length, long faults[], Arena *arena, BatchRun run )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs an algorithm for every wss from lower to upper at once,
+ *					splitting the data set into up to threads segments
+ *					simulated concurrently from guessed states, then correcting
+ *					each in order from the true state at its start.
+ *
+ * Parameters:
+ * 	threads		I/P	int					The most segments simulated concurrently
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size
+ * 	data		I/P	const PageKey []	The data to perform the algorithm on
+ * 	length		I/P	long				The number of references in the data
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	arena		I/O	Arena *				The arena to allocate the true state from
+ * 	run			I/P	BatchRun			The algorithm
+ * 	speculate	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+static int speculate( int threads, int lower, int upper, const PageKey data[], long length, long faults[],
+					  Arena *arena, BatchRun run ) {
+	BatchSegment *segments;
+	Batch first, *truth = &first;
+	PageKey *pages;
+	uint8_t *referenced;
+	int *sizes;
+	long start = 0, done, step;
+	int count = threads, instances = upper - lower + 1, k, c, j, wss, failed = 0;
+
+	// Split the data into segments of at least BATCH_SEGMENT references
+	if( count > length / BATCH_SEGMENT ) {
+		count = (int)(length / BATCH_SEGMENT);
+	}
+	segments = arenaAlloc(arena, count * sizeof(BatchSegment));
+	if( segments == NULL || batchStart(&first, lower, upper, arena) != 0 ) {
+		return -1;
+	}
+	pages = arenaAlloc(arena, first.frames * sizeof(PageKey));
+	referenced = arenaAlloc(arena, first.frames * sizeof(uint8_t));
+	sizes = arenaAlloc(arena, instances * sizeof(int));
+	if( pages == NULL || referenced == NULL || sizes == NULL ) {
+		return -1;
+	}
+	for( k = 0; k < count; k++ ) {
+		segments[k].run = run;
+		segments[k].data = data + start;
+		segments[k].length = (length - start) / (count - k);
+		segments[k].warmup = start < BATCH_WARMUP ? start : BATCH_WARMUP;
+		segments[k].lower = lower;
+		segments[k].upper = upper;
+		segments[k].started = 0;
+		start += segments[k].length;
+	}
+
+	// Guess every segment but the first on its own thread, then simulate the
+	// first here from empty frames
+	for( k = 1; k < count; k++ ) {
+		segments[k].started = pthread_create(&segments[k].thread, NULL, segmentMain, &segments[k]) == 0;
+	}
+	for( wss = lower; wss <= upper; wss++ ) {
+		faults[wss] = 0;
+	}
+	run(&first, lower, segments[0].data, segments[0].length, faults);
+
+	// Carry the true state into each segment in order until it matches the
+	// guessed one
+	for( k = 1; k < count; k++ ) {
+		BatchSegment *segment = &segments[k];
+		if( segment->started ) {
+			pthread_join(segment->thread, NULL);
+		}
+		else {
+			segmentMain(segment);
+		}
+		failed |= segment->failed;
+		if( failed ) {
+			continue;
+		}
+		for( c = 0, done = 0; c < segment->intervals; c++, done += step ) {
+			step = segment->length - done < BATCH_INTERVAL ? segment->length - done : BATCH_INTERVAL;
+			run(truth, lower, segment->data + done, step, faults);
+			batchSnapshot(truth, lower, pages, referenced, sizes);
+			if( memcmp(sizes, segment->sizes + (size_t)c * instances, instances * sizeof(int)) == 0 &&
+				memcmp(pages, segment->pages + (size_t)c * first.frames, first.frames * sizeof(PageKey)) == 0 &&
+				memcmp(referenced, segment->referenced + (size_t)c * first.frames, first.frames) == 0 ) {
+				// Take the rest of the segment from the guessed run
+				for( j = 0; j < instances; j++ ) {
+					faults[lower + j] += segment->faults[(size_t)(segment->intervals - 1) * instances + j] -
+										 segment->faults[(size_t)c * instances + j];
+				}
+				truth = &segment->batch;
+				break;
+			}
+		}
+	}
+
+	// Free the segments once no true state lives in them
+	for( k = 1; k < count; k++ ) {
+		if( !segments[k].failed ) {
+			arenaFree(&segments[k].arena);
+		}
+	}
+	return failed ? -1 : 0;
+}
+
+/***********************************************************************************
+ * void *segmentMain( void *argument )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Simulates a segment from the state left by the references just
+ *					before it, simulated from empty frames, recording the state
+ *					and faults of every instance after each interval. Every
+ *					allocation is made from the segment's own arena, which the
+ *					caller frees on success.
+ *
+ * Parameters:
+ * 	argument	I/O	void *	The BatchSegment to simulate
+ * 	segmentMain	O/P	void *	NULL
+ ***********************************************************************************/
+static void *segmentMain( void *argument ) {
+	BatchSegment *segment = argument;
+	int instances = segment->upper - segment->lower + 1, c, j;
+	long done, step, *counts;
+	size_t frames;
+
+	segment->failed = 1;
+	if( arenaInit(&segment->arena) != 0 ) {
+		return NULL;
+	}
+	segment->intervals = (int)((segment->length + BATCH_INTERVAL - 1) / BATCH_INTERVAL);
+	counts = arenaAlloc(&segment->arena, (segment->upper + 1) * sizeof(long));
+	if( counts == NULL || batchStart(&segment->batch, segment->lower, segment->upper, &segment->arena) != 0 ) {
+		arenaFree(&segment->arena);
+		return NULL;
+	}
+	frames = (size_t)segment->intervals * segment->batch.frames;
+	segment->pages = arenaAlloc(&segment->arena, frames * sizeof(PageKey));
+	segment->referenced = arenaAlloc(&segment->arena, frames * sizeof(uint8_t));
+	segment->sizes = arenaAlloc(&segment->arena, (size_t)segment->intervals * instances * sizeof(int));
+	segment->faults = arenaAlloc(&segment->arena, (size_t)segment->intervals * instances * sizeof(long));
+	if( segment->pages == NULL || segment->referenced == NULL || segment->sizes == NULL || segment->faults == NULL ) {
+		arenaFree(&segment->arena);
+		return NULL;
+	}
+
+	// Guess the starting state from the references just before the segment
+	segment->run(&segment->batch, segment->lower, segment->data - segment->warmup, segment->warmup, counts);
+	memset(counts, 0, (segment->upper + 1) * sizeof(long));
+
+	// Simulate the segment, recording every interval
+	for( c = 0, done = 0; c < segment->intervals; c++, done += step ) {
+		step = segment->length - done < BATCH_INTERVAL ? segment->length - done : BATCH_INTERVAL;
+		segment->run(&segment->batch, segment->lower, segment->data + done, step, counts);
+		batchSnapshot(&segment->batch, segment->lower, segment->pages + (size_t)c * segment->batch.frames,
+					  segment->referenced + (size_t)c * segment->batch.frames, segment->sizes + (size_t)c * instances);
+		for( j = 0; j < instances; j++ ) {
+			segment->faults[(size_t)c * instances + j] = counts[segment->lower + j];
+		}
+	}
+	segment->failed = 0;
+	return NULL;
+}
+
+/***********************************************************************************
+ * void batchSnapshot( Batch *batch, int lower, PageKey pages[],
+ *				uint8_t referenced[], int sizes[] )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Records the state of every instance of a batch: the pages it
+ *					holds in order from its hand, whether each has a second
+ *					chance, and the number of filled frames. Two batches with
+ *					the same records fault alike on any further references.
+ *
+ * Parameters:
+ * 	batch		I/P	Batch *		The batch to record
+ * 	lower		I/P	int			The wss of the first instance
+ * 	pages		O/P	PageKey []	The pages of every instance, laid out as its frames,
+ *								with 0 for the empty frames
+ * 	referenced	O/P	uint8_t []	1 for each page with a second chance, 0 otherwise
+ * 	sizes		O/P	int []		The number of filled frames of every instance
+ ***********************************************************************************/
+static void batchSnapshot( Batch *batch, int lower, PageKey pages[], uint8_t referenced[], int sizes[] ) {
+	int instances = __builtin_popcountll(batch->all), j, k, wss, frame;
+
+	for( j = 0; j < instances; j++ ) {
+		wss = lower + j;
+		sizes[j] = batch->size[j];
+		for( k = 0; k < wss; k++ ) {
+			frame = batch->offset[j] + k;
+			if( k < batch->size[j] ) {
+				pages[frame] = batch->pages[batch->offset[j] + (batch->hand[j] + k) % wss];
+				referenced[frame] = (batchFind(batch, pages[frame])->referenced >> j) & 1;
+			}
+			else {
+				pages[frame] = 0;
+				referenced[frame] = 0;
+			}
+		}
+	}
+}
@@ -0,0 +1,25 @@
+/***********************************************************************************
+ * File: batch.h
+ * Author: Justin Hardy
+ * Description: Declarations for the batched engines, which simulate a replacement
+ *					algorithm for a whole range of wss in one pass over a trace.
+ *					See batch.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "replaceAlgos.h"
+
+// Batch constants
+#define BATCH_MAX_INSTANCES	64		// Most wss one batch simulates, one per bit of a word
+#define BATCH_SEGMENT		65536	// Fewest references of a segment worth its own thread
+#define BATCH_WARMUP		4096	// References before a segment its guessed state is built from
+#define BATCH_INTERVAL		1024	// References between two comparisons of a segment's states
+
+int fifoBatch(int,int,const PageKey[],long,long[],const EngineConfig*,Arena*);		// Performs FIFO for a range of wss
+int clockBatch(int,int,const PageKey[],long,long[],const EngineConfig*,Arena*);		// Performs Clock for a range of wss
+int fifoLazy(int,int,const PageSource*,long,long[],Arena*);		// Performs FIFO pulling references
+int clockLazy(int,int,const PageSource*,long,long[],Arena*);	// Performs Clock pulling references
+
+#endif
@@ -0,0 +1,101 @@
+/***********************************************************************************
+ * File: belady.c
+ * Author: Justin Hardy
+ * Procedures:
+ * beladyInit	- Prepares a detector of Belady's anomaly.
+ * beladyCheck	- Checks the faults of one trace for the anomaly.
+ * beladySave	- Saves an offending trace to a trace file of its own.
+ *
+ * FIFO, unlike LRU, may fault more with more frames. The detector inspects the
+ * faults of every trace of a sweep as soon as it finishes, so a sweep over
+ * millions of generated traces finds each one where some policy faults more at
+ * wss + 1 than at wss, rather than only anomalies large enough to survive
+ * averaging. Every policy is checked; LRU, a stack algorithm, never shows the
+ * anomaly. Each offending trace is saved as a trace file of its own, named
+ * after its number, which can be replayed with --trace. Checks update the
+ * counts of the detector and are serialized by the caller, while saves only
+ * read the immutable trace, so that the file is written outside any lock.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "belady.h"
+#include "tracefile.h"
+
+/***********************************************************************************
+ * void beladyInit( Belady *belady, const char *dir, uint16_t flags )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prepares a detector with no anomalies found yet.
+ *
+ * Parameters:
+ * 	belady	O/P	Belady *		The detector to prepare
+ * 	dir		I/P	const char *	The directory to save offending traces to, which
+ *								must exist
+ * 	flags	I/P	uint16_t		Trace file flags of saved traces (TRACE_FLAG_*)
+ ***********************************************************************************/
+void beladyInit( Belady *belady, const char *dir, uint16_t flags ) {
+	memset(belady, 0, sizeof(Belady));
+	belady->dir = dir;
+	belady->flags = flags;
+}
+
+/***********************************************************************************
+ * int beladyCheck( Belady *belady, long faults[POLICY_COUNT][SET_SIZE_UPPER+1] )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Counts every wss at which a policy faults less on a trace than at
+ *					the next wss. Not thread-safe; callers serialize checks.
+ *
+ * Parameters:
+ * 	belady		I/O	Belady *	The detector
+ * 	faults		I/P	long [][]	The faults of the trace per policy and wss
+ * 	beladyCheck	O/P	int			1 if the trace shows the anomaly, 0 if not
+ ***********************************************************************************/
+int beladyCheck( Belady *belady, long faults[POLICY_COUNT][SET_SIZE_UPPER+1] ) {
+	int policy, wss, cells, anomalous = 0;
+
+	belady->checked++;
+
+	// Count the wss at which faults grow with the wss
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		cells = 0;
+		for( wss = SET_SIZE_LOWER; wss < SET_SIZE_UPPER; wss++ ) {
+			cells += faults[policy][wss+1] > faults[policy][wss];
+		}
+		if( cells > 0 ) {
+			belady->traces[policy]++;
+			belady->cells[policy] += cells;
+			anomalous = 1;
+		}
+	}
+	return anomalous;
+}
+
+/***********************************************************************************
+ * int beladySave( const Belady *belady, const Trace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Saves an offending trace to the detector's directory, with its
+ *					writes if it has any. Safe to call from any thread at once.
+ *
+ * Parameters:
+ * 	belady		I/P	const Belady *	The detector
+ * 	trace		I/P	const Trace *	The trace
+ * 	beladySave	O/P	int				0 on success, -1 if the trace could not be saved
+ ***********************************************************************************/
+int beladySave( const Belady *belady, const Trace *trace ) {
+	TraceWriter writer;
+	char path[4096];
+
+	// Write the trace to a file named after its number
+	if( snprintf(path, sizeof(path), "%s/trace%ld.vmt", belady->dir, trace->number + 1) >= (int)sizeof(path) ||
+		traceWriterOpen(&writer, path, belady->flags | (trace->writes != NULL ? TRACE_FLAG_WRITES : 0), 0) != 0 ) {
+		return -1;
+	}
+	if( traceWriterAppend(&writer, trace->pages, trace->writes, trace->length) != 0 ) {
+		traceWriterClose(&writer);
+		return -1;
+	}
+	return traceWriterClose(&writer);
+}
@@ -0,0 +1,29 @@
+/***********************************************************************************
+ * File: belady.h
+ * Author: Justin Hardy
+ * Description: Declarations for the detector of Belady's anomaly, which flags
+ *					every trace whose faults grow with its wss. See belady.c
+ *					for implementation and details.
+ ***********************************************************************************/
+
+#ifndef BELADY_H
+#define BELADY_H
+
+#include <stdint.h>
+#include "replaceAlgos.h"
+#include "trace.h"
+
+// Belady's anomaly detector state
+typedef struct belady {
+	const char *dir;			// Directory offending traces are saved to
+	uint16_t flags;				// Trace file flags of saved traces
+	long checked;				// Traces checked
+	long traces[POLICY_COUNT];	// Traces showing the anomaly under each policy
+	long cells[POLICY_COUNT];	// (trace, wss) pairs faulting less than at wss + 1
+} Belady;
+
+void beladyInit(Belady*,const char*,uint16_t);	// Prepares a detector
+int beladyCheck(Belady*,long[POLICY_COUNT][SET_SIZE_UPPER+1]);	// Checks the faults of a trace
+int beladySave(const Belady*,const Trace*);		// Saves an offending trace
+
+#endif
@@ -0,0 +1,338 @@
+/***********************************************************************************
+ * File: checkpoint.c
+ * Author: Justin Hardy
+ * Procedures:
+ * checkpointInit	- Prepares an empty checkpoint for a sweep.
+ * checkpointLoad	- Resumes a checkpoint from a checkpoint file.
+ * checkpointSave	- Writes a checkpoint to a checkpoint file.
+ * checkpointFree	- Frees the memory of a checkpoint.
+ * writeWord		- Writes a little-endian 64-bit integer.
+ * readWord			- Reads a little-endian 64-bit integer.
+ *
+ * File layout (all integers little-endian u64 unless noted):
+ *	header	- magic "VMCK", u32 version
+ *	sweep	- seed, length, traces, shard, shards, source bytes, source
+ *	results	- policy count, wss bound, then the accumulated faults of every
+ *			  policy for every wss up to the bound, then likewise the
+ *			  accumulated evictions of dirty pages and fills of empty frames
+ *	belady	- traces checked for Belady's anomaly, then the anomalous traces
+ *			  and the anomalous (trace, wss) pairs of every policy
+ *	state	- finished traces, next trace, then the words of the finished
+ *			  trace bitmap from the word holding the next trace onwards
+ * Traces finish out of order, so besides the next trace (the first one not yet
+ * finished) the bitmap of the traces finished after it is kept. Random streams
+ * are derived from the seed and the trace number alone, so the seed is all the
+ * generator state a resumed sweep needs.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "checkpoint.h"
+
+static int writeWord(FILE*,uint64_t);		// Writes a little-endian integer
+static int readWord(FILE*,uint64_t*);		// Reads a little-endian integer
+
+/***********************************************************************************
+ * int checkpointInit( Checkpoint *checkpoint, uint64_t seed, long length,
+ *				long traces, int shard, int shards, const char *source )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prepares an empty checkpoint for a sweep, with no finished trace.
+ *
+ * Parameters:
+ * 	checkpoint		O/P	Checkpoint *	The checkpoint to prepare
+ * 	seed			I/P	uint64_t		The seed of generated traces
+ * 	length			I/P	long			The length of generated traces
+ * 	traces			I/P	long			The number of traces of the whole run
+ * 	shard			I/P	int				The shard of traces of the sweep
+ * 	shards			I/P	int				The number of shards of the run
+ * 	source			I/P	const char *	The workload or trace file of the run
+ * 	checkpointInit	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int checkpointInit( Checkpoint *checkpoint, uint64_t seed, long length, long traces,
+					int shard, int shards, const char *source ) {
+	memset(checkpoint, 0, sizeof(*checkpoint));
+	checkpoint->seed = seed;
+	checkpoint->length = length;
+	checkpoint->traces = traces;
+	checkpoint->shard = shard;
+	checkpoint->shards = shards;
+	checkpoint->source = strdup(source);
+	checkpoint->done = calloc(BITMAP_WORDS(traces) + 1, sizeof(uint64_t));
+	if( checkpoint->source == NULL || checkpoint->done == NULL ) {
+		checkpointFree(checkpoint);
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int checkpointLoad( Checkpoint *checkpoint, const char *path )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Resumes a checkpoint prepared by checkpointInit from a checkpoint
+ *					file, restoring its finished traces, their faults, their
+ *					write-backs and fills, and their Belady counts. The file
+ *					must have been written by a sweep with the same parameters.
+ *					A missing file leaves the checkpoint empty, as the sweep was
+ *					killed before its first checkpoint.
+ *
+ * Parameters:
+ * 	checkpoint		I/O	Checkpoint *	The checkpoint to resume
+ * 	path			I/P	const char *	The path of the checkpoint file
+ * 	checkpointLoad	O/P	int				0 on success, -1 on failure or mismatch
+ ***********************************************************************************/
+int checkpointLoad( Checkpoint *checkpoint, const char *path ) {
+	unsigned char header[8];
+	uint64_t value, sourceBytes, completed, next;
+	long policy, wss, word;
+	int status = -1;
+
+	// Open file
+	FILE *file = fopen(path, "rb");
+	if( file == NULL ) {
+		return errno == ENOENT ? 0 : -1;
+	}
+
+	// Read and validate header
+	if( fread(header, sizeof(header), 1, file) != 1 || memcmp(header, CHECKPOINT_MAGIC, 4) != 0 ||
+		(header[4] | header[5] << 8 | header[6] << 16 | (uint32_t)header[7] << 24) != CHECKPOINT_VERSION ) {
+		goto done;
+	}
+
+	// Check that the checkpoint belongs to this sweep
+	if( readWord(file, &value) != 0 || value != checkpoint->seed ||
+		readWord(file, &value) != 0 || value != (uint64_t)checkpoint->length ||
+		readWord(file, &value) != 0 || value != (uint64_t)checkpoint->traces ||
+		readWord(file, &value) != 0 || value != (uint64_t)checkpoint->shard ||
+		readWord(file, &value) != 0 || value != (uint64_t)checkpoint->shards ||
+		readWord(file, &sourceBytes) != 0 || sourceBytes != strlen(checkpoint->source) ) {
+		goto done;
+	}
+	for( value = 0; value < sourceBytes; value++ ) {
+		if( fgetc(file) != (unsigned char)checkpoint->source[value] ) {
+			goto done;
+		}
+	}
+	if( readWord(file, &value) != 0 || value != POLICY_COUNT ||
+		readWord(file, &value) != 0 || value != SET_SIZE_UPPER ) {
+		goto done;
+	}
+
+	// Read accumulated faults
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = 0; wss <= SET_SIZE_UPPER; wss++ ) {
+			if( readWord(file, &value) != 0 ) {
+				goto done;
+			}
+			checkpoint->faults[policy][wss] = (long)value;
+		}
+	}
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = 0; wss <= SET_SIZE_UPPER; wss++ ) {
+			if( readWord(file, &value) != 0 ) {
+				goto done;
+			}
+			checkpoint->writebacks[policy][wss] = (long)value;
+		}
+	}
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = 0; wss <= SET_SIZE_UPPER; wss++ ) {
+			if( readWord(file, &value) != 0 ) {
+				goto done;
+			}
+			checkpoint->fills[policy][wss] = (long)value;
+		}
+	}
+
+	// Read Belady counts
+	if( readWord(file, &value) != 0 ) {
+		goto done;
+	}
+	checkpoint->checked = (long)value;
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		if( readWord(file, &value) != 0 ) {
+			goto done;
+		}
+		checkpoint->anomalousTraces[policy] = (long)value;
+		if( readWord(file, &value) != 0 ) {
+			goto done;
+		}
+		checkpoint->anomalousCells[policy] = (long)value;
+	}
+
+	// Read finished traces; every trace before the next one is finished
+	if( readWord(file, &completed) != 0 || readWord(file, &next) != 0 ||
+		completed > (uint64_t)checkpoint->traces || next > (uint64_t)checkpoint->traces ) {
+		goto done;
+	}
+	for( word = 0; word < (long)(next / BITMAP_BITS); word++ ) {
+		checkpoint->done[word] = ~(uint64_t)0;
+	}
+	for( ; word < BITMAP_WORDS(checkpoint->traces); word++ ) {
+		if( readWord(file, &checkpoint->done[word]) != 0 ) {
+			goto done;
+		}
+	}
+	checkpoint->completed = (long)completed;
+	status = 0;
+
+done:
+	fclose(file);
+	return status;
+}
+
+/***********************************************************************************
+ * int checkpointSave( const Checkpoint *checkpoint, const char *path )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Writes a checkpoint to a checkpoint file. The checkpoint is first
+ *					written to a temporary file, which then replaces the previous
+ *					checkpoint, so a sweep killed while saving still leaves a
+ *					complete checkpoint behind.
+ *
+ * Parameters:
+ * 	checkpoint		I/P	const Checkpoint *	The checkpoint to save
+ * 	path			I/P	const char *		The path of the checkpoint file
+ * 	checkpointSave	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int checkpointSave( const Checkpoint *checkpoint, const char *path ) {
+	unsigned char header[8] = { 0, 0, 0, 0, CHECKPOINT_VERSION, 0, 0, 0 };
+	long policy, wss, word, next = 0;
+	size_t sourceBytes = strlen(checkpoint->source);
+	int status = 0;
+
+	// Open temporary file next to the checkpoint
+	char *temporary = malloc(strlen(path) + 5);
+	if( temporary == NULL ) {
+		return -1;
+	}
+	sprintf(temporary, "%s.tmp", path);
+	FILE *file = fopen(temporary, "wb");
+	if( file == NULL ) {
+		free(temporary);
+		return -1;
+	}
+
+	// Find the next trace, the first one not yet finished
+	while( next < checkpoint->traces && bitmapTest(checkpoint->done, next) ) {
+		next++;
+	}
+
+	// Write header and sweep parameters
+	memcpy(header, CHECKPOINT_MAGIC, 4);
+	status |= fwrite(header, sizeof(header), 1, file) != 1;
+	status |= writeWord(file, checkpoint->seed);
+	status |= writeWord(file, (uint64_t)checkpoint->length);
+	status |= writeWord(file, (uint64_t)checkpoint->traces);
+	status |= writeWord(file, (uint64_t)checkpoint->shard);
+	status |= writeWord(file, (uint64_t)checkpoint->shards);
+	status |= writeWord(file, sourceBytes);
+	status |= fwrite(checkpoint->source, 1, sourceBytes, file) != sourceBytes;
+
+	// Write accumulated faults
+	status |= writeWord(file, POLICY_COUNT);
+	status |= writeWord(file, SET_SIZE_UPPER);
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = 0; wss <= SET_SIZE_UPPER; wss++ ) {
+			status |= writeWord(file, (uint64_t)checkpoint->faults[policy][wss]);
+		}
+	}
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = 0; wss <= SET_SIZE_UPPER; wss++ ) {
+			status |= writeWord(file, (uint64_t)checkpoint->writebacks[policy][wss]);
+		}
+	}
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = 0; wss <= SET_SIZE_UPPER; wss++ ) {
+			status |= writeWord(file, (uint64_t)checkpoint->fills[policy][wss]);
+		}
+	}
+
+	// Write Belady counts
+	status |= writeWord(file, (uint64_t)checkpoint->checked);
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		status |= writeWord(file, (uint64_t)checkpoint->anomalousTraces[policy]);
+		status |= writeWord(file, (uint64_t)checkpoint->anomalousCells[policy]);
+	}
+
+	// Write finished traces
+	status |= writeWord(file, (uint64_t)checkpoint->completed);
+	status |= writeWord(file, (uint64_t)next);
+	for( word = next / BITMAP_BITS; word < BITMAP_WORDS(checkpoint->traces); word++ ) {
+		status |= writeWord(file, checkpoint->done[word]);
+	}
+
+	// Replace the previous checkpoint
+	status |= fclose(file) != 0;
+	if( status == 0 && rename(temporary, path) != 0 ) {
+		status = 1;
+	}
+	if( status != 0 ) {
+		remove(temporary);
+	}
+	free(temporary);
+	return status ? -1 : 0;
+}
+
+/***********************************************************************************
+ * void checkpointFree( Checkpoint *checkpoint )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Frees the memory of a checkpoint.
+ *
+ * Parameters:
+ * 	checkpoint	I/O	Checkpoint *	The checkpoint to free
+ ***********************************************************************************/
+void checkpointFree( Checkpoint *checkpoint ) {
+	free(checkpoint->source);
+	free(checkpoint->done);
+	checkpoint->source = NULL;
+	checkpoint->done = NULL;
+}
+
+/***********************************************************************************
+ * int writeWord( FILE *file, uint64_t value )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Writes a 64-bit integer in little-endian order.
+ *
+ * Parameters:
+ * 	file		I/O	FILE *		The file to write to
+ * 	value		I/P	uint64_t	The integer to write
+ * 	writeWord	O/P	int			0 on success, -1 on failure
+ ***********************************************************************************/
+static int writeWord( FILE *file, uint64_t value ) {
+	unsigned char bytes[8];
+	int i;
+	for( i = 0; i < 8; i++ ) {
+		bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+	return fwrite(bytes, sizeof(bytes), 1, file) == 1 ? 0 : -1;
+}
+
+/***********************************************************************************
+ * int readWord( FILE *file, uint64_t *value )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Reads a 64-bit integer stored in little-endian order.
+ *
+ * Parameters:
+ * 	file		I/O	FILE *		The file to read from
+ * 	value		O/P	uint64_t *	The integer read
+ * 	readWord	O/P	int			0 on success, -1 on failure
+ ***********************************************************************************/
+static int readWord( FILE *file, uint64_t *value ) {
+	unsigned char bytes[8];
+	int i;
+	if( fread(bytes, sizeof(bytes), 1, file) != 1 ) {
+		return -1;
+	}
+	*value = 0;
+	for( i = 0; i < 8; i++ ) {
+		*value |= (uint64_t)bytes[i] << (8 * i);
+	}
+	return 0;
+}
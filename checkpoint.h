@@ -0,0 +1,44 @@
+/***********************************************************************************
+ * File: checkpoint.h
+ * Author: Justin Hardy
+ * Description: Declarations for sweep checkpoints, which let a killed sweep be
+ *					resumed without rerunning finished traces. See checkpoint.c
+ *					for implementation and details of the on-disk layout.
+ ***********************************************************************************/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include "replaceAlgos.h"
+#include "pages.h"
+
+// Checkpoint constants
+#define CHECKPOINT_MAGIC	"VMCK"		// Magic bytes at the start of every checkpoint
+#define CHECKPOINT_VERSION	2			// Current version of the checkpoint format
+
+// Progress of a sweep. The parameters identify the sweep, so that a checkpoint
+// is never resumed by a sweep over different traces.
+typedef struct checkpoint {
+	uint64_t seed;				// Seed of generated traces
+	long length;				// Length of generated traces
+	long traces;				// Number of traces of the whole run
+	int shard;					// Shard of traces of the sweep
+	int shards;					// Number of shards of the run
+	char *source;				// Workload or trace file the traces come from
+	long completed;				// Number of finished traces
+	uint64_t *done;				// Bitmap of finished traces
+	long faults[POLICY_COUNT][SET_SIZE_UPPER+1];	// Accumulated faults of finished traces
+	long writebacks[POLICY_COUNT][SET_SIZE_UPPER+1];	// Accumulated evictions of dirty pages
+	long fills[POLICY_COUNT][SET_SIZE_UPPER+1];		// Accumulated fills of empty frames
+	long checked;				// Finished traces checked for Belady's anomaly
+	long anomalousTraces[POLICY_COUNT];	// Checked traces showing the anomaly per policy
+	long anomalousCells[POLICY_COUNT];	// Anomalous (trace, wss) pairs per policy
+} Checkpoint;
+
+int checkpointInit(Checkpoint*,uint64_t,long,long,int,int,const char*);	// Prepares an empty checkpoint
+int checkpointLoad(Checkpoint*,const char*);	// Resumes from a checkpoint file
+int checkpointSave(const Checkpoint*,const char*);	// Writes a checkpoint file
+void checkpointFree(Checkpoint*);				// Frees a checkpoint
+
+#endif
@@ -0,0 +1,356 @@
+/***********************************************************************************
+ * File: counterstack.c
+ * Author: Justin Hardy
+ * Procedures:
+ * counterStackParse	- Parses a counter stack specification.
+ * counterStackInit		- Prepares a counter stack with no references.
+ * counterStackAccess	- Records a reference in a counter stack.
+ * counterStackCurve	- Estimates the LRU faults of every wss of a range so far.
+ * counterStackFree		- Frees a counter stack.
+ * endStep				- Turns the counts of a step into estimated distances.
+ * estimate				- Estimates the distinct pages seen by a counter.
+ *
+ * Counter Stacks (Wires et al., OSDI '14) starts a new counter of distinct pages
+ * every step references. Counter i counts the pages referenced since it was
+ * started, so a reference that grows counter i + 1 but not the older counter
+ * i was last made between their starts, and its stack distance is about the
+ * value of counter i. Over a step, the growth of counter i + 1 minus that of
+ * counter i is thus the number of references at that distance, the growth of
+ * the oldest counter is the number of cold references, and the references
+ * that grow no counter at all were made within the step.
+ *
+ * The counters are HyperLogLog sketches, so no state is kept per page. Since
+ * an older counter has seen every page a younger one has, its registers are
+ * never smaller, and a reference updates counters from the youngest until one
+ * already holds its rank. Whenever a counter comes within the prune fraction
+ * of the next older one, it is dropped: the two would measure nearly the same
+ * distance. The stack then holds a number of counters logarithmic in the
+ * distinct pages, and its memory is sublinear in the stream.
+ *
+ * Distances are only resolved to about the pages referenced in a step, so the
+ * small wss of this program need a small step: with the default, the curve is
+ * meant for a glance at a long stream rather than for the wss 4 to 20.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "counterstack.h"
+
+// Weight of a register of a given rank in the sum of a counter, 2^-rank
+#define COUNTER_WEIGHT(rank)	(1.0 / (double)((uint64_t)1 << (rank)))
+
+static void endStep(CounterStack*);					// Estimates the distances of a step
+static double estimate(const CounterStack*,const Counter*);	// Estimates distinct pages of a counter
+
+/***********************************************************************************
+ * int counterStackParse( const char *spec, CounterStackConfig *config )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a counter stack specification of the form key=value,...
+ *					with keys step, prune, precision and every, any of which may
+ *					be omitted for its default. An empty specification takes
+ *					every default.
+ *
+ * Parameters:
+ * 	spec				I/P	const char *			The specification to be parsed
+ * 	config				O/P	CounterStackConfig *	The parameters
+ * 	counterStackParse	O/P	int						0 on success, -1 if spec is invalid
+ ***********************************************************************************/
+int counterStackParse( const char *spec, CounterStackConfig *config ) {
+	char buffer[256], *key, *value, *rest;
+
+	// Copy the specification so that it can be tokenized
+	if( strlen(spec) >= sizeof(buffer) ) {
+		return -1;
+	}
+	strcpy(buffer, spec);
+
+	// Parse key=value parameters
+	config->step = COUNTER_STACK_STEP;
+	config->prune = COUNTER_STACK_PRUNE;
+	config->precision = COUNTER_STACK_PRECISION;
+	config->every = COUNTER_STACK_EVERY;
+	for( key = strtok(buffer, ","); key != NULL; key = strtok(NULL, ",") ) {
+		value = strchr(key, '=');
+		if( value == NULL ) {
+			return -1;
+		}
+		*value++ = '\0';
+		if( strcmp(key, "step") == 0 ) {
+			config->step = strtol(value, &rest, 10);
+		}
+		else if( strcmp(key, "prune") == 0 ) {
+			config->prune = strtod(value, &rest);
+		}
+		else if( strcmp(key, "precision") == 0 ) {
+			config->precision = (int)strtol(value, &rest, 10);
+		}
+		else if( strcmp(key, "every") == 0 ) {
+			config->every = strtol(value, &rest, 10);
+		}
+		else {
+			rest = value;
+		}
+		if( rest == value || *rest != '\0' ) {
+			return -1;
+		}
+	}
+
+	// Validate parameters
+	if( config->step <= 0 || !(config->prune >= 0.0 && config->prune < 1.0) ||
+		config->precision < 4 || config->precision > 16 || config->every <= 0 ) {
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int counterStackInit( CounterStack *stack, const CounterStackConfig *config,
+ *						int upper )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prepares a counter stack with no references and no counters.
+ *
+ * Parameters:
+ * 	stack				O/P	CounterStack *				The stack to prepare
+ * 	config				I/P	const CounterStackConfig *	The parameters
+ * 	upper				I/P	int							The largest wss of curves
+ * 	counterStackInit	O/P	int							0 on success, -1 on failure
+ ***********************************************************************************/
+int counterStackInit( CounterStack *stack, const CounterStackConfig *config, int upper ) {
+	int registers = 1 << config->precision, zeros;
+
+	memset(stack, 0, sizeof(CounterStack));
+	stack->config = *config;
+	stack->upper = upper;
+	stack->depths = calloc(upper + 1, sizeof(double));
+	stack->linear = malloc(((1 << config->precision) + 1) * sizeof(double));
+	if( stack->depths == NULL || stack->linear == NULL ) {
+		counterStackFree(stack);
+		return -1;
+	}
+
+	// Tabulate linear counting, which small counters use on every step
+	for( zeros = 1; zeros <= registers; zeros++ ) {
+		stack->linear[zeros] = registers * log((double)registers / zeros);
+	}
+	stack->linear[0] = 0.0;
+	return 0;
+}
+
+/***********************************************************************************
+ * int counterStackAccess( CounterStack *stack, PageKey page )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Records a reference to a page, starting a new counter if a step
+ *					begins with it, and estimating the distances of the step if
+ *					it ends with it.
+ *
+ * Parameters:
+ * 	stack				I/O	CounterStack *	The stack
+ * 	page				I/P	PageKey			The page referenced
+ * 	counterStackAccess	O/P	int				0 on success, -1 if a counter could
+ *											not be allocated
+ ***********************************************************************************/
+int counterStackAccess( CounterStack *stack, PageKey page ) {
+	int precision = stack->config.precision, registers = 1 << precision, i;
+
+	// Start a counter with every step
+	if( stack->pending == 0 ) {
+		if( stack->count == stack->capacity ) {
+			int capacity = stack->capacity > 0 ? 2 * stack->capacity : 16;
+			Counter *counters = realloc(stack->counters, capacity * sizeof(Counter));
+			if( counters == NULL ) {
+				return -1;
+			}
+			stack->counters = counters;
+			stack->capacity = capacity;
+		}
+		Counter *counter = &stack->counters[stack->count];
+		if( stack->spare != NULL ) {
+			counter->registers = memset(stack->spare, 0, registers);
+			stack->spare = NULL;
+		}
+		else if( (counter->registers = calloc(registers, 1)) == NULL ) {
+			return -1;
+		}
+		counter->sum = registers;
+		counter->zeros = registers;
+		counter->previous = 0.0;
+		stack->deepest = stack->count++;
+	}
+
+	// Hash the page into a register and a rank, the position of the first one
+	// bit of the rest of the hash
+	uint64_t hash = page + 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+	hash ^= hash >> 31;
+	int reg = (int)(hash >> (64 - precision));
+	uint8_t rank = (uint8_t)(__builtin_clzll((hash << precision) | ((uint64_t)1 << (precision - 1))) + 1);
+
+	// Raise the register from the youngest counter until one already holds it
+	for( i = stack->count - 1; i >= 0 && stack->counters[i].registers[reg] < rank; i-- ) {
+		Counter *counter = &stack->counters[i];
+		counter->zeros -= counter->registers[reg] == 0;
+		counter->sum += COUNTER_WEIGHT(rank) - COUNTER_WEIGHT(counter->registers[reg]);
+		counter->registers[reg] = rank;
+	}
+	if( i + 1 < stack->deepest ) {
+		stack->deepest = i + 1;
+	}
+
+	// Estimate the distances of the step once it is over
+	stack->references++;
+	if( ++stack->pending == stack->config.step ) {
+		endStep(stack);
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * void counterStackCurve( CounterStack *stack, int lower, int upper,
+ *						long faults[] )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Estimates the page faults the LRU virtual memory replacement
+ *					algorithm would have counted on every reference so far, for
+ *					every wss from lower to upper. An unfinished step is ended
+ *					first.
+ *
+ * Parameters:
+ * 	stack	I/O	CounterStack *	The stack
+ * 	lower	I/P	int				The smallest working set size
+ * 	upper	I/P	int				The largest working set size, at most the stack's
+ * 	faults	O/P	long []			The estimated page faults, indexed by wss
+ ***********************************************************************************/
+void counterStackCurve( CounterStack *stack, int lower, int upper, long faults[] ) {
+	double misses = stack->misses, pages, faulted;
+	int wss, depth;
+
+	if( stack->pending > 0 ) {
+		endStep(stack);
+	}
+
+	// A wss misses every reference farther than it, except the misses that
+	// filled its frames
+	pages = stack->count > 0 ? stack->counters[0].previous : 0.0;
+	for( depth = stack->upper; depth > upper; depth-- ) {
+		misses += stack->depths[depth];
+	}
+	for( wss = upper; wss >= lower; wss-- ) {
+		faulted = misses - (pages < wss ? pages : wss);
+		faults[wss] = faulted > 0.0 ? (long)(faulted + 0.5) : 0;
+		misses += stack->depths[wss];
+	}
+}
+
+/***********************************************************************************
+ * void counterStackFree( CounterStack *stack )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Frees every counter of a counter stack.
+ *
+ * Parameters:
+ * 	stack	I/O	CounterStack *	The stack to free
+ ***********************************************************************************/
+void counterStackFree( CounterStack *stack ) {
+	int i;
+	for( i = 0; i < stack->count; i++ ) {
+		free(stack->counters[i].registers);
+	}
+	free(stack->counters);
+	free(stack->depths);
+	free(stack->spare);
+	free(stack->linear);
+	memset(stack, 0, sizeof(CounterStack));
+}
+
+/***********************************************************************************
+ * void endStep( CounterStack *stack )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Ends the current step: attributes its references to distances from
+ *					the growth of every counter over the step, then prunes the
+ *					counters that come within the prune fraction of the next
+ *					older one. Only the counters raised during the step can have
+ *					grown, and only they are estimated again or pruned.
+ *
+ * Parameters:
+ * 	stack	I/O	CounterStack *	The stack
+ ***********************************************************************************/
+static void endStep( CounterStack *stack ) {
+	Counter *counters = stack->counters;
+	double value, grown, olderGrown = 0.0, reused;
+	int i, kept, deepest = stack->deepest;
+
+	// Attribute the references that grew counter i + 1 but not counter i to the
+	// value of counter i, from the youngest counter down to the first that did
+	// not grow; references that grew no counter were made within the step, at
+	// most the youngest's value away
+	for( i = stack->count - 1; i >= 0 && i >= deepest - 1; i-- ) {
+		value = i >= deepest ? estimate(stack, &counters[i]) : counters[i].previous;
+		grown = value - counters[i].previous;
+		if( i == stack->count - 1 ) {
+			reused = stack->pending - grown;
+		}
+		else {
+			reused = olderGrown - grown;
+		}
+		if( value > stack->upper ) {
+			stack->misses += reused;
+		}
+		else {
+			stack->depths[value > 1.0 ? (int)ceil(value) : 1] += reused;
+		}
+		olderGrown = grown;
+		counters[i].previous = value;
+	}
+
+	// The growth of the oldest counter is cold references
+	if( deepest == 0 ) {
+		stack->misses += olderGrown;
+	}
+	stack->pending = 0;
+
+	// Drop every counter raised in the step that is now nearly as large as the
+	// next older one kept
+	for( i = kept = deepest > 1 ? deepest : 1; i < stack->count; i++ ) {
+		if( counters[i].previous >= (1.0 - stack->config.prune) * counters[kept - 1].previous ) {
+			if( stack->spare == NULL ) {
+				stack->spare = counters[i].registers;
+			}
+			else {
+				free(counters[i].registers);
+			}
+		}
+		else {
+			counters[kept++] = counters[i];
+		}
+	}
+	stack->count = stack->count > 0 ? kept : 0;
+}
+
+/***********************************************************************************
+ * double estimate( const CounterStack *stack, const Counter *counter )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Estimates the distinct pages seen by a counter with the HyperLogLog
+ *					estimator, switching to linear counting while the estimate is
+ *					small and some registers are still empty.
+ *
+ * Parameters:
+ * 	stack		I/P	const CounterStack *	The stack of the counter
+ * 	counter		I/P	const Counter *			The counter
+ * 	estimate	O/P	double					The estimated number of distinct pages
+ ***********************************************************************************/
+static double estimate( const CounterStack *stack, const Counter *counter ) {
+	double registers = (double)(1 << stack->config.precision);
+	double raw = 0.7213 / (1.0 + 1.079 / registers) * registers * registers / counter->sum;
+	if( raw <= 2.5 * registers && counter->zeros > 0 ) {
+		return stack->linear[counter->zeros];
+	}
+	return raw;
+}
@@ -0,0 +1,60 @@
+/***********************************************************************************
+ * File: counterstack.h
+ * Author: Justin Hardy
+ * Description: Declarations for Counter Stacks, which estimates the LRU miss ratio
+ *					curve of an unbounded stream of references from a stack of
+ *					HyperLogLog counters, without any state per page. See
+ *					counterstack.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef COUNTERSTACK_H
+#define COUNTERSTACK_H
+
+#include <stdint.h>
+#include "replaceAlgos.h"
+
+// Counter Stacks constants
+#define COUNTER_STACK_STEP		64			// Default references between two new counters
+#define COUNTER_STACK_PRUNE		0.02		// Default relative difference under which counters merge
+#define COUNTER_STACK_PRECISION	10			// Default log2 of the registers of each counter
+#define COUNTER_STACK_EVERY		1000000		// Default references between two emitted curves
+
+// Parameters of a counter stack
+typedef struct counterStackConfig {
+	long step;					// References between two new counters
+	double prune;				// A counter is pruned once within this fraction of the next older one
+	int precision;				// log2 of the registers of each counter, from 4 to 16
+	long every;					// References between two emitted curves
+} CounterStackConfig;
+
+// HyperLogLog counter of the distinct pages referenced since it was started
+typedef struct counter {
+	uint8_t *registers;			// Largest rank seen by each register
+	double sum;					// Sum of 2^-rank over every register
+	int zeros;					// Number of registers still 0
+	double previous;			// Estimate at the end of the previous step
+} Counter;
+
+// Counter stack state
+typedef struct counterStack {
+	CounterStackConfig config;	// Parameters
+	int upper;					// Largest distance tracked individually
+	Counter *counters;			// Counters, oldest first; the oldest counts every page
+	int count;					// Number of counters
+	int capacity;				// Number of counters allocated
+	int deepest;				// Oldest counter raised during the current step
+	uint8_t *spare;				// Registers of a pruned counter, reused by the next one
+	long pending;				// References of the current step so far
+	long references;			// References so far
+	double *depths;				// Estimated references at each distance up to upper
+	double *linear;				// Linear counting estimate for each number of empty registers
+	double misses;				// Estimated references farther than upper, or cold
+} CounterStack;
+
+int counterStackParse(const char*,CounterStackConfig*);			// Parses a specification
+int counterStackInit(CounterStack*,const CounterStackConfig*,int);	// Prepares an empty stack
+int counterStackAccess(CounterStack*,PageKey);					// Records a reference
+void counterStackCurve(CounterStack*,int,int,long[]);			// Estimates the LRU faults so far
+void counterStackFree(CounterStack*);							// Frees a stack
+
+#endif
@@ -0,0 +1,260 @@
+/***********************************************************************************
+ * File: dirty.c
+ * Author: Justin Hardy
+ * Procedures:
+ * lruDirty		- Performs LRU for one wss, counting dirty evictions.
+ * fifoDirty	- Performs FIFO for one wss, counting dirty evictions.
+ * clockDirty	- Performs Clock for one wss, counting dirty evictions.
+ * dirtyStart	- Allocates the frames of a dirty engine.
+ * dirtyFind	- Finds the frame holding a page.
+ *
+ * A dirty engine is the plain algorithm of its policy with one more bit per
+ * frame, set when the page held is written to and cleared when the frame is
+ * refilled. Evicting a frame whose bit is set costs a write-back on top of the
+ * read of the faulting page, so the faults of a wss split into clean faults,
+ * which only read, and dirty evictions, which also write. Victims are chosen
+ * exactly as by the plain algorithms, which never look at the access type, so
+ * the faults always equal theirs: filling an empty frame is not a fault, a
+ * Clock hit gives a second chance, and the Clock hand moves past its victim.
+ * The fills of empty frames still read their pages, so they are counted apart
+ * for the I/O of a wss.
+ ***********************************************************************************/
+
+#include <string.h>
+#include "dirty.h"
+
+// Frames of a dirty engine
+typedef struct dirtyFrames {
+	PageKey *set;				// Page held by each frame
+	uint64_t *dirty;			// Bit set if the page of a frame was written to
+	uint64_t *bits;				// Second chance bits of Clock; unused otherwise
+	long *used;					// Last reference to each frame, for LRU; unused otherwise
+	int size;					// Number of frames filled so far
+} DirtyFrames;
+
+static int dirtyStart(DirtyFrames*,int,Arena*);				// Allocates the frames
+static int dirtyFind(const DirtyFrames*,PageKey);			// Finds the frame of a page
+
+/***********************************************************************************
+ * long lruDirty( int wss, const PageKey data[], const uint64_t writes[],
+ *				long length, long *writebacks, long *fills, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the Least Recently Used algorithm for one wss, evicting
+ *					the frame whose last reference is the oldest, and counts the
+ *					evictions of dirty pages as well as the faults.
+ *
+ * Parameters:
+ * 	wss			I/P	int					The working set size to be utilized
+ * 	data		I/P	const PageKey []	The trace to perform the algorithm on
+ * 	writes		I/P	const uint64_t []	Bitmap of the references that are writes,
+ *										NULL if every reference is a read
+ * 	length		I/P	long				The number of references of the trace
+ * 	writebacks	O/P	long *				The evictions of dirty pages
+ * 	fills		O/P	long *				The fills of empty frames, which read a
+ *										page without faulting
+ * 	arena		I/O	Arena *				The arena to allocate the frames from
+ * 	lruDirty	O/P	long				The page faults, or -1 on failure
+ ***********************************************************************************/
+long lruDirty( int wss, const PageKey data[], const uint64_t writes[], long length, long *writebacks, long *fills, Arena *arena ) {
+	DirtyFrames frames;
+	long faults = 0, i;
+	int frame, f;
+
+	*writebacks = *fills = 0;
+	if( dirtyStart(&frames, wss, arena) != 0 ) {
+		return -1;
+	}
+	for( i = 0; i < length; i++ ) {
+		frame = dirtyFind(&frames, data[i]);
+		if( frame < 0 ) {
+			if( frames.size < wss ) {
+				// Fill an empty frame
+				frame = frames.size++;
+			}
+			else {
+				// Evict the least recently used frame, writing it back if dirty
+				for( frame = 0, f = 1; f < wss; f++ ) {
+					frame = frames.used[f] < frames.used[frame] ? f : frame;
+				}
+				*writebacks += bitmapTest(frames.dirty, frame);
+				faults++;
+			}
+			frames.set[frame] = data[i];
+			bitmapClear(frames.dirty, frame);
+		}
+		frames.used[frame] = i;
+		if( writes != NULL && bitmapTest(writes, i) ) {
+			bitmapSet(frames.dirty, frame);
+		}
+	}
+	*fills = frames.size;
+	return faults;
+}
+
+/***********************************************************************************
+ * long fifoDirty( int wss, const PageKey data[], const uint64_t writes[],
+ *				long length, long *writebacks, long *fills, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the First-In-First-Out algorithm for one wss, and counts
+ *					the evictions of dirty pages as well as the faults.
+ *
+ * Parameters:
+ * 	wss			I/P	int					The working set size to be utilized
+ * 	data		I/P	const PageKey []	The trace to perform the algorithm on
+ * 	writes		I/P	const uint64_t []	Bitmap of the references that are writes,
+ *										NULL if every reference is a read
+ * 	length		I/P	long				The number of references of the trace
+ * 	writebacks	O/P	long *				The evictions of dirty pages
+ * 	fills		O/P	long *				The fills of empty frames, which read a
+ *										page without faulting
+ * 	arena		I/O	Arena *				The arena to allocate the frames from
+ * 	fifoDirty	O/P	long				The page faults, or -1 on failure
+ ***********************************************************************************/
+long fifoDirty( int wss, const PageKey data[], const uint64_t writes[], long length, long *writebacks, long *fills, Arena *arena ) {
+	DirtyFrames frames;
+	long faults = 0, i;
+	int frame, hand = 0;
+
+	*writebacks = *fills = 0;
+	if( dirtyStart(&frames, wss, arena) != 0 ) {
+		return -1;
+	}
+	for( i = 0; i < length; i++ ) {
+		frame = dirtyFind(&frames, data[i]);
+		if( frame < 0 ) {
+			if( frames.size < wss ) {
+				// Fill an empty frame
+				frame = frames.size++;
+			}
+			else {
+				// Evict the oldest frame, writing it back if dirty
+				frame = hand;
+				hand = hand + 1 == wss ? 0 : hand + 1;
+				*writebacks += bitmapTest(frames.dirty, frame);
+				faults++;
+			}
+			frames.set[frame] = data[i];
+			bitmapClear(frames.dirty, frame);
+		}
+		if( writes != NULL && bitmapTest(writes, i) ) {
+			bitmapSet(frames.dirty, frame);
+		}
+	}
+	*fills = frames.size;
+	return faults;
+}
+
+/***********************************************************************************
+ * long clockDirty( int wss, const PageKey data[], const uint64_t writes[],
+ *				long length, long *writebacks, long *fills, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the Clock algorithm for one wss, and counts the evictions
+ *					of dirty pages as well as the faults. The dirty bit plays no
+ *					part in choosing a victim, so that the faults stay those of
+ *					Clock.
+ *
+ * Parameters:
+ * 	wss			I/P	int					The working set size to be utilized
+ * 	data		I/P	const PageKey []	The trace to perform the algorithm on
+ * 	writes		I/P	const uint64_t []	Bitmap of the references that are writes,
+ *										NULL if every reference is a read
+ * 	length		I/P	long				The number of references of the trace
+ * 	writebacks	O/P	long *				The evictions of dirty pages
+ * 	fills		O/P	long *				The fills of empty frames, which read a
+ *										page without faulting
+ * 	arena		I/O	Arena *				The arena to allocate the frames from
+ * 	clockDirty	O/P	long				The page faults, or -1 on failure
+ ***********************************************************************************/
+long clockDirty( int wss, const PageKey data[], const uint64_t writes[], long length, long *writebacks, long *fills, Arena *arena ) {
+	DirtyFrames frames;
+	long faults = 0, i;
+	int frame, hand = 0;
+
+	*writebacks = *fills = 0;
+	if( dirtyStart(&frames, wss, arena) != 0 ) {
+		return -1;
+	}
+	for( i = 0; i < length; i++ ) {
+		frame = dirtyFind(&frames, data[i]);
+		if( frame >= 0 ) {
+			// Give the page a second chance
+			bitmapSet(frames.bits, frame);
+		}
+		else {
+			if( frames.size < wss ) {
+				// Fill an empty frame
+				frame = frames.size++;
+			}
+			else {
+				// Sweep the hand past every frame with a second chance, taking it away
+				while( bitmapTest(frames.bits, hand) ) {
+					bitmapClear(frames.bits, hand);
+					hand = hand + 1 == wss ? 0 : hand + 1;
+				}
+
+				// Evict the frame under the hand, writing it back if dirty
+				frame = hand;
+				hand = hand + 1 == wss ? 0 : hand + 1;
+				*writebacks += bitmapTest(frames.dirty, frame);
+				faults++;
+			}
+			frames.set[frame] = data[i];
+			bitmapClear(frames.dirty, frame);
+		}
+		if( writes != NULL && bitmapTest(writes, i) ) {
+			bitmapSet(frames.dirty, frame);
+		}
+	}
+	*fills = frames.size;
+	return faults;
+}
+
+/***********************************************************************************
+ * int dirtyStart( DirtyFrames *frames, int wss, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Allocates empty frames of a dirty engine from an arena.
+ *
+ * Parameters:
+ * 	frames		O/P	DirtyFrames *	The frames to allocate
+ * 	wss			I/P	int				The working set size
+ * 	arena		I/O	Arena *			The arena to allocate the frames from
+ * 	dirtyStart	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+static int dirtyStart( DirtyFrames *frames, int wss, Arena *arena ) {
+	frames->set = arenaAlloc(arena, wss * sizeof(PageKey));
+	frames->dirty = arenaAlloc(arena, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	frames->bits = arenaAlloc(arena, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	frames->used = arenaAlloc(arena, wss * sizeof(long));
+	if( frames->set == NULL || frames->dirty == NULL || frames->bits == NULL || frames->used == NULL ) {
+		return -1;
+	}
+	memset(frames->dirty, 0, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	memset(frames->bits, 0, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	frames->size = 0;
+	return 0;
+}
+
+/***********************************************************************************
+ * int dirtyFind( const DirtyFrames *frames, PageKey page )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Finds the frame holding a page among the frames filled so far.
+ *
+ * Parameters:
+ * 	frames		I/P	const DirtyFrames *	The frames to search
+ * 	page		I/P	PageKey				The page to find
+ * 	dirtyFind	O/P	int					The frame of the page, or -1 if none
+ ***********************************************************************************/
+static int dirtyFind( const DirtyFrames *frames, PageKey page ) {
+	int frame;
+	for( frame = 0; frame < frames->size; frame++ ) {
+		if( frames->set[frame] == page ) {
+			return frame;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,19 @@
+/***********************************************************************************
+ * File: dirty.h
+ * Author: Justin Hardy
+ * Description: Declarations for the dirty engines, which simulate a replacement
+ *					algorithm on a trace that tells writes from reads, counting
+ *					the evictions of modified pages that must be written back.
+ *					See dirty.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef DIRTY_H
+#define DIRTY_H
+
+#include "replaceAlgos.h"
+
+long lruDirty(int,const PageKey[],const uint64_t[],long,long*,long*,Arena*);		// Performs LRU with write-back
+long fifoDirty(int,const PageKey[],const uint64_t[],long,long*,long*,Arena*);		// Performs FIFO with write-back
+long clockDirty(int,const PageKey[],const uint64_t[],long,long*,long*,Arena*);	// Performs Clock with write-back
+
+#endif
@@ -0,0 +1,186 @@
+/***********************************************************************************
+ * File: kernels.c
+ * Author: Justin Hardy
+ * Procedures:
+ * policySimulate	- Runs a policy for a wss, with its specialized kernel if any.
+ * lru<N>			- Performs LRU with a fixed wss of N.
+ * fifo<N>			- Performs FIFO with a fixed wss of N.
+ * clock<N>			- Performs Clock with a fixed wss of N.
+ *
+ * Every wss from KERNEL_WSS_LOWER to KERNEL_WSS_UPPER gets its own copy of each
+ * algorithm, generated by the DEFINE_*_KERNEL macros. With the wss a constant,
+ * the frame array is a fixed-size local the compiler keeps in registers, the
+ * search over it is fully unrolled into branchless compares, and every wrap of
+ * the hand compares against a constant. Each kernel first fills its frames,
+ * then runs a steady state loop in which every frame is valid, so neither loop
+ * consults a validity bitmap.
+ *
+ * The kernels count exactly the faults of the generic algorithms in
+ * replaceAlgos.c. LRU keeps the time of each frame's last use and evicts the
+ * oldest, which picks the same page as the generic backward scan.
+ ***********************************************************************************/
+
+#include "kernels.h"
+
+// Applies a macro to every wss with specialized kernels
+#define KERNEL_SIZES(X) \
+	X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) \
+	X(13) X(14) X(15) X(16) X(17) X(18) X(19) X(20)
+
+// Finds the frame holding a page among the first n frames, -1 if none
+#define KERNEL_FIND(set, n, page, where) \
+	do { \
+		int k_; \
+		(where) = -1; \
+		for( k_ = 0; k_ < (n); k_++ ) { \
+			(where) = (set)[k_] == (page) ? k_ : (where); \
+		} \
+	} while( 0 )
+
+// Defines lru<N>
+#define DEFINE_LRU_KERNEL(N) \
+	static long lru##N( const PageKey data[], long length ) { \
+		PageKey set[N]; \
+		long lastUse[N]; \
+		long faults = 0, i = 0; \
+		int size = 0, where, k, oldest; \
+		\
+		/* Fill frames */ \
+		for( ; i < length && size < N; i++ ) { \
+			KERNEL_FIND(set, size, data[i], where); \
+			if( where < 0 ) { \
+				where = size++; \
+				set[where] = data[i]; \
+			} \
+			lastUse[where] = i; \
+		} \
+		\
+		/* Replace the least recently used page on every fault */ \
+		for( ; i < length; i++ ) { \
+			KERNEL_FIND(set, N, data[i], where); \
+			if( where < 0 ) { \
+				oldest = 0; \
+				for( k = 1; k < N; k++ ) { \
+					oldest = lastUse[k] < lastUse[oldest] ? k : oldest; \
+				} \
+				where = oldest; \
+				set[where] = data[i]; \
+				faults++; \
+			} \
+			lastUse[where] = i; \
+		} \
+		return faults; \
+	}
+
+// Defines fifo<N>
+#define DEFINE_FIFO_KERNEL(N) \
+	static long fifo##N( const PageKey data[], long length ) { \
+		PageKey set[N]; \
+		long faults = 0, i = 0; \
+		int size = 0, hand = 0, where; \
+		\
+		/* Fill frames */ \
+		for( ; i < length && size < N; i++ ) { \
+			KERNEL_FIND(set, size, data[i], where); \
+			if( where < 0 ) { \
+				set[size++] = data[i]; \
+			} \
+		} \
+		\
+		/* Replace the oldest page on every fault */ \
+		for( ; i < length; i++ ) { \
+			KERNEL_FIND(set, N, data[i], where); \
+			if( where < 0 ) { \
+				set[hand] = data[i]; \
+				hand = hand == N - 1 ? 0 : hand + 1; \
+				faults++; \
+			} \
+		} \
+		return faults; \
+	}
+
+// Defines clock<N>; second chance bits are the low N bits of one word
+#define DEFINE_CLOCK_KERNEL(N) \
+	static long clock##N( const PageKey data[], long length ) { \
+		const uint32_t frames = (uint32_t)(((uint64_t)1 << N) - 1); \
+		PageKey set[N]; \
+		uint32_t secondChance = 0; \
+		long faults = 0, i = 0; \
+		int size = 0, hand = 0, where, victim; \
+		\
+		/* Fill frames */ \
+		for( ; i < length && size < N; i++ ) { \
+			KERNEL_FIND(set, size, data[i], where); \
+			if( where < 0 ) { \
+				set[size++] = data[i]; \
+			} \
+			else { \
+				secondChance |= (uint32_t)1 << where; \
+			} \
+		} \
+		\
+		/* Replace the first page from the hand without a second chance */ \
+		for( ; i < length; i++ ) { \
+			KERNEL_FIND(set, N, data[i], where); \
+			if( where >= 0 ) { \
+				secondChance |= (uint32_t)1 << where; \
+				continue; \
+			} \
+			uint32_t fromHand = frames & (frames << hand); \
+			uint32_t candidates = fromHand & ~secondChance; \
+			if( candidates != 0 ) { \
+				victim = __builtin_ctz(candidates); \
+				secondChance &= ~(fromHand & (((uint32_t)1 << victim) - 1)); \
+			} \
+			else { \
+				secondChance &= ~fromHand; \
+				victim = __builtin_ctz(frames & ~secondChance); \
+				secondChance &= ~(((uint32_t)1 << victim) - 1); \
+			} \
+			set[victim] = data[i]; \
+			hand = victim == N - 1 ? 0 : victim + 1; \
+			faults++; \
+		} \
+		return faults; \
+	}
+
+// Generate every kernel
+KERNEL_SIZES(DEFINE_LRU_KERNEL)
+KERNEL_SIZES(DEFINE_FIFO_KERNEL)
+KERNEL_SIZES(DEFINE_CLOCK_KERNEL)
+
+// Dispatch tables
+#define LRU_ENTRY(N)	[N] = lru##N,
+#define FIFO_ENTRY(N)	[N] = fifo##N,
+#define CLOCK_ENTRY(N)	[N] = clock##N,
+const PolicyKernel lruKernels[KERNEL_WSS_UPPER+1] = { KERNEL_SIZES(LRU_ENTRY) };
+const PolicyKernel fifoKernels[KERNEL_WSS_UPPER+1] = { KERNEL_SIZES(FIFO_ENTRY) };
+const PolicyKernel clockKernels[KERNEL_WSS_UPPER+1] = { KERNEL_SIZES(CLOCK_ENTRY) };
+
+/***********************************************************************************
+ * long policySimulate( const Policy *policy, int wss, const PageKey data[],
+ *						long length, const EngineConfig *settings, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs a replacement algorithm for a wss on a trace, dispatching to
+ *					its kernel specialized for that wss if it has one and the
+ *					engine settings enable kernels, or else to the generic
+ *					algorithm.
+ *
+ * Parameters:
+ * 	policy			I/P	const Policy *		The algorithm to run
+ * 	wss				I/P	int					The working set size
+ * 	data			I/P	const PageKey []	The trace
+ * 	length			I/P	long				The number of references in the trace
+ * 	settings		I/P	const EngineConfig *	The engine settings
+ * 	arena			I/O	Arena *				The arena for the generic algorithm
+ * 	policySimulate	O/P	long				The number of page faults, -1 on failure
+ ***********************************************************************************/
+long policySimulate( const Policy *policy, int wss, const PageKey data[], long length,
+					 const EngineConfig *settings, Arena *arena ) {
+	if( settings->kernels && policy->kernels != NULL && wss >= KERNEL_WSS_LOWER && wss <= KERNEL_WSS_UPPER &&
+		policy->kernels[wss] != NULL ) {
+		return policy->kernels[wss](data, length);
+	}
+	return policy->run(wss, data, length, arena);
+}
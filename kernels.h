@@ -0,0 +1,25 @@
+/***********************************************************************************
+ * File: kernels.h
+ * Author: Justin Hardy
+ * Description: Declarations for the replacement algorithms specialized for fixed
+ *					working set sizes. See kernels.c for implementation and
+ *					details.
+ ***********************************************************************************/
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "replaceAlgos.h"
+
+// Kernel constants
+#define KERNEL_WSS_LOWER	4		// The smallest wss with specialized kernels
+#define KERNEL_WSS_UPPER	20		// The largest wss with specialized kernels (at most 32)
+
+// Specialized kernels of each algorithm, indexed by wss; NULL where there is none
+extern const PolicyKernel lruKernels[KERNEL_WSS_UPPER+1];
+extern const PolicyKernel fifoKernels[KERNEL_WSS_UPPER+1];
+extern const PolicyKernel clockKernels[KERNEL_WSS_UPPER+1];
+
+long policySimulate(const Policy*,int,const PageKey[],long,const EngineConfig*,Arena*);	// Runs a policy for a wss
+
+#endif
@@ -0,0 +1,69 @@
+/***********************************************************************************
+ * File: pages.c
+ * Author: Justin Hardy
+ * Procedures:
+ * parsePageSize	- Parses a page size given on the command line.
+ * addressesToPages	- Converts raw byte addresses to page numbers.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include "pages.h"
+
+/***********************************************************************************
+ * int parsePageSize( const char *text, int *shift )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a page size such as "4K", "2M" or "1G" (or a plain number
+ *					of bytes) into the base 2 logarithm of the page size. The
+ *					page size must be a power of two of at least one byte.
+ *
+ * Parameters:
+ * 	text			I/P	const char *	The page size to be parsed
+ * 	shift			O/P	int *			log2 of the page size in bytes
+ * 	parsePageSize	O/P	int				0 on success, -1 if text is invalid
+ ***********************************************************************************/
+int parsePageSize( const char *text, int *shift ) {
+	// Parse number
+	char *end;
+	unsigned long long bytes = strtoull(text, &end, 10);
+	if( end == text ) {
+		return -1;
+	}
+
+	// Apply unit suffix, if any
+	switch( *end ) {
+		case 'k': case 'K':	bytes <<= 10; end++; break;
+		case 'm': case 'M':	bytes <<= 20; end++; break;
+		case 'g': case 'G':	bytes <<= 30; end++; break;
+	}
+	if( *end != '\0' || bytes == 0 || (bytes & (bytes - 1)) != 0 ) {
+		return -1;
+	}
+
+	// Compute shift of the power of two
+	for( *shift = 0; bytes > 1; bytes >>= 1 ) {
+		(*shift)++;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * void addressesToPages( PageKey pages[], long length, int shift )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Converts a trace of raw byte addresses to page numbers in place,
+ *					by dropping the offset bits of a page of 2^shift bytes. This
+ *					is the ingestion stage for traces of virtual addresses, and
+ *					lets the same trace be simulated with 4K, 2M or 1G pages.
+ *
+ * Parameters:
+ * 	pages	I/O	PageKey []	The addresses to be converted to pages
+ * 	length	I/P	long		The number of addresses
+ * 	shift	I/P	int			log2 of the page size in bytes
+ ***********************************************************************************/
+void addressesToPages( PageKey pages[], long length, int shift ) {
+	long i;
+	for( i = 0; i < length; i++ ) {
+		pages[i] >>= shift;
+	}
+}
@@ -0,0 +1,81 @@
+/***********************************************************************************
+ * File: pages.h
+ * Author: Justin Hardy
+ * Description: Declarations for page identifiers, frame validity bitmaps and the
+ *					address-to-page ingestion stage. See pages.c for
+ *					implementation and details.
+ ***********************************************************************************/
+
+#ifndef PAGES_H
+#define PAGES_H
+
+#include <stdint.h>
+
+// Page constants
+#define PAGE_SHIFT_4K		12		// log2 of a 4 KiB page
+#define PAGE_SHIFT_2M		21		// log2 of a 2 MiB huge page
+#define PAGE_SHIFT_1G		30		// log2 of a 1 GiB huge page
+#define BITMAP_BITS			64		// Number of bits in one bitmap word
+#define PAGE_SOURCE_BLOCK	4096	// References a consumer of a source pulls at once
+
+// Number of bitmap words needed to hold a given number of bits
+#define BITMAP_WORDS(bits)	(((bits) + BITMAP_BITS - 1) / BITMAP_BITS)
+
+// Page identifier. Every 64-bit value is a valid page; whether a frame holds a
+// page at all is tracked separately in a validity bitmap.
+typedef uint64_t PageKey;
+
+// References produced on demand instead of held in a trace. fill stores the
+// references at positions start to start + count - 1 in block, and may be
+// called by any number of threads at once.
+typedef struct pageSource {
+	void (*fill)(const struct pageSource*,long,PageKey[],long);	// Produces references
+} PageSource;
+
+int parsePageSize(const char*,int*);			// Parses a page size such as "2M"
+void addressesToPages(PageKey[],long,int);		// Converts byte addresses to pages
+
+/***********************************************************************************
+ * int bitmapTest( const uint64_t bitmap[], long bit )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Determines if a given bit of a bitmap is set.
+ *
+ * Parameters:
+ * 	bitmap		I/P	const uint64_t []	The bitmap to be tested
+ * 	bit			I/P	long				The index of the bit
+ * 	bitmapTest	O/P	int					1 if the bit is set, 0 if not
+ ***********************************************************************************/
+static inline int bitmapTest( const uint64_t bitmap[], long bit ) {
+	return (bitmap[bit / BITMAP_BITS] >> (bit % BITMAP_BITS)) & 1;
+}
+
+/***********************************************************************************
+ * void bitmapSet( uint64_t bitmap[], long bit )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Sets a given bit of a bitmap.
+ *
+ * Parameters:
+ * 	bitmap	I/O	uint64_t []	The bitmap to be updated
+ * 	bit		I/P	long		The index of the bit
+ ***********************************************************************************/
+static inline void bitmapSet( uint64_t bitmap[], long bit ) {
+	bitmap[bit / BITMAP_BITS] |= (uint64_t)1 << (bit % BITMAP_BITS);
+}
+
+/***********************************************************************************
+ * void bitmapClear( uint64_t bitmap[], long bit )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Clears a given bit of a bitmap.
+ *
+ * Parameters:
+ * 	bitmap	I/O	uint64_t []	The bitmap to be updated
+ * 	bit		I/P	long		The index of the bit
+ ***********************************************************************************/
+static inline void bitmapClear( uint64_t bitmap[], long bit ) {
+	bitmap[bit / BITMAP_BITS] &= ~((uint64_t)1 << (bit % BITMAP_BITS));
+}
+
+#endif
@@ -0,0 +1,140 @@
+/***********************************************************************************
+ * File: progress.c
+ * Author: Justin Hardy
+ * Procedures:
+ * progressInit		- Prepares a progress reporter for a given amount of work.
+ * progressAdvance	- Records completed work, and prints a report if enough
+ *						time has passed since the previous one.
+ * progressFinish	- Prints the final report of a progress reporter.
+ * progressNow		- Gets the current monotonic time in nanoseconds.
+ * progressReport	- Prints a single progress report to stderr.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+#include "progress.h"
+
+static long long progressNow(void);						// Gets the monotonic time
+static void progressReport(Progress*,unsigned long,long long,int);	// Prints a report
+
+/***********************************************************************************
+ * void progressInit( Progress *progress, const char *label, unsigned long total,
+ *						int quiet )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prepares a progress reporter for a given amount of work. Nothing
+ *					is printed until work is recorded through progressAdvance.
+ *
+ * Parameters:
+ * 	progress	I/O	Progress *		The progress reporter to prepare
+ * 	label		I/P	const char *	The label printed in front of each report
+ * 	total		I/P	unsigned long	The total units of work expected
+ * 	quiet		I/P	int				Non-zero if nothing should be printed
+ ***********************************************************************************/
+void progressInit( Progress *progress, const char *label, unsigned long total, int quiet ) {
+	// Record the amount of work and the start time
+	progress->label = label;
+	progress->total = total;
+	progress->quiet = quiet;
+	progress->terminal = isatty(STDERR_FILENO);
+	progress->start = progressNow();
+
+	// Reset counters; the first report is due one interval from now
+	atomic_init(&progress->completed, 0);
+	atomic_init(&progress->nextReport, progress->start + PROGRESS_INTERVAL_MS * 1000000LL);
+}
+
+/***********************************************************************************
+ * void progressAdvance( Progress *progress, unsigned long units )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Records a number of completed units of work. If the report
+ *					interval has elapsed, exactly one of the calling threads
+ *					claims the report and prints it; every other thread returns
+ *					immediately, so that reporting never serializes the workers.
+ *
+ * Parameters:
+ * 	progress	I/O	Progress *		The progress reporter to update
+ * 	units		I/P	unsigned long	The units of work just completed
+ ***********************************************************************************/
+void progressAdvance( Progress *progress, unsigned long units ) {
+	// Count the completed work
+	unsigned long completed = atomic_fetch_add_explicit(&progress->completed, units, memory_order_relaxed) + units;
+
+	// Nothing else to do in quiet mode
+	if( progress->quiet ) {
+		return;
+	}
+
+	// Check if a report is due
+	long long now = progressNow();
+	long long due = atomic_load_explicit(&progress->nextReport, memory_order_relaxed);
+	if( now < due ) {
+		return;
+	}
+
+	// Claim the report; only the thread that wins the exchange prints it
+	if( atomic_compare_exchange_strong(&progress->nextReport, &due, now + PROGRESS_INTERVAL_MS * 1000000LL) ) {
+		progressReport(progress, completed, now, 0);
+	}
+}
+
+/***********************************************************************************
+ * void progressFinish( Progress *progress )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prints the final report of a progress reporter, unless it is quiet.
+ *					Must only be called once all workers have stopped advancing it.
+ *
+ * Parameters:
+ * 	progress	I/O	Progress *	The progress reporter to finish
+ ***********************************************************************************/
+void progressFinish( Progress *progress ) {
+	if( !progress->quiet ) {
+		progressReport(progress, atomic_load(&progress->completed), progressNow(), 1);
+	}
+}
+
+/***********************************************************************************
+ * long long progressNow( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Gets the current time of the monotonic clock in nanoseconds.
+ *
+ * Parameters:
+ * 	progressNow	O/P	long long	The current monotonic time in nanoseconds
+ ***********************************************************************************/
+static long long progressNow( void ) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/***********************************************************************************
+ * void progressReport( Progress *progress, unsigned long completed, long long now,
+ *						int last )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prints a single progress report to stderr, containing the amount
+ *					of completed work, the throughput and the estimated time
+ *					remaining. On a terminal, reports overwrite each other.
+ *
+ * Parameters:
+ * 	progress	I/P	Progress *		The progress reporter to print
+ * 	completed	I/P	unsigned long	The units of work completed so far
+ * 	now			I/P	long long		The current monotonic time (ns)
+ * 	last		I/P	int				Non-zero if this is the final report
+ ***********************************************************************************/
+static void progressReport( Progress *progress, unsigned long completed, long long now, int last ) {
+	// Compute throughput and estimated time remaining
+	double elapsed = (now - progress->start) / 1e9;
+	double rate = elapsed > 0.0 ? completed / elapsed : 0.0;
+	double eta = rate > 0.0 && completed < progress->total ? (progress->total - completed) / rate : 0.0;
+
+	// Print report; on a terminal the line is rewritten in place
+	fprintf(stderr, "%s%s (%lu/%lu) %.1f/s, ETA %.1fs%s",
+		progress->terminal ? "\r" : "", progress->label, completed, progress->total,
+		rate, eta, (!progress->terminal || last) ? "\n" : "");
+	fflush(stderr);
+}
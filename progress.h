@@ -0,0 +1,32 @@
+/***********************************************************************************
+ * File: progress.h
+ * Author: Justin Hardy
+ * Description: Declarations for the throttled progress reporter used by the
+ *					simulation. See progress.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <stdatomic.h>
+
+// Progress constants
+#define PROGRESS_INTERVAL_MS	250		// Minimum time between two progress reports
+
+// Progress reporter state. Counters are atomic so that any number of worker
+// threads may report completed work at the same time.
+typedef struct progress {
+	atomic_ulong completed;		// Units of work completed so far
+	atomic_llong nextReport;	// Monotonic time (ns) at which the next report is due
+	unsigned long total;		// Total units of work expected
+	long long start;			// Monotonic time (ns) at which the work began
+	const char *label;			// Label printed in front of each report
+	int quiet;					// Non-zero if nothing should be printed
+	int terminal;				// Non-zero if stderr is a terminal
+} Progress;
+
+void progressInit(Progress*,const char*,unsigned long,int);	// Prepares a progress reporter
+void progressAdvance(Progress*,unsigned long);				// Records completed work
+void progressFinish(Progress*);								// Prints the final report
+
+#endif
@@ -11,11 +11,17 @@
  *						a given data set.
  * Clock			- Performs the Clock replacement algorithm on a given data
  *						set.
- * normal			- Generates a random number off of a normal distribution
- *						with a specified mean and standard deviation.
  * arrayContains	- Determines if the given array contains a given value.
  * getIndex			- Determines the index at which a given array contains a
  *						given value, or if an index does not exist for it.
+ * runSweep			- Simulates every algorithm and wss on a shard of traces.
+ * runStream		- Streams a trace file through Counter Stacks, emitting curves.
+ * runDirectory		- Simulates every algorithm and wss on many trace files at once.
+ * compareFiles		- Orders trace files by decreasing size.
+ * readTrace		- Copies the next trace of a trace pipe into a shared trace.
+ * checkpointSource	- Describes the traces and options a checkpoint depends on.
+ * writeDirty		- Writes the clean reads, dirty evictions and I/O of a cell.
+ * usage			- Prints the command line usage of the program.
  ***********************************************************************************/
 
 #include <stdio.h>
@@ -24,27 +30,113 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/utsname.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <errno.h>
 #include <math.h>
 #include <time.h>
 #include <limits.h>
-
-// Simulation constants
-#define TRACES		1000		// The number of traces to be performed
-#define SET_SIZE_LOWER	4		// The lower bound of the set sizes to test
-#define SET_SIZE_UPPER	20		// The upper bound of the set sizes to test
+#include <getopt.h>
+#include <glob.h>
+#include "replaceAlgos.h"
+#include "progress.h"
+#include "pages.h"
+#include "trace.h"
+#include "tracefile.h"
+#include "tracepipe.h"
+#include "workload.h"
+#include "sweep.h"
+#include "checkpoint.h"
+#include "resultcache.h"
+#include "kernels.h"
+#include "batch.h"
+#include "dirty.h"
+#include "belady.h"
+#include "stackdist.h"
+#include "shards.h"
+#include "counterstack.h"
 
 // Program functions - see below main for implementation and details!
 // 	I'd like to note that I do it this way out of personal preference;
 // 	I like main to be the first full function you see in the program.
 // 	This isn't neccessary, since they're all default return type, but
 // 	I'll include it since it's  generally good programming practice.
-int LRU(int,int[]);					// Performs LRU Algorithm
-int FIFO(int,int[]);				// Performs FIFO Algorithm
-int Clock(int,int[]);				// Performs Clock Algorithm
-int normal(int,int);				// Generates random number under normal distribution
-int arrayContains(int[],int,int);	// Gets if an element is contained in an array
-int getIndex(int[],int,int);		// Gets the index of an element in an array
+// 	The replacement algorithms themselves are declared in replaceAlgos.h.
+void usage(const char*);			// Prints command line usage
+
+// Command line options
+typedef struct options {
+	int traces;					// Number of traces to simulate
+	int threads;				// Number of worker threads per process
+	int processes;				// Number of worker processes
+	int quiet;					// Non-zero to suppress progress reports
+	int compress;				// Non-zero to compress written trace files
+	int addresses;				// Non-zero to write byte addresses instead of pages
+	int hugePages;				// Non-zero to back traces with huge pages
+	int resume;					// Non-zero to resume from the checkpoint file
+	int pageShift;				// log2 of the page size of address traces
+	int format;					// Format of text trace files
+	long length;				// Number of references per generated trace
+	uint64_t seed;				// Seed of generated traces
+	const char *traceFile;		// Trace file to replay, if any
+	const char *traceDir;		// Directory or glob pattern of trace files to replay, if any
+	const char *writeFile;		// Trace file to save traces to, if any
+	const char *checkpointFile;	// Checkpoint file to save progress to, if any
+	const char *cacheFile;		// Result cache file, if any
+	const char *beladyDir;		// Directory to save traces showing Belady's anomaly to, if any
+	int stream;					// Non-zero to stream the trace file through Counter Stacks
+	int lazy;					// Non-zero to pull generated references on demand
+	EngineConfig engine;		// Settings of the engines simulating the policies
+	double writes;				// Fraction of generated references that are writes
+	int dirty;					// Non-zero to count the evictions of dirty pages
+	CounterStackConfig counterStack;	// Parameters of Counter Stacks
+	const char *workloadSpec;	// Workload of generated traces
+	Workload *workload;			// Parsed workload of generated traces
+} Options;
+
+// Results of a shard of traces
+typedef struct shardResults {
+	long faults[POLICY_COUNT][SET_SIZE_UPPER+1];	// Accumulated faults
+	long writebacks[POLICY_COUNT][SET_SIZE_UPPER+1];	// Accumulated evictions of dirty pages
+	long fills[POLICY_COUNT][SET_SIZE_UPPER+1];		// Accumulated fills of empty frames
+	long reused;				// Cells whose results came from the result cache
+	long simulated;				// Cells simulated
+	long checked;				// Traces checked for Belady's anomaly
+	long anomalousTraces[POLICY_COUNT];	// Traces showing Belady's anomaly under each policy
+	long anomalousCells[POLICY_COUNT];	// (trace, wss) pairs faulting less than at wss + 1
+} ShardResults;
+
+// Memory shared with worker processes
+typedef struct shared {
+	Progress progress;			// Progress of the whole run
+	ShardResults shards[];		// Results of each process
+} Shared;
+
+// A trace file of a directory run
+typedef struct traceDirFile {
+	const char *path;			// Path of the file
+	long size;					// Size of the file, in bytes
+	long traces;				// Number of traces in the file
+	long first;					// Number of its first trace within the sweep
+} TraceDirFile;
+
+int runSweep(const Options*,int,int,Progress*,ShardResults*);	// Simulates a shard of traces
+int runStream(const Options*);		// Streams a trace file through Counter Stacks
+int runDirectory(const Options*);	// Simulates many trace files at once
+int compareFiles(const void*,const void*);			// Orders trace files by decreasing size
+Trace *readTrace(TracePipe*,long,long,int);		// Copies the next trace of a trace pipe
+char *checkpointSource(const Options*,const char*);	// Describes what a checkpoint depends on
+void writeDirty(FILE*,long,long,long,long,int);		// Writes the write-back columns of a cell
+
+// The trace files compareFiles orders
+static const TraceDirFile *sortFiles;
+
+// The replacement algorithms, in results column order
+const Policy policies[POLICY_COUNT] = {
+	{ "LRU",	1,	LRU,	lruKernels,		lruBatch,	shardsLru,	lruLazy,	lruDirty },
+	{ "FIFO",	1,	FIFO,	fifoKernels,	fifoBatch,	NULL,		fifoLazy,	fifoDirty },
+	{ "Clock",	1,	Clock,	clockKernels,	clockBatch,	NULL,		clockLazy,	clockDirty }
+};
 
 /***********************************************************************************
  * int main( int argc, char* argv[] )
@@ -56,53 +148,475 @@ int getIndex(int[],int,int);		// Gets the index of an element in an array
  *					10 regions. The algorithms are testing on varying working
  *					set sizes from 4 to 20 (by default) and computes the
  *					average of those 1000 experiements on those set sizes.
+ *					Every (trace, wss, algorithm) simulation runs as its own
+ *					task on a pool of work-stealing worker threads. When a
+ *					process has too few traces to keep its threads busy, the
+ *					exact LRU distances of each trace are counted in chunks, and
+ *					FIFO and Clock are simulated in speculative segments, on the
+ *					idle threads, shared by the three algorithms so that no more
+ *					than --threads run at once. When traces tell writes from
+ *					reads, either drawn with --writes or recorded by a trace
+ *					file, the pages written to are tracked per frame, and the
+ *					page reads that write nothing back, fills of empty frames
+ *					included, the evictions of dirty pages and the bytes read
+ *					and written back are also reported for every algorithm. See
+ *					Options for the rest.
  *
  * Parameters:
  * 	argc	I/P	int			The number of arguments on the command line
  * 	argv	I/P	char *[]	The arguments on the command line
  * 	main	O/P	int			Status code (see in-line comments)
+ *
+ * Options:
+ * 	--quiet				I/P	-		Reports no progress, instead of at most every
+ *									250ms on stderr
+ * 	--trace				I/P	FILE	Replays the traces of a trace file instead of
+ *									generating them; a text file of one reference
+ *									per line is a single trace
+ * 	--trace-dir			I/P	PATH	Replays every trace file of a directory or glob
+ *									pattern in one sweep, largest first, writing the
+ *									average faults of each file to one results file
+ * 	--format			I/P	FORMAT	Reads text traces as the accesses recorded by
+ *									Valgrind Lackey, DineroIV or perf script, as
+ *									byte addresses
+ * 	--write-trace		I/P	FILE	Saves every simulated trace to a trace file,
+ *									which converts a replayed text trace
+ * 	--write-addresses	I/P	-		Writes the byte addresses of the first bytes of
+ *									the pages instead of the pages
+ * 	--compress			I/P	-		Compresses the blocks of written trace files
+ * 	--page-size			I/P	SIZE	Ingests traces of byte addresses as pages of
+ *									SIZE bytes
+ * 	--huge-pages		I/P	-		Backs shared traces with huge pages
+ * 	--threads			I/P	N		Runs the simulations on N work-stealing worker
+ *									threads
+ * 	--processes			I/P	N		Shards traces across N forked worker processes,
+ *									merging their results through shared memory
+ * 	--checkpoint		I/P	FILE	Saves the finished traces and their faults
+ *									periodically
+ * 	--resume			I/P	-		Continues a killed sweep from its checkpoint
+ *									without rerunning finished traces
+ * 	--cache				I/P	FILE	Keeps the result of every (trace, policy, wss)
+ *									cell, keyed by the content of the trace, so
+ *									reruns only simulate missing cells
+ * 	--no-kernels		I/P	-		Runs the generic algorithms instead of the
+ *									specialized kernels and batched engines
+ * 	--belady			I/P	DIR		Saves every trace whose faults grow with its wss
+ *									to DIR, and reports how often each algorithm
+ *									shows Belady's anomaly
+ * 	--shards			I/P	SPEC	Estimates the LRU column from a spatially hashed
+ *									sample of the pages of each trace, for traces
+ *									too long to simulate exactly
+ * 	--stream			I/P	[=SPEC]	Streams the trace file through Counter Stacks
+ *									instead, printing the estimated LRU curve of the
+ *									references so far periodically
+ * 	--lazy				I/P	-		Never stores generated traces: every reference
+ *									is a function of the seed, the trace and its
+ *									position, pulled by the batched engines as they
+ *									need it
+ * 	--writes			I/P	F		Makes a fraction F of generated references
+ *									writes
+ * 	--workload			I/P	SPEC	Generates traces of another workload than the 10
+ *									regions
+ * 	--seed				I/P	N		Seeds the generation of traces
+ * 	--traces			I/P	N		Generates N traces instead of 1000
+ * 	--length			I/P	N		Generates traces of N references
+ * 	--help				I/P	-		Prints the usage of the program and exits
  ***********************************************************************************/
 int main( int argc, char* argv[] ) {
 	// Declare program variables
-	int i, j, wss;
+	int k, wss, policy, opt, status;
+	char *end;
+	Options options = {
+		.traces = TRACES, .threads = 0, .processes = 1, .pageShift = PAGE_SHIFT_4K, .format = TEXT_FORMAT_PLAIN,
+		.length = TRACE_LENGTH, .seed = (uint64_t)time(NULL), .workloadSpec = "regions",
+		.engine = { .kernels = 1, .threads = 1 }
+	};
+	Progress progress;
+	TraceReader reader;
+	Shared *shared;
+	pid_t *children;
+	ShardResults totals = { { { 0 } }, { { 0 } }, { { 0 } }, 0, 0, 0, { 0 }, { 0 } };
 	// Declare program arrays
-	int data[TRACES], LRUResults[SET_SIZE_UPPER+1], FIFOResults[SET_SIZE_UPPER+1], ClockResults[SET_SIZE_UPPER+1];
-	
-	// Fill arrays with empty data
-	for( i = 0; i <= SET_SIZE_UPPER; i++ ) {
-		LRUResults[i] = 0;		// LRU
-		FIFOResults[i] = 0;		// FIFO
-		ClockResults[i] = 0;	// Clock
+	long results[POLICY_COUNT][SET_SIZE_UPPER+1];	// Results of each algorithm, in policies[] order
+
+	// Parse command line options
+	static const struct option longOptions[] = {
+		{ "quiet",			no_argument,		NULL,	'q' },
+		{ "trace",			required_argument,	NULL,	't' },
+		{ "trace-dir",		required_argument,	NULL,	'd' },
+		{ "format",			required_argument,	NULL,	'f' },
+		{ "write-trace",	required_argument,	NULL,	'w' },
+		{ "write-addresses",	no_argument,	NULL,	'A' },
+		{ "compress",		no_argument,		NULL,	'z' },
+		{ "page-size",		required_argument,	NULL,	'p' },
+		{ "huge-pages",		no_argument,		NULL,	'H' },
+		{ "threads",		required_argument,	NULL,	'j' },
+		{ "processes",		required_argument,	NULL,	'P' },
+		{ "checkpoint",		required_argument,	NULL,	'c' },
+		{ "resume",			no_argument,		NULL,	'r' },
+		{ "cache",			required_argument,	NULL,	'C' },
+		{ "no-kernels",		no_argument,		NULL,	'K' },
+		{ "belady",			required_argument,	NULL,	'B' },
+		{ "shards",			required_argument,	NULL,	'S' },
+		{ "stream",			optional_argument,	NULL,	'm' },
+		{ "lazy",			no_argument,		NULL,	'L' },
+		{ "writes",			required_argument,	NULL,	'W' },
+		{ "workload",		required_argument,	NULL,	'g' },
+		{ "seed",			required_argument,	NULL,	's' },
+		{ "traces",			required_argument,	NULL,	'n' },
+		{ "length",			required_argument,	NULL,	'l' },
+		{ "help",			no_argument,		NULL,	'h' },
+		{ NULL,				0,					NULL,	0 }
+	};
+	while( (opt = getopt_long(argc, argv, "qt:d:f:w:Azp:Hj:P:c:rC:KB:S:m::LW:g:s:n:l:h", longOptions, NULL)) != -1 ) {
+		switch( opt ) {
+			case 'q':
+				// Suppress progress reports
+				options.quiet = 1;
+				break;
+			case 't':
+				// Replay traces from a trace file instead of generating them
+				options.traceFile = optarg;
+				break;
+			case 'd':
+				// Replay the traces of many trace files at once
+				options.traceDir = optarg;
+				break;
+			case 'f':
+				// Format of text trace files
+				if( textFormatParse(optarg, &options.format) != 0 ) {
+					printf("ERROR: Invalid trace format %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'w':
+				// Save every simulated trace to a trace file
+				options.writeFile = optarg;
+				break;
+			case 'A':
+				// Write byte addresses instead of pages
+				options.addresses = 1;
+				break;
+			case 'z':
+				// Compress the blocks of written trace files
+				options.compress = 1;
+				break;
+			case 'p':
+				// Page size used to ingest traces of byte addresses
+				if( parsePageSize(optarg, &options.pageShift) != 0 ) {
+					printf("ERROR: Invalid page size %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'H':
+				// Back shared traces with huge pages
+				options.hugePages = 1;
+				break;
+			case 'j':
+				// Number of worker threads
+				options.threads = (int)strtol(optarg, &end, 10);
+				if( end == optarg || *end != '\0' || options.threads <= 0 ) {
+					printf("ERROR: Invalid thread count %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'P':
+				// Number of worker processes
+				options.processes = (int)strtol(optarg, &end, 10);
+				if( end == optarg || *end != '\0' || options.processes <= 0 ) {
+					printf("ERROR: Invalid process count %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'c':
+				// Periodically save progress to a checkpoint file
+				options.checkpointFile = optarg;
+				break;
+			case 'r':
+				// Resume from the checkpoint file
+				options.resume = 1;
+				break;
+			case 'C':
+				// Reuse and record simulation results in a result cache
+				options.cacheFile = optarg;
+				break;
+			case 'K':
+				// Always run the generic algorithms
+				options.engine.kernels = 0;
+				break;
+			case 'B':
+				// Save traces showing Belady's anomaly to a directory
+				options.beladyDir = optarg;
+				break;
+			case 'S':
+				// Estimate the LRU curve from a sample of pages
+				if( shardsParse(optarg, &options.engine.shards) != 0 ) {
+					printf("ERROR: Invalid sampling %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'm':
+				// Stream the trace file through Counter Stacks
+				options.stream = 1;
+				if( counterStackParse(optarg != NULL ? optarg : "", &options.counterStack) != 0 ) {
+					printf("ERROR: Invalid Counter Stacks parameters %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'L':
+				// Pull generated references on demand instead of generating traces
+				options.lazy = 1;
+				break;
+			case 'W':
+				// Fraction of generated references that are writes
+				options.writes = strtod(optarg, &end);
+				if( end == optarg || *end != '\0' || !(options.writes >= 0.0 && options.writes <= 1.0) ) {
+					printf("ERROR: Invalid write fraction %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'g':
+				// Workload to generate traces from
+				options.workloadSpec = optarg;
+				break;
+			case 's':
+				// Seed of the random generator, for reproducible runs
+				options.seed = strtoull(optarg, &end, 10);
+				if( end == optarg || *end != '\0' ) {
+					printf("ERROR: Invalid seed %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'n':
+				// Number of traces to generate
+				options.traces = (int)strtol(optarg, &end, 10);
+				if( end == optarg || *end != '\0' || options.traces <= 0 ) {
+					printf("ERROR: Invalid trace count %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'l':
+				// Number of references per generated trace
+				options.length = strtol(optarg, &end, 10);
+				if( end == optarg || *end != '\0' || options.length <= 0 ) {
+					printf("ERROR: Invalid trace length %s\n", optarg);
+					return -1;
+				}
+				break;
+			case 'h':
+				// Print usage and exit successfully
+				usage(argv[0]);
+				return 0;
+			default:
+				// Print usage and exit with error code
+				usage(argv[0]);
+				return -1;
+		}
 	}
 
-	// Set seed for random generator to current time
-	srand(time(NULL));
+	// Threads default to one per CPU, shared among the processes
+	if( options.threads == 0 ) {
+		options.threads = (int)sysconf(_SC_NPROCESSORS_ONLN) / options.processes;
+		options.threads = options.threads > 0 ? options.threads : 1;
+	}
 
-	// Run experiments
-	for( i = 0; i < TRACES; i++) {
-		// Print progress message
-		printf("Running traces... (%d/%d)%s", i+1, TRACES, ((i+1)%5 == 0 ? "\n" : "\t"));
-		
-		// Generate data
-		for( j = 0; j < TRACES; j++ ) {
-			// Generate a random set of numbers (mean 10, sd 2)
-			data[j] = ( 10 * ((int)(j/100)) ) + normal(10, 2);
+	// Traces can only be saved in order by a single process
+	if( options.writeFile != NULL && options.processes > 1 ) {
+		printf("ERROR: --write-trace cannot be combined with --processes\n");
+		return -1;
+	}
+	if( options.addresses && options.writeFile == NULL ) {
+		printf("ERROR: --write-addresses requires --write-trace\n");
+		return -1;
+	}
+
+	// Resuming needs a checkpoint, and traces can only be saved from the start
+	if( options.resume && options.checkpointFile == NULL ) {
+		printf("ERROR: --resume requires --checkpoint\n");
+		return -1;
+	}
+	if( options.resume && options.writeFile != NULL ) {
+		printf("ERROR: --write-trace cannot be combined with --resume\n");
+		return -1;
+	}
+
+	// Estimates must never be cached as exact results
+	if( options.engine.shards.rate > 0.0 && options.cacheFile != NULL ) {
+		printf("ERROR: --shards cannot be combined with --cache\n");
+		return -1;
+	}
+
+	// Lazy traces exist nowhere to be read, saved, hashed or sampled
+	if( options.lazy && (options.traceFile != NULL || options.writeFile != NULL || options.cacheFile != NULL ||
+						 options.beladyDir != NULL || options.engine.shards.rate > 0.0) ) {
+		printf("ERROR: --lazy cannot be combined with --trace, --write-trace, --cache, --belady or --shards\n");
+		return -1;
+	}
+
+	// Writes are drawn for generated traces only, and counted by exact engines
+	if( options.writes > 0.0 && (options.traceFile != NULL || options.traceDir != NULL || options.lazy) ) {
+		printf("ERROR: --writes cannot be combined with --trace, --trace-dir or --lazy\n");
+		return -1;
+	}
+
+	// Streaming needs a trace file, and keeps no other state
+	if( options.stream ) {
+		if( options.traceFile == NULL ) {
+			printf("ERROR: --stream requires --trace\n");
+			return -1;
 		}
+		return runStream(&options) == 0 ? 0 : -1;
+	}
 
-		// Run monte carlo simulation
-		for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
-			// Accumulate # of page faults for each algorithm base on current wss and trace
-			LRUResults[wss] += LRU(wss, data);		// LRU
-			FIFOResults[wss] += FIFO(wss, data);	// FIFO
-			ClockResults[wss] += Clock(wss, data);	// Clock
+	// Create the directory of anomalous traces, if needed
+	if( options.beladyDir != NULL && mkdir(options.beladyDir, 0777) != 0 && errno != EEXIST ) {
+		printf("ERROR: Failed to create directory %s\n", options.beladyDir);
+		return -1;
+	}
+
+	// Simulate many trace files at once, writing per-file results
+	if( options.traceDir != NULL ) {
+		if( options.traceFile != NULL || options.writeFile != NULL || options.checkpointFile != NULL ||
+			options.processes > 1 || options.lazy ) {
+			printf("ERROR: --trace-dir cannot be combined with --trace, --write-trace, --checkpoint, --processes or --lazy\n");
+			return -1;
+		}
+		return runDirectory(&options) == 0 ? 0 : -1;
+	}
+
+	// Count the traces of the trace file to replay, if any
+	if( options.traceFile != NULL ) {
+		if( traceReaderOpen(&reader, options.traceFile, options.format) != 0 ) {
+			printf("ERROR: Failed to open trace file %s\n", options.traceFile);
+			return -1;
+		}
+		options.traces = (int)reader.traces;
+		options.dirty = (reader.flags & TRACE_FLAG_WRITES) != 0;
+		traceReaderClose(&reader);
+	}
+
+	// Dirty pages are counted by their own engines, whose results are never cached
+	options.dirty |= options.writes > 0.0;
+	if( options.dirty && (options.cacheFile != NULL || options.engine.shards.rate > 0.0) ) {
+		printf("ERROR: Traces with writes cannot be combined with --cache or --shards\n");
+		return -1;
+	}
+
+	// Threads left idle by too few traces per process count the distances of
+	// each trace in chunks, and simulate its segments speculatively. The
+	// batched units of every policy of every trace run at once, each on a
+	// worker and its own helpers, so they share the threads between them
+	k = (options.traces + options.processes - 1) / options.processes * POLICY_COUNT;
+	if( k > 0 && options.threads / k > 1 ) {
+		options.engine.threads = options.threads / k;
+	}
+
+	// Parse the workload to generate traces from
+	options.workload = workloadParse(options.workloadSpec);
+	if( options.workload == NULL ) {
+		printf("ERROR: Invalid workload %s\n", options.workloadSpec);
+		return -1;
+	}
+
+	if( options.processes == 1 ) {
+		// Run experiments in this process
+		progressInit(&progress, "Running traces...", options.traces, options.quiet);
+		if( runSweep(&options, 0, 1, &progress, &totals) != 0 ) {
+			return -1;
+		}
+		progressFinish(&progress);
+	}
+	else {
+		// Map memory shared with the worker processes, holding the shared
+		// progress counters and one set of results per process
+		size_t bytes = sizeof(Shared) + options.processes * sizeof(ShardResults);
+		shared = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		children = malloc(options.processes * sizeof(pid_t));
+		if( shared == MAP_FAILED || children == NULL ) {
+			printf("ERROR: Failed to allocate shared memory for %d processes\n", options.processes);
+			return -1;
+		}
+		progressInit(&shared->progress, "Running traces...", options.traces, options.quiet);
+
+		// Fork one worker process per shard of traces
+		fflush(stdout);
+		for( k = 0; k < options.processes; k++ ) {
+			children[k] = fork();
+			if( children[k] < 0 ) {
+				printf("ERROR: Failed to fork worker process %d\n", k+1);
+				return -1;
+			}
+			if( children[k] == 0 ) {
+				// Worker process: simulate every trace of its shard, then exit
+				status = runSweep(&options, k, options.processes, &shared->progress, &shared->shards[k]);
+				fflush(stdout);
+				_exit(status == 0 ? 0 : 1);
+			}
+		}
+
+		// Wait for every worker process
+		status = 0;
+		for( k = 0; k < options.processes; k++ ) {
+			int childStatus;
+			while( waitpid(children[k], &childStatus, 0) < 0 && errno == EINTR );
+			if( !WIFEXITED(childStatus) || WEXITSTATUS(childStatus) != 0 ) {
+				printf("ERROR: Worker process %d failed\n", k+1);
+				status = -1;
+			}
+		}
+		if( status != 0 ) {
+			return -1;
+		}
+		progressFinish(&shared->progress);
+
+		// Merge the results of every worker process
+		for( k = 0; k < options.processes; k++ ) {
+			for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+				for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+					totals.faults[policy][wss] += shared->shards[k].faults[policy][wss];
+					totals.writebacks[policy][wss] += shared->shards[k].writebacks[policy][wss];
+					totals.fills[policy][wss] += shared->shards[k].fills[policy][wss];
+				}
+			}
+			totals.reused += shared->shards[k].reused;
+			totals.simulated += shared->shards[k].simulated;
+			totals.checked += shared->shards[k].checked;
+			for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+				totals.anomalousTraces[policy] += shared->shards[k].anomalousTraces[policy];
+				totals.anomalousCells[policy] += shared->shards[k].anomalousCells[policy];
+			}
+		}
+		munmap(shared, bytes);
+		free(children);
+	}
+	workloadFree(options.workload);
+
+	// Report how much of the sweep the result cache saved
+	if( options.cacheFile != NULL && !options.quiet ) {
+		fprintf(stderr, "Result cache: %ld cells reused, %ld simulated\n", totals.reused, totals.simulated);
+	}
+
+	// Report how often each algorithm showed Belady's anomaly
+	if( options.beladyDir != NULL ) {
+		for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+			fprintf(stderr, "Belady's anomaly: %s in %ld of %ld traces (%.4f%%), at %ld wss\n",
+				policies[policy].name, totals.anomalousTraces[policy], totals.checked,
+				totals.checked > 0 ? 100.0 * totals.anomalousTraces[policy] / totals.checked : 0.0,
+				totals.anomalousCells[policy]);
 		}
 	}
 
+	// Check if there is anything to average
+	if( options.traces == 0 ) {
+		printf("ERROR: No traces to simulate\n");
+		return -1;
+	}
+
 	// Get the average of the results
-	for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
-		LRUResults[wss] /= TRACES;		// LRU
-		FIFOResults[wss] /= TRACES;		// FIFO
-		ClockResults[wss] /= TRACES;	// Clock
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+			results[policy][wss] = totals.faults[policy][wss] / options.traces;
+		}
 	}
 	
 	// Get current time
@@ -126,15 +640,27 @@ int main( int argc, char* argv[] ) {
 	}
 
 	// Output results header to file
-	fprintf(file, "%s,%s,%s,%s\n", "wss", "LRU" , "FIFO", "Clock");
+	fprintf(file, "%s", "wss");
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		fprintf(file, ",%s", policies[policy].name);
+	}
+	for( policy = 0; options.dirty && policy < POLICY_COUNT; policy++ ) {
+		fprintf(file, ",%s_clean,%s_dirty,%s_io", policies[policy].name, policies[policy].name, policies[policy].name);
+	}
+	fprintf(file, "\n");
 
 	// Output results to file
 	for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
 		// Output statistics
-		fprintf(file, "%d,", wss);					// wss
-		fprintf(file, "%d,", LRUResults[wss]);		// LRU
-		fprintf(file, "%d,", FIFOResults[wss]);		// FIFO
-		fprintf(file, "%d\n", ClockResults[wss]);	// Clock
+		fprintf(file, "%d", wss);					// wss
+		for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+			fprintf(file, ",%ld", results[policy][wss]);	// each algorithm
+		}
+		for( policy = 0; options.dirty && policy < POLICY_COUNT; policy++ ) {
+			writeDirty(file, totals.faults[policy][wss], totals.writebacks[policy][wss],
+				totals.fills[policy][wss], options.traces, options.pageShift);
+		}
+		fprintf(file, "\n");
 	}
 	
 	// Close file
@@ -145,7 +671,7 @@ int main( int argc, char* argv[] ) {
 }
 
 /***********************************************************************************
- * int LRU( int wss, int data[] )
+ * long LRU( int wss, const PageKey data[], long length, Arena *arena )
  * Author: Justin Hardy
  * Date: 19 November 2021
  * Description: Peforms the Least Recently Used virtual memory replacement algorithm
@@ -156,32 +682,39 @@ int main( int argc, char* argv[] ) {
  * 					its execution.
  *
  * Parameters:
- * 	wss		I/P	int			The working set size to be utitilized
- * 	data	I/P	int []		The data to perform the algorithm on
- * 	LRU		O/P	int			The number of page faults that occurred
+ * 	wss		I/P	int				The working set size to be utitilized
+ * 	data	I/P	const PageKey []	The data to perform the algorithm on
+ * 	length	I/P	long			The number of references in the data
+ * 	arena	I/O	Arena *			The arena to allocate the frame table from
+ * 	LRU		O/P	long			The number of page faults that occurred
  *								during the algorithm's execution.
  ***********************************************************************************/
-int LRU( int wss, int data[] ) {
+long LRU( int wss, const PageKey data[], long length, Arena *arena ) {
 	// Create fault variable count, array, and array size.
 	// Size keeps track of how much data is filling the array;
-	// Empty cells are marked by INT_MIN.
-	int faults = 0, size = 0;
-	int set[wss];
-	
-	// Fill array with default values
-	int i;
-	for( i = 0; i < wss; i++ ) {
-		set[i] = INT_MIN;
+	// Empty cells are marked by a clear bit in the validity bitmap.
+	long faults = 0;
+	int size = 0;
+	PageKey *set = arenaAlloc(arena, wss * sizeof(PageKey));
+	uint64_t *valid = arenaAlloc(arena, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	PageKey *ru = arenaAlloc(arena, wss * sizeof(PageKey));	// Recently used pages of a fault
+	if( set == NULL || valid == NULL || ru == NULL ) {
+		return -1;
 	}
+	
+	// Mark every cell of the array empty
+	long i;
+	memset(valid, 0, BITMAP_WORDS(wss) * sizeof(uint64_t));
 
 	// Run LRU Algorithm on the array
-	for( i = 0; i < TRACES; i++ ) {
+	for( i = 0; i < length; i++ ) {
 		// Check if data is not present in the set
-		if( !arrayContains(set, wss, data[i]) ) {
+		if( !arrayContains(set, valid, wss, data[i]) ) {
 			// Check if set has room for more pages
 			if( size != wss ) {
 				// Insert data into set
 				set[size] = data[i];
+				bitmapSet(valid, size);
 
 				// Increment size
 				size++;
@@ -189,20 +722,19 @@ int LRU( int wss, int data[] ) {
 			else {
 				// Page fault has occurred
 				// Determine least recently used page
-				int j, c, lru;
-				int ru[wss];
-
-				// fill recently used array with default values
-				for( j = 0; j < wss; j++ ) {
-					ru[j] = INT_MIN;
-				}
+				long j;
+				int c;
+				PageKey lru = 0;
 
+				// The set is full, so its validity bitmap also marks the
+				// first c cells of the recently used array, and nothing
+				// needs to be cleared between faults
 				for( j = i, c = 0; j >= 0; j-- ) {
 					// Check if this element of the data exists in the set
-					if( arrayContains(set, wss, data[j]) ) {
+					if( arrayContains(set, valid, wss, data[j]) ) {
 						// This element was recently used
 						// If this page wasn't already accounted for
-						if( !arrayContains(ru, wss, data[j]) ) {
+						if( !arrayContains(ru, valid, c, data[j]) ) {
 							// add the data to ru
 							ru[c] = data[j];
 							
@@ -224,7 +756,7 @@ int LRU( int wss, int data[] ) {
 				}
 				
 				// Replace least recently used page with new data value
-				c = getIndex(set, wss, lru);
+				c = getIndex(set, valid, wss, lru);
 				set[c] = data[i];
 			
 				// Increment page faults counter
@@ -238,7 +770,7 @@ int LRU( int wss, int data[] ) {
 }
 
 /***********************************************************************************
- * int FIFO( int wss, int data[] )
+ * long FIFO( int wss, const PageKey data[], long length, Arena *arena )
  * Author: Justin Hardy
  * Date: 19 November 2021
  * Description: Performs the First-In-First-Out virtual memory replacement algorithm
@@ -249,31 +781,37 @@ int LRU( int wss, int data[] ) {
  * 					its execution.
  *
  * Parameters:
- * 	wss		I/P	int		The working set size to be utitilized
- * 	data	I/P	int []	The data to perform the algorithm on
- * 	FIFO	O/P	int		The number of page faults that occurred
+ * 	wss		I/P	int				The working set size to be utitilized
+ * 	data	I/P	const PageKey []	The data to perform the algorithm on
+ * 	length	I/P	long			The number of references in the data
+ * 	arena	I/O	Arena *			The arena to allocate the frame table from
+ * 	FIFO	O/P	long			The number of page faults that occurred
  *							during the algorithm's execution.
  ***********************************************************************************/
-int FIFO( int wss, int data[] ) {
+long FIFO( int wss, const PageKey data[], long length, Arena *arena ) {
 	// Create fault count variable & array
-	int faults = 0, size = 0;
-	int set[wss];
-
-	//  Fill array with default values
-	int i;
-	for( i = 0; i < wss; i++ ) {
-		set[i] = INT_MIN;
+	long faults = 0;
+	int size = 0;
+	PageKey *set = arenaAlloc(arena, wss * sizeof(PageKey));
+	uint64_t *valid = arenaAlloc(arena, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	if( set == NULL || valid == NULL ) {
+		return -1;
 	}
 
+	// Mark every cell of the array empty
+	long i;
+	memset(valid, 0, BITMAP_WORDS(wss) * sizeof(uint64_t));
+
 	// Run FIFO Algorithm on the array
 	int fifoIndex = 0;
-	for( i = 0; i < TRACES; i++ ) {
+	for( i = 0; i < length; i++ ) {
 		// Check if data is not present in the set 
-		if( !arrayContains(set, wss, data[i]) ) {
+		if( !arrayContains(set, valid, wss, data[i]) ) {
 			// Check if set has room for more pages
 			if( size != wss ) {
 				// Add data to set
 				set[size] = data[i];
+				bitmapSet(valid, size);
 
 				// Increment size
 				size++;
@@ -302,7 +840,7 @@ int FIFO( int wss, int data[] ) {
 }
 
 /***********************************************************************************
- * int Clock( int wss, int data[] )
+ * long Clock( int wss, const PageKey data[], long length, Arena *arena )
  * Author: Justin Hardy
  * Date: 19 November 2021
  * Description: Performs the Clock virtual memory replacement algorithm on a given
@@ -310,54 +848,76 @@ int FIFO( int wss, int data[] ) {
  * 					the algorithm performs, it will count the number of page
  * 					faults that occur, and by the end of its execution, return
  * 					the number of page faults that had occurred throughout its
- * 					execution.
+ * 					execution. Second chance bits are packed into a bitmap, so
+ * 					the hand skips and clears up to 64 frames per step.
  *
  * Parameters:
- * 	wss		I/P	int		The working set size to be utitilized
- * 	data	I/P	int []	The data to perform the algorithm on
- * 	Clock	O/P	int		The number of page faults that occurred
+ * 	wss		I/P	int				The working set size to be utitilized
+ * 	data	I/P	const PageKey []	The data to perform the algorithm on
+ * 	length	I/P	long			The number of references in the data
+ * 	arena	I/O	Arena *			The arena to allocate the frame table from
+ * 	Clock	O/P	long			The number of page faults that occurred
  *						during the algorithm's execution.
  ***********************************************************************************/
-int Clock( int wss, int data[] ) {
+long Clock( int wss, const PageKey data[], long length, Arena *arena ) {
 	// Create faults count variable & array
-	int faults = 0, size = 0;
-	int set[wss], secondChance[wss];
+	long faults = 0;
+	int size = 0;
+	PageKey *set = arenaAlloc(arena, wss * sizeof(PageKey));
+	uint64_t *valid = arenaAlloc(arena, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	uint64_t *secondChance = arenaAlloc(arena, BITMAP_WORDS(wss) * sizeof(uint64_t));	// One second chance bit per frame
+	if( set == NULL || valid == NULL || secondChance == NULL ) {
+		return -1;
+	}
+
+	// Frames of the last bitmap word which exist
+	uint64_t lastWord = wss % BITMAP_BITS ? ((uint64_t)1 << (wss % BITMAP_BITS)) - 1 : ~(uint64_t)0;
+	int lastIndex = (wss - 1) / BITMAP_BITS;
 
 	// Fill arrays with default values
-	int i;
-	for( i = 0; i < wss; i++ ) {
-		set[i] = INT_MIN;
-		secondChance[i] = 0; // second chance bits start at 0 
-	}
+	long i;
+	memset(valid, 0, BITMAP_WORDS(wss) * sizeof(uint64_t));
+	memset(secondChance, 0, BITMAP_WORDS(wss) * sizeof(uint64_t)); // second chance bits start at 0
 
 	// Run Clock Algorithm on the array
 	int fifoIndex = 0;
-	for( i = 0; i < TRACES; i++ ) {
+	for( i = 0; i < length; i++ ) {
 		// Check if data is not present in the set 
-		if( !arrayContains(set, wss, data[i]) ) {
+		if( !arrayContains(set, valid, wss, data[i]) ) {
 			// Check if set has room for more pages
 			if( size != wss ) {
 				// Add data to set
 				set[size] = data[i];
+				bitmapSet(valid, size);
 
 				// Increment size
 				size++;
 			}
 			else {
 				// Page fault has occurred
-				// Determine which index needs to be replaced
-				while( secondChance[fifoIndex] != 0 ) {
-					// Remove the element's second chance use bit
-					secondChance[fifoIndex] = 0;
-					
-					// Increment first-in-first-out index
-					fifoIndex++;
-
-					// Wrap first-in-first-out index around wss if applicable
-					if( fifoIndex == wss ) {
-						fifoIndex = 0;
+				// Determine which index needs to be replaced, a word of frames at a time
+				for( ;; ) {
+					int word = fifoIndex / BITMAP_BITS;
+					uint64_t fromHand = ~(uint64_t)0 << (fifoIndex % BITMAP_BITS);
+					uint64_t frames = word == lastIndex ? fromHand & lastWord : fromHand;
+
+					// Find the first frame from the hand without a second chance
+					uint64_t candidates = frames & ~secondChance[word];
+					if( candidates != 0 ) {
+						int victim = __builtin_ctzll(candidates);
+
+						// Remove the second chance use bits of the frames passed
+						secondChance[word] &= ~(frames & (((uint64_t)1 << victim) - 1));
+						fifoIndex = word * BITMAP_BITS + victim;
+						break;
 					}
-				}					
+
+					// Remove the second chance use bits of every frame passed
+					secondChance[word] &= ~frames;
+
+					// Move first-in-first-out index to the next word, wrapping around wss if applicable
+					fifoIndex = word == lastIndex ? 0 : (word + 1) * BITMAP_BITS;
+				}
 
 				// Replace using first-in-first-out index
 				set[fifoIndex] = data[i];
@@ -376,7 +936,7 @@ int Clock( int wss, int data[] ) {
 		}
 		else {
 			// Set second chance bit of the data in the set to 1.
-			secondChance[ getIndex(set, wss, data[i]) ] = 1;
+			bitmapSet(secondChance, getIndex(set, valid, wss, data[i]));
 		}
 	}
 	
@@ -385,55 +945,27 @@ int Clock( int wss, int data[] ) {
 }
 
 /***********************************************************************************
- * int normal( int mean, int sd )
- * Author: Justin Hardy
- * Date: 19 November 2021
- * Description: Generates a normal, random number distribution with a specified mean
- * 					and standard deviation.
- *
- * Parameters:
- * 	mean	I/P	int		The mean of the normal distribution.
- * 	sd		I/P	int		The standard deviation of the normal
- *							distribution.
- * 	normal	O/P	int		A randomly generated number within the
- *							normal distribution.
- ***********************************************************************************/
-int normal( int mean, int sd ) {
-	// Generate random number 1
-	double r1;
-	do {
-		// Make sure the random number is not 0!!
-		// Otherwise the program crashes :(
-		r1 = ((double)rand()) / ((double)RAND_MAX);
-	} while(r1 == 0.0);
-	
-	// Generate random number 2
-	double r2 = ((double)rand()) / ((double)RAND_MAX);
-	
-	// Use normal distribution formula to generate random number
-	return (int) ((( sqrt(-2.0 * log(r1) ) * cos(2.0 * M_PI * r2 )) * sd) + mean);
-}
-
-/***********************************************************************************
- * int arrayContains( int array[], int size, int value )
+ * int arrayContains( const PageKey array[], const uint64_t valid[], int size,
+ *						PageKey value )
  * Author: Justin Hardy
  * Date: 19 November 2021
  * Description: Determines if an array of a particular size contains a specified
  * 					value. Returns 1 (for true) if the array contains the said
  * 					value, and 0 (for false) if the array does not contain the
- * 					value.
+ * 					value. Only cells marked in the validity bitmap are searched.
  *
  * Parameters:
- * 	array			I/P	int []	The array to be searched through.
- * 	size			I/P	int		The size of the array.
- * 	value			I/P	int		The value to be found in the array.
- * 	arrayContains	O/P	int		1 if array contains value, 0 if not.
+ * 	array			I/P	const PageKey []	The array to be searched through.
+ * 	valid			I/P	const uint64_t []	The cells of the array in use.
+ * 	size			I/P	int				The size of the array.
+ * 	value			I/P	PageKey			The value to be found in the array.
+ * 	arrayContains	O/P	int				1 if array contains value, 0 if not.
  ***********************************************************************************/
-int arrayContains( int array[], int size, int value ) {
+int arrayContains( const PageKey array[], const uint64_t valid[], int size, PageKey value ) {
 	// Basic array contains() function, since C doesn't offer one for arrays..
 	int i;
 	for( i = 0; i < size; i++ ) {
-		if( value == array[i] ) {
+		if( value == array[i] && bitmapTest(valid, i) ) {
 			return 1;
 		}
 	}
@@ -441,28 +973,795 @@ int arrayContains( int array[], int size, int value ) {
 }
 
 /***********************************************************************************
- * int arrayContains( int array[], int size, int value )
+ * int getIndex( const PageKey array[], const uint64_t valid[], int size,
+ *					PageKey value )
  * Author: Justin Hardy
  * Date: 19 November 2021
  * Description: Determines the index at which an array contains a specified value. 
  * 					Returns the index at which the value can be first found in
  * 					the array, or -1 if the value does not exist within the
- * 					array.
+ * 					array. Only cells marked in the validity bitmap are searched.
  *
  * Parameters:
- * 	array		I/P	int []	The array to be searched through.
- * 	size		I/P	int		The size of the array.
- * 	value		I/P	int		The value to be found in the array.
- * 	getIndex	O/P	int		The index of value, -1 if value does
- *							not exist in array.
+ * 	array		I/P	const PageKey []	The array to be searched through.
+ * 	valid		I/P	const uint64_t []	The cells of the array in use.
+ * 	size		I/P	int				The size of the array.
+ * 	value		I/P	PageKey			The value to be found in the array.
+ * 	getIndex	O/P	int				The index of value, -1 if value does
+ *								not exist in array.
  ***********************************************************************************/
-int getIndex( int array[], int size, int value ) {
+int getIndex( const PageKey array[], const uint64_t valid[], int size, PageKey value ) {
 	// Basic array find() function, since C doesn't offer one for arrays..
 	int i;
 	for( i = 0; i < size; i++ ) {
-		if( array[i] == value ) {
+		if( array[i] == value && bitmapTest(valid, i) ) {
 			return i;
 		}
 	}
 	return -1;
 }
+
+/***********************************************************************************
+ * int runSweep( const Options *options, int shard, int shards, Progress *progress,
+ *				ShardResults *results )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Simulates every algorithm for every wss on the traces of one shard,
+ *					i.e. the traces whose number modulo shards equals shard, on a
+ *					pool of worker threads, and stores the accumulated # of page
+ *					faults. Generated traces are created by the workers unless
+ *					they must be saved in order; a trace file is read and
+ *					decoded ahead on a reader thread, which skips the traces of
+ *					other shards without decoding them, as well as the traces
+ *					finished by a resumed checkpoint. Every process keeps
+ *					its own checkpoint file, suffixed with its shard if the run
+ *					has several.
+ *
+ * Parameters:
+ * 	options		I/P	const Options *	The command line options
+ * 	shard		I/P	int				The number of the shard to simulate
+ * 	shards		I/P	int				The total number of shards
+ * 	progress	I/O	Progress *		The progress of the whole run
+ * 	results		O/P	ShardResults *	Accumulated faults and dirty evictions per policy
+ *									and wss, and counts of reused cells and anomalies
+ * 	runSweep	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int runSweep( const Options *options, int shard, int shards, Progress *progress,
+			ShardResults *results ) {
+	int i, wss, policy, status;
+	Sweep sweep;
+	SweepConfig config;
+	Checkpoint checkpoint;
+	char *checkpointPath = NULL, *source;
+	ResultCache cache;
+	Belady belady;
+	TracePipe pipe;
+	uint64_t *skip, *writes;
+	TraceWriter writer;
+	Rng rng;
+	Trace *trace;
+	PageKey *data;
+
+	// Prepare the checkpoint of the shard, resuming it if requested; replayed
+	// traces do not depend on the seed and length of generated ones
+	source = checkpointSource(options, options->traceFile != NULL ? options->traceFile : options->workloadSpec);
+	if( source == NULL ) {
+		printf("ERROR: Failed to allocate checkpoint\n");
+		return -1;
+	}
+	if( options->traceFile != NULL ) {
+		status = checkpointInit(&checkpoint, 0, 0, options->traces, shard, shards, source);
+	}
+	else {
+		status = checkpointInit(&checkpoint, options->seed, options->length, options->traces, shard, shards, source);
+	}
+	free(source);
+	if( status != 0 ) {
+		printf("ERROR: Failed to allocate checkpoint\n");
+		return -1;
+	}
+	if( options->checkpointFile != NULL ) {
+		checkpointPath = malloc(strlen(options->checkpointFile) + 16);
+		if( checkpointPath == NULL ) {
+			printf("ERROR: Failed to allocate checkpoint\n");
+			return -1;
+		}
+		if( shards > 1 ) {
+			sprintf(checkpointPath, "%s.%d", options->checkpointFile, shard);
+		}
+		else {
+			strcpy(checkpointPath, options->checkpointFile);
+		}
+	}
+	if( options->resume ) {
+		if( checkpointLoad(&checkpoint, checkpointPath) != 0 ) {
+			printf("ERROR: Failed to resume from checkpoint %s; it must be written by the same run\n", checkpointPath);
+			return -1;
+		}
+		progressAdvance(progress, checkpoint.completed);
+	}
+
+	// Open the result cache, if any
+	if( options->cacheFile != NULL && resultCacheOpen(&cache, options->cacheFile) != 0 ) {
+		printf("ERROR: Failed to open result cache %s\n", options->cacheFile);
+		return -1;
+	}
+
+	// Prepare the detector of Belady's anomaly, if any, with the counts of
+	// resumed traces
+	if( options->beladyDir != NULL ) {
+		beladyInit(&belady, options->beladyDir, options->compress ? TRACE_FLAG_COMPRESSED : 0);
+		belady.checked = checkpoint.checked;
+		memcpy(belady.traces, checkpoint.anomalousTraces, sizeof(belady.traces));
+		memcpy(belady.cells, checkpoint.anomalousCells, sizeof(belady.cells));
+	}
+
+	// Start reading the trace file to replay, if any, skipping the traces of
+	// other shards and finished traces
+	if( options->traceFile != NULL ) {
+		skip = calloc(BITMAP_WORDS(options->traces) + 1, sizeof(uint64_t));
+		if( skip == NULL ) {
+			printf("ERROR: Failed to open trace file %s\n", options->traceFile);
+			return -1;
+		}
+		for( i = 0; i < options->traces; i++ ) {
+			if( i % shards != shard || bitmapTest(checkpoint.done, i) ) {
+				bitmapSet(skip, i);
+			}
+		}
+		status = tracePipeOpen(&pipe, options->traceFile, options->format, options->pageShift, skip);
+		free(skip);
+		if( status != 0 ) {
+			printf("ERROR: Failed to open trace file %s\n", options->traceFile);
+			return -1;
+		}
+	}
+
+	// Create the trace file to write, if any
+	if( options->writeFile != NULL &&
+		traceWriterOpen(&writer, options->writeFile, (options->compress ? TRACE_FLAG_COMPRESSED : 0) |
+						(options->dirty ? TRACE_FLAG_WRITES : 0) | (options->addresses ? TRACE_FLAG_ADDRESSES : 0),
+						options->pageShift) != 0 ) {
+		printf("ERROR: Failed to create trace file %s\n", options->writeFile);
+		return -1;
+	}
+
+	// Start the parallel sweep
+	config = (SweepConfig){
+		.threads = options->threads, .engine = options->engine, .workload = options->workload, .seed = options->seed,
+		.length = options->length, .hugePages = options->hugePages, .lazy = options->lazy,
+		.dirty = options->dirty, .writes = options->writes, .progress = progress,
+		.checkpoint = &checkpoint, .checkpointPath = checkpointPath,
+		.cache = options->cacheFile != NULL ? &cache : NULL,
+		.belady = options->beladyDir != NULL ? &belady : NULL
+	};
+	if( sweepStart(&sweep, &config) != 0 ) {
+		printf("ERROR: Failed to start %d worker threads\n", options->threads);
+		return -1;
+	}
+
+	// Run experiments
+	for( i = 0; i < options->traces; i++) {
+		// Traces of other shards or already finished need not be touched at all
+		if( i % shards != shard || bitmapTest(checkpoint.done, i) ) {
+			continue;
+		}
+
+		// Generated traces are created by the workers, unless they must be saved in order
+		if( options->traceFile == NULL && options->writeFile == NULL ) {
+			if( sweepSubmit(&sweep, i, NULL) != 0 ) {
+				printf("ERROR: Failed to submit trace %d\n", i+1);
+				return -1;
+			}
+			continue;
+		}
+
+		if( options->traceFile != NULL ) {
+			// Copy the chunks decoded ahead by the reader into the shared trace
+			trace = readTrace(&pipe, i, i, options->hugePages);
+			if( trace == NULL ) {
+				printf("ERROR: Failed to read trace %d of trace file %s\n", i+1, options->traceFile);
+				return -1;
+			}
+		}
+		else {
+			// Create the trace every simulation will share
+			trace = traceCreate(i, options->length, options->hugePages, &data);
+			if( trace == NULL ) {
+				printf("ERROR: Failed to allocate trace %d of length %ld\n", i+1, options->length);
+				return -1;
+			}
+
+			// Generate data; every trace has its own random stream
+			rngSeed(&rng, options->seed, (uint64_t)i);
+			workloadGenerate(options->workload, &rng, data, options->length);
+			if( options->writes > 0.0 ) {
+				writes = traceAddWrites(trace);
+				if( writes == NULL ) {
+					printf("ERROR: Failed to allocate trace %d of length %ld\n", i+1, options->length);
+					return -1;
+				}
+				workloadWrites(&rng, options->writes, writes, options->length);
+			}
+		}
+
+		// The trace is read-only from now on
+		traceSeal(trace);
+
+		// Save trace if requested
+		if( options->writeFile != NULL && traceWriterAppend(&writer, trace->pages, trace->writes, trace->length) != 0 ) {
+			printf("ERROR: Failed to write trace file %s\n", options->writeFile);
+			return -1;
+		}
+
+		// Run monte carlo simulation of every wss and algorithm on the workers
+		if( sweepSubmit(&sweep, i, trace) != 0 ) {
+			printf("ERROR: Failed to submit trace %d\n", i+1);
+			return -1;
+		}
+	}
+
+	// Wait for every simulation, and collect the accumulated # of page faults
+	if( sweepFinish(&sweep) != 0 ) {
+		printf("ERROR: Failed to generate or simulate traces of length %ld, or save checkpoint or anomalous traces\n", options->length);
+		return -1;
+	}
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+			results->faults[policy][wss] = checkpoint.faults[policy][wss];
+			results->writebacks[policy][wss] = checkpoint.writebacks[policy][wss];
+			results->fills[policy][wss] = checkpoint.fills[policy][wss];
+		}
+	}
+	checkpointFree(&checkpoint);
+	free(checkpointPath);
+
+	// Record the anomalies found
+	results->checked = 0;
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		results->anomalousTraces[policy] = results->anomalousCells[policy] = 0;
+	}
+	if( options->beladyDir != NULL ) {
+		results->checked = belady.checked;
+		for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+			results->anomalousTraces[policy] = belady.traces[policy];
+			results->anomalousCells[policy] = belady.cells[policy];
+		}
+	}
+
+	// Close the result cache, recording how much of the sweep it saved
+	results->reused = results->simulated = 0;
+	if( options->cacheFile != NULL ) {
+		results->reused = atomic_load(&cache.hits);
+		results->simulated = atomic_load(&cache.misses);
+		if( resultCacheClose(&cache) != 0 ) {
+			printf("ERROR: Failed to write result cache %s\n", options->cacheFile);
+			return -1;
+		}
+	}
+
+	// Close trace files
+	if( options->traceFile != NULL ) {
+		tracePipeClose(&pipe);
+	}
+	if( options->writeFile != NULL && traceWriterClose(&writer) != 0 ) {
+		printf("ERROR: Failed to write trace file %s\n", options->writeFile);
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int runStream( const Options *options )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Streams every trace of the trace file, one block at a time as the
+ *					reader thread of a trace pipe decodes it, as a
+ *					single stream of references through Counter Stacks, keeping
+ *					no state per page. The estimated LRU faults of every wss on
+ *					the references so far are printed to stdout as a CSV row
+ *					every options->counterStack.every references, and once more
+ *					at the end of the stream.
+ *
+ * Parameters:
+ * 	options		I/P	const Options *	The command line options
+ * 	runStream	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int runStream( const Options *options ) {
+	TracePipe pipe;
+	const PipeChunk *chunk;
+	CounterStack stack;
+	long faults[SET_SIZE_UPPER+1];
+	long j;
+	int wss;
+
+	// Start reading the trace file, and open the counter stack
+	if( tracePipeOpen(&pipe, options->traceFile, options->format, options->pageShift, NULL) != 0 ) {
+		printf("ERROR: Failed to open trace file %s\n", options->traceFile);
+		return -1;
+	}
+	if( counterStackInit(&stack, &options->counterStack, SET_SIZE_UPPER) != 0 ) {
+		printf("ERROR: Failed to allocate Counter Stacks\n");
+		return -1;
+	}
+
+	// Output curve header
+	printf("references");
+	for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+		printf(",%d", wss);
+	}
+	printf("\n");
+
+	// Stream every chunk of every trace, decoded ahead by the reader
+	for( chunk = tracePipeTake(&pipe); chunk->trace >= 0; chunk = tracePipeTake(&pipe) ) {
+		for( j = 0; j < chunk->count; j++ ) {
+			if( counterStackAccess(&stack, chunk->pages[j]) != 0 ) {
+				printf("ERROR: Failed to allocate Counter Stacks\n");
+				return -1;
+			}
+
+			// Emit the curve so far periodically
+			if( stack.references % options->counterStack.every == 0 ) {
+				counterStackCurve(&stack, SET_SIZE_LOWER, SET_SIZE_UPPER, faults);
+				printf("%ld", stack.references);
+				for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+					printf(",%ld", faults[wss]);
+				}
+				printf("\n");
+				fflush(stdout);
+			}
+		}
+		tracePipeRelease(&pipe);
+	}
+	if( chunk->count < 0 ) {
+		printf("ERROR: Failed to read trace file %s\n", options->traceFile);
+		return -1;
+	}
+
+	// Emit the final curve, unless it was just emitted
+	if( stack.references % options->counterStack.every != 0 ) {
+		counterStackCurve(&stack, SET_SIZE_LOWER, SET_SIZE_UPPER, faults);
+		printf("%ld", stack.references);
+		for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+			printf(",%ld", faults[wss]);
+		}
+		printf("\n");
+	}
+
+	counterStackFree(&stack);
+	tracePipeClose(&pipe);
+	return 0;
+}
+
+/***********************************************************************************
+ * int runDirectory( const Options *options )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Simulates every algorithm and wss on every trace of many trace
+ *					files in one sweep, writing one consolidated results file
+ *					with the average faults of each file. The files are the
+ *					trace files (*.vmt) of options->traceDir if it is a
+ *					directory, or else the files matching it as a glob pattern.
+ *					Files are read largest first, so that the longest traces
+ *					start first and the shorter ones fill the worker pool as it
+ *					drains; the traces of all files are numbered consecutively
+ *					within the sweep, and their faults kept apart by number.
+ *					If any file records writes, the evictions of dirty pages are
+ *					counted too, and written as the same write-back columns as a
+ *					sweep's; the traces of the other files only read.
+ *
+ * Parameters:
+ * 	options			I/P	const Options *	The command line options
+ * 	runDirectory	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int runDirectory( const Options *options ) {
+	TraceDirFile *files;
+	TraceFaults *traceFaults;
+	long *order, total = 0, faults, writebacks, fills, t;
+	int i, k, wss, policy, status, dirty = 0;
+	char *pattern, *source;
+	glob_t matches;
+	struct stat info;
+	TraceReader reader;
+	Progress progress;
+	SweepConfig config;
+	Checkpoint checkpoint;
+	ResultCache cache;
+	Belady belady;
+	TracePipe pipe;
+	Sweep sweep;
+	Trace *trace;
+
+	// A directory stands for the trace files it holds
+	pattern = malloc(strlen(options->traceDir) + 8);
+	if( pattern == NULL ) {
+		printf("ERROR: Failed to allocate trace files of %s\n", options->traceDir);
+		return -1;
+	}
+	strcpy(pattern, options->traceDir);
+	if( stat(options->traceDir, &info) == 0 && S_ISDIR(info.st_mode) ) {
+		strcat(pattern, "/*.vmt");
+	}
+	status = glob(pattern, 0, NULL, &matches);
+	free(pattern);
+	if( status != 0 || matches.gl_pathc == 0 ) {
+		printf("ERROR: No trace files match %s\n", options->traceDir);
+		return -1;
+	}
+
+	// Size and count the traces of every file
+	files = calloc(matches.gl_pathc, sizeof(TraceDirFile));
+	order = malloc(matches.gl_pathc * sizeof(long));
+	if( files == NULL || order == NULL ) {
+		printf("ERROR: Failed to allocate trace files of %s\n", options->traceDir);
+		return -1;
+	}
+	for( i = 0; i < (int)matches.gl_pathc; i++ ) {
+		files[i].path = matches.gl_pathv[i];
+		if( stat(files[i].path, &info) != 0 || traceReaderOpen(&reader, files[i].path, options->format) != 0 ) {
+			printf("ERROR: Failed to open trace file %s\n", files[i].path);
+			return -1;
+		}
+		files[i].size = (long)info.st_size;
+		files[i].traces = reader.traces;
+		dirty |= (reader.flags & TRACE_FLAG_WRITES) != 0;
+		traceReaderClose(&reader);
+		order[i] = i;
+	}
+
+	// Read the files largest first, numbering their traces in that order
+	sortFiles = files;
+	qsort(order, matches.gl_pathc, sizeof(long), compareFiles);
+	for( i = 0; i < (int)matches.gl_pathc; i++ ) {
+		files[order[i]].first = total;
+		total += files[order[i]].traces;
+	}
+	if( total == 0 ) {
+		printf("ERROR: No traces to simulate\n");
+		return -1;
+	}
+
+	// Dirty pages are counted if any file records writes; the traces of the
+	// other files only read
+	if( dirty && (options->cacheFile != NULL || options->engine.shards.rate > 0.0) ) {
+		printf("ERROR: Traces with writes cannot be combined with --cache or --shards\n");
+		return -1;
+	}
+
+	// Prepare the totals, which no checkpoint file records, and the faults of
+	// every trace
+	traceFaults = malloc(total * sizeof(TraceFaults));
+	source = checkpointSource(options, options->traceDir);
+	status = traceFaults == NULL || source == NULL ||
+			checkpointInit(&checkpoint, 0, 0, total, 0, 1, source) != 0;
+	free(source);
+	if( status != 0 ) {
+		printf("ERROR: Failed to allocate the results of %ld traces\n", total);
+		return -1;
+	}
+
+	// Open the result cache and prepare the detector of Belady's anomaly, if any
+	if( options->cacheFile != NULL && resultCacheOpen(&cache, options->cacheFile) != 0 ) {
+		printf("ERROR: Failed to open result cache %s\n", options->cacheFile);
+		return -1;
+	}
+	if( options->beladyDir != NULL ) {
+		beladyInit(&belady, options->beladyDir, options->compress ? TRACE_FLAG_COMPRESSED : 0);
+	}
+
+	// Start the parallel sweep
+	progressInit(&progress, "Running traces...", total, options->quiet);
+	config = (SweepConfig){
+		.threads = options->threads, .engine = options->engine, .hugePages = options->hugePages, .dirty = dirty,
+		.progress = &progress, .checkpoint = &checkpoint, .cache = options->cacheFile != NULL ? &cache : NULL,
+		.belady = options->beladyDir != NULL ? &belady : NULL, .traceFaults = traceFaults
+	};
+	if( sweepStart(&sweep, &config) != 0 ) {
+		printf("ERROR: Failed to start %d worker threads\n", options->threads);
+		return -1;
+	}
+
+	// Run experiments on every trace of every file
+	for( i = 0; i < (int)matches.gl_pathc; i++ ) {
+		TraceDirFile *file = &files[order[i]];
+		if( tracePipeOpen(&pipe, file->path, options->format, options->pageShift, NULL) != 0 ) {
+			printf("ERROR: Failed to open trace file %s\n", file->path);
+			return -1;
+		}
+		for( t = 0; t < file->traces; t++ ) {
+			trace = readTrace(&pipe, t, file->first + t, options->hugePages);
+			if( trace == NULL ) {
+				printf("ERROR: Failed to read trace %ld of trace file %s\n", t+1, file->path);
+				return -1;
+			}
+			traceSeal(trace);
+			if( sweepSubmit(&sweep, file->first + t, trace) != 0 ) {
+				printf("ERROR: Failed to submit trace %ld\n", file->first + t + 1);
+				return -1;
+			}
+		}
+		tracePipeClose(&pipe);
+	}
+
+	// Wait for every simulation
+	if( sweepFinish(&sweep) != 0 ) {
+		printf("ERROR: Failed to simulate traces, or save anomalous traces\n");
+		return -1;
+	}
+	progressFinish(&progress);
+
+	// Report how much of the sweep the result cache saved, and how often each
+	// algorithm showed Belady's anomaly
+	if( options->cacheFile != NULL ) {
+		if( !options->quiet ) {
+			fprintf(stderr, "Result cache: %ld cells reused, %ld simulated\n",
+				(long)atomic_load(&cache.hits), (long)atomic_load(&cache.misses));
+		}
+		if( resultCacheClose(&cache) != 0 ) {
+			printf("ERROR: Failed to write result cache %s\n", options->cacheFile);
+			return -1;
+		}
+	}
+	if( options->beladyDir != NULL ) {
+		for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+			fprintf(stderr, "Belady's anomaly: %s in %ld of %ld traces (%.4f%%), at %ld wss\n",
+				policies[policy].name, belady.traces[policy], belady.checked,
+				belady.checked > 0 ? 100.0 * belady.traces[policy] / belady.checked : 0.0,
+				belady.cells[policy]);
+		}
+	}
+
+	// Get current time, and generate file name
+	time_t r;
+	time(&r);
+	char fileName[32];
+	strftime(fileName, sizeof(fileName), "Pgm3_%m-%d-%Y_%H:%M:%S.csv", localtime(&r));
+
+	// Create file
+	FILE *file = fopen(fileName, "w");
+	if( file == NULL ) {
+		printf("ERROR: Failed to create file %s\n", fileName);
+		return -1;
+	}
+
+	// Output results header to file
+	fprintf(file, "file,traces,wss");
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		fprintf(file, ",%s", policies[policy].name);
+	}
+	for( policy = 0; dirty && policy < POLICY_COUNT; policy++ ) {
+		fprintf(file, ",%s_clean,%s_dirty,%s_io", policies[policy].name, policies[policy].name, policies[policy].name);
+	}
+	fprintf(file, "\n");
+
+	// Output the average faults of each file, in name order
+	for( i = 0; i < (int)matches.gl_pathc; i++ ) {
+		for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+			fprintf(file, "%s,%ld,%d", files[i].path, files[i].traces, wss);
+			for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+				faults = 0;
+				for( k = 0; k < files[i].traces; k++ ) {
+					faults += traceFaults[files[i].first + k].faults[policy][wss];
+				}
+				fprintf(file, ",%ld", files[i].traces > 0 ? faults / files[i].traces : 0);
+			}
+			for( policy = 0; dirty && policy < POLICY_COUNT; policy++ ) {
+				faults = writebacks = fills = 0;
+				for( k = 0; k < files[i].traces; k++ ) {
+					faults += traceFaults[files[i].first + k].faults[policy][wss];
+					writebacks += traceFaults[files[i].first + k].writebacks[policy][wss];
+					fills += traceFaults[files[i].first + k].fills[policy][wss];
+				}
+				if( files[i].traces > 0 ) {
+					writeDirty(file, faults, writebacks, fills, files[i].traces, options->pageShift);
+				}
+				else {
+					fprintf(file, ",0,0,0");
+				}
+			}
+			fprintf(file, "\n");
+		}
+	}
+	fclose(file);
+
+	checkpointFree(&checkpoint);
+	free(traceFaults);
+	free(order);
+	free(files);
+	globfree(&matches);
+	return 0;
+}
+
+/***********************************************************************************
+ * int compareFiles( const void *a, const void *b )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Orders the indices of trace files of sortFiles by decreasing size,
+ *					then by name, for qsort.
+ *
+ * Parameters:
+ * 	a				I/P	const void *	The first index
+ * 	b				I/P	const void *	The second index
+ * 	compareFiles	O/P	int				Negative, 0 or positive as a comes first,
+ *										ties or comes last
+ ***********************************************************************************/
+int compareFiles( const void *a, const void *b ) {
+	const TraceDirFile *x = &sortFiles[*(const long*)a], *y = &sortFiles[*(const long*)b];
+	if( x->size != y->size ) {
+		return x->size > y->size ? -1 : 1;
+	}
+	return strcmp(x->path, y->path);
+}
+
+/***********************************************************************************
+ * Trace *readTrace( TracePipe *pipe, long trace, long number, int hugePages )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Copies the next trace of a trace pipe into a new unsealed trace, as
+ *					the chunks decoded ahead by its reader arrive, with its
+ *					writes if the file records them.
+ *
+ * Parameters:
+ * 	pipe		I/O	TracePipe *	The pipe to take the chunks of the trace from
+ * 	trace		I/P	long		The index of the trace within its trace file
+ * 	number		I/P	long		The number of the trace within the sweep
+ * 	hugePages	I/P	int			Non-zero to back the trace with huge pages
+ * 	readTrace	O/P	Trace *		The trace, or NULL on failure
+ ***********************************************************************************/
+Trace *readTrace( TracePipe *pipe, long trace, long number, int hugePages ) {
+	const PipeChunk *chunk;
+	Trace *created;
+	PageKey *data;
+	uint64_t *writes;
+	int last;
+
+	// Get the length of the trace from its first chunk
+	chunk = tracePipeTake(pipe);
+	if( chunk->count < 0 || chunk->trace != trace ) {
+		return NULL;
+	}
+	created = traceCreate(number, chunk->length, hugePages, &data);
+	if( created == NULL ) {
+		return NULL;
+	}
+	writes = NULL;
+	if( pipe->reader.flags & TRACE_FLAG_WRITES ) {
+		writes = traceAddWrites(created);
+		if( writes == NULL ) {
+			traceRelease(created);
+			return NULL;
+		}
+	}
+
+	// Copy every chunk of the trace; chunks start on a word of the write bitmap
+	for( ;; ) {
+		memcpy(data + chunk->offset, chunk->pages, chunk->count * sizeof(PageKey));
+		if( writes != NULL ) {
+			memcpy(writes + chunk->offset / BITMAP_BITS, chunk->writes,
+				BITMAP_WORDS(chunk->count) * sizeof(uint64_t));
+		}
+		// The chunk is the reader's again once released
+		last = chunk->offset + chunk->count == created->length;
+		tracePipeRelease(pipe);
+		if( last ) {
+			return created;
+		}
+		chunk = tracePipeTake(pipe);
+		if( chunk->count < 0 || chunk->trace != trace ) {
+			traceRelease(created);
+			return NULL;
+		}
+	}
+}
+
+/***********************************************************************************
+ * char *checkpointSource( const Options *options, const char *origin )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Describes the origin of the traces of a checkpoint together with
+ *					every option that changes their results: the page size and
+ *					format of text traces, the SHARDS sampling, lazy generation,
+ *					the writes drawn, write-back accounting and the Belady
+ *					counts. A checkpoint is only resumed by a run with the same
+ *					description.
+ *
+ * Parameters:
+ * 	options				I/P	const Options *	The command line options
+ * 	origin				I/P	const char *	The workload or trace files of the traces
+ * 	checkpointSource	O/P	char *			The description, to be freed, or NULL
+ *											on failure
+ ***********************************************************************************/
+char *checkpointSource( const Options *options, const char *origin ) {
+	char *source = malloc(strlen(origin) + 160);
+	if( source != NULL ) {
+		sprintf(source, "%s;page=%d;format=%d;shards=%.17g/%ld;lazy=%d;writes=%.17g;dirty=%d;belady=%d",
+				origin, options->pageShift, options->format, options->engine.shards.rate,
+				options->engine.shards.max, options->lazy, options->writes, options->dirty,
+				options->beladyDir != NULL);
+	}
+	return source;
+}
+
+/***********************************************************************************
+ * void writeDirty( FILE *file, long faults, long writebacks, long fills,
+ *				long traces, int pageShift )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Writes the write-back columns of one cell of a results file: the
+ *					page reads that write nothing back, the evictions of dirty
+ *					pages, and the bytes read and written back, all averaged per
+ *					trace. Filling an empty frame is no fault but still reads
+ *					its page, so the fills count as clean reads and as I/O. The
+ *					bytes are whole, but beyond 2^53 only as exact as a double.
+ *
+ * Parameters:
+ * 	file		I/O	FILE *	The results file
+ * 	faults		I/P	long	The faults of the cell over every trace
+ * 	writebacks	I/P	long	The evictions of dirty pages over every trace
+ * 	fills		I/P	long	The fills of empty frames over every trace
+ * 	traces		I/P	long	The number of traces, at least 1
+ * 	pageShift	I/P	int		log2 of the page size
+ ***********************************************************************************/
+void writeDirty( FILE *file, long faults, long writebacks, long fills, long traces, int pageShift ) {
+	// Pages per trace are scaled to bytes in double, which no page size overflows
+	fprintf(file, ",%ld,%ld,%.0f", (faults - writebacks + fills) / traces, writebacks / traces,
+		floor(ldexp((double)(faults + fills + writebacks) / traces, pageShift)));
+}
+
+/***********************************************************************************
+ * void usage( const char *program )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prints the command line usage of the program to stderr.
+ *
+ * Parameters:
+ * 	program	I/P	const char *	The name the program was invoked with
+ ***********************************************************************************/
+void usage( const char *program ) {
+	fprintf(stderr, "Usage: %s [options]\n", program);
+	fprintf(stderr, "  -q, --quiet\t\tDo not print progress reports\n");
+	fprintf(stderr, "  -t, --trace FILE\tReplay the traces of a trace file, or a text file of one page\n");
+	fprintf(stderr, "\t\t\tper line, in decimal or 0x hex (byte addresses if its first\n");
+	fprintf(stderr, "\t\t\tline is \"%s\")\n", TEXT_TRACE_ADDRESSES);
+	fprintf(stderr, "  -d, --trace-dir PATH\tReplay the trace files (*.vmt) of a directory, or matching a\n");
+	fprintf(stderr, "\t\t\tglob pattern, at once, writing the average faults of each file\n");
+	fprintf(stderr, "  -f, --format FORMAT\tFormat of text trace files: plain (default), lackey (valgrind\n");
+	fprintf(stderr, "\t\t\t--tool=lackey --trace-mem=yes), dinero (DineroIV din) or perf\n");
+	fprintf(stderr, "\t\t\t(perf script of memory samples), all but plain of addresses\n");
+	fprintf(stderr, "  -w, --write-trace FILE\tSave every simulated trace to a trace file\n");
+	fprintf(stderr, "  -A, --write-addresses\tWrite the byte address of the first byte of each page, for\n");
+	fprintf(stderr, "\t\t\tthe page size of --page-size, instead of pages\n");
+	fprintf(stderr, "  -z, --compress\tCompress the blocks of written trace files\n");
+	fprintf(stderr, "  -H, --huge-pages\tBack shared traces with huge pages\n");
+	fprintf(stderr, "  -j, --threads N\tNumber of worker threads per process (default one per CPU)\n");
+	fprintf(stderr, "  -P, --processes N\tNumber of worker processes, each simulating a shard of traces\n");
+	fprintf(stderr, "  -c, --checkpoint FILE\tPeriodically save progress to a checkpoint file\n");
+	fprintf(stderr, "  -r, --resume\t\tResume from the checkpoint file, skipping finished traces\n");
+	fprintf(stderr, "  -C, --cache FILE\tReuse and record results of every trace, policy and wss\n");
+	fprintf(stderr, "  -K, --no-kernels\tRun the generic algorithms instead of the kernels specialized\n");
+	fprintf(stderr, "\t\t\tfor each wss from %d to %d and the batched engines that run\n", KERNEL_WSS_LOWER, KERNEL_WSS_UPPER);
+	fprintf(stderr, "\t\t\tevery wss in one pass\n");
+	fprintf(stderr, "  -B, --belady DIR\tSave every trace whose faults grow with its wss to DIR, and\n");
+	fprintf(stderr, "\t\t\treport how often each algorithm shows Belady's anomaly\n");
+	fprintf(stderr, "  -S, --shards SPEC\tEstimate LRU with SHARDS from a sample of pages, with SPEC\n");
+	fprintf(stderr, "\t\t\trate=R (fixed rate), max=N (at most N pages, rate=R initially)\n");
+	fprintf(stderr, "\t\t\tor error=E (enough pages to keep the error within E)\n");
+	fprintf(stderr, "  -m, --stream[=SPEC]\tStream the trace file through Counter Stacks, printing the\n");
+	fprintf(stderr, "\t\t\testimated LRU faults so far as CSV every N references, with\n");
+	fprintf(stderr, "\t\t\tSPEC step=N,prune=D,precision=P,every=N (default %d,%g,%d,%d)\n",
+		COUNTER_STACK_STEP, COUNTER_STACK_PRUNE, COUNTER_STACK_PRECISION, COUNTER_STACK_EVERY);
+	fprintf(stderr, "  -L, --lazy\t\tPull the references of generated traces on demand from a\n");
+	fprintf(stderr, "\t\t\tcounter-based generator instead of storing traces\n");
+	fprintf(stderr, "  -W, --writes F\tMake a fraction F of generated references writes, and report\n");
+	fprintf(stderr, "\t\t\tclean reads, dirty evictions and I/O bytes per algorithm, as\n");
+	fprintf(stderr, "\t\t\tfor trace files recording writes\n");
+	fprintf(stderr, "  -g, --workload SPEC\tWorkload of generated traces (default regions), one of\n");
+	fprintf(stderr, "\t\t\tregions, uniform:pages=N, zipf:pages=N,skew=S, scan,\n");
+	fprintf(stderr, "\t\t\tloop:pages=N, hotcold:pages=N,hot=F,prob=P, plus offset=K,\n");
+	fprintf(stderr, "\t\t\tor mix:A*w+B*w... or phase:L:A+B...\n");
+	fprintf(stderr, "  -s, --seed N\t\tSeed of the random generator (default current time)\n");
+	fprintf(stderr, "  -n, --traces N\tNumber of traces to generate (default %d)\n", TRACES);
+	fprintf(stderr, "  -l, --length N\tNumber of references per generated trace (default %d)\n", TRACE_LENGTH);
+	fprintf(stderr, "  -p, --page-size SIZE\tPage size of address traces: 4K, 2M, 1G... (default 4K)\n");
+	fprintf(stderr, "  -h, --help\t\tPrint this message\n");
+}
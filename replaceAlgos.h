@@ -0,0 +1,85 @@
+/***********************************************************************************
+ * File: replaceAlgos.h
+ * Author: Justin Hardy
+ * Description: Simulation constants and the replacement algorithms shared by the
+ *					sweep modules. See replaceAlgos.c for implementation and
+ *					details.
+ ***********************************************************************************/
+
+#ifndef REPLACEALGOS_H
+#define REPLACEALGOS_H
+
+#include <stdint.h>
+#include "pages.h"
+#include "arena.h"
+
+// Simulation constants
+#define TRACES		1000		// The number of traces to be performed
+#define TRACE_LENGTH	1000		// The number of page references in a generated trace
+#define SET_SIZE_LOWER	4		// The lower bound of the set sizes to test
+#define SET_SIZE_UPPER	20		// The upper bound of the set sizes to test
+#define SET_SIZES	(SET_SIZE_UPPER - SET_SIZE_LOWER + 1)	// The number of set sizes to test
+#define POLICY_COUNT	3		// The number of replacement algorithms
+
+// Sampling of approximate engines, see shards.h
+typedef struct shards {
+	double rate;				// Initial sampling rate, 0 to run the exact engines instead
+	long max;					// Most pages sampled at once, lowering the rate as needed;
+								// 0 for a fixed rate
+} Shards;
+
+// Settings of the engines simulating the policies, chosen by the caller of a
+// sweep and handed down to every engine it runs
+typedef struct engineConfig {
+	int kernels;				// Non-zero to run the specialized kernels and batched engines
+	Shards shards;				// Sampling of approximate engines; none by default
+	int threads;				// Threads splitting one trace into chunks or segments; 1 for
+								// a serial pass
+} EngineConfig;
+
+// A replacement algorithm, returning the page faults of a trace for a wss, or
+// -1 if its state could not be allocated from the arena
+typedef long (*PolicyFunction)(int,const PageKey[],long,Arena*);
+
+// A replacement algorithm specialized for one wss, returning the page faults
+// of a trace. Kernels keep their frames on the stack and need no arena.
+typedef long (*PolicyKernel)(const PageKey[],long);
+
+// A replacement algorithm run for every wss from a lower to an upper bound in
+// one pass over a trace, storing the page faults of each wss by index. Returns
+// 0, or -1 if its state could not be allocated from the arena.
+typedef int (*PolicyBatch)(int,int,const PageKey[],long,long[],const EngineConfig*,Arena*);
+
+// A batched engine pulling a given number of references from a source on
+// demand, PAGE_SOURCE_BLOCK at a time, instead of reading a whole trace
+typedef int (*PolicyLazy)(int,int,const PageSource*,long,long[],Arena*);
+
+// A replacement algorithm for one wss on a trace telling writes from reads,
+// given as a bitmap, returning the page faults and storing the evictions of
+// dirty pages, or -1 if its state could not be allocated from the arena
+typedef long (*PolicyDirty)(int,const PageKey[],const uint64_t[],long,long*,long*,Arena*);
+
+// A replacement algorithm and the name of its results column. The version must
+// be bumped whenever the faults the algorithm counts change, so that cached
+// results of the old version are never reused.
+typedef struct policy {
+	const char *name;			// Column name of the algorithm
+	int version;				// Version of the algorithm's results
+	PolicyFunction run;			// The algorithm itself
+	const PolicyKernel *kernels;	// Specialized kernels indexed by wss, see kernels.h
+	PolicyBatch batch;			// Batched engine for a range of wss, see batch.h; NULL if none
+	PolicyBatch estimate;		// Approximate engine for a range of wss, see shards.h; NULL if none
+	PolicyLazy lazy;			// Batched engine pulling from a source, see batch.h; NULL if none
+	PolicyDirty dirty;			// Engine counting write-backs, see dirty.h
+} Policy;
+
+// The replacement algorithms, in results column order
+extern const Policy policies[POLICY_COUNT];
+
+long LRU(int,const PageKey[],long,Arena*);		// Performs LRU Algorithm
+long FIFO(int,const PageKey[],long,Arena*);		// Performs FIFO Algorithm
+long Clock(int,const PageKey[],long,Arena*);	// Performs Clock Algorithm
+int arrayContains(const PageKey[],const uint64_t[],int,PageKey);	// Gets if an element is contained in an array
+int getIndex(const PageKey[],const uint64_t[],int,PageKey);		// Gets the index of an element in an array
+
+#endif
@@ -0,0 +1,360 @@
+/***********************************************************************************
+ * File: resultcache.c
+ * Author: Justin Hardy
+ * Procedures:
+ * resultCacheOpen		- Opens or creates a cache file and loads its results.
+ * resultCacheLookup	- Looks up the result of a (trace, policy, wss) cell.
+ * resultCacheStore		- Records the result of a (trace, policy, wss) cell.
+ * resultCacheClose		- Appends pending results and closes a cache file.
+ * policyKey			- Computes the key of a policy's name and version.
+ * insertEntry			- Inserts a result into the table of a cache.
+ * cellSlot				- Computes the home slot of a cell in the table.
+ * flushPending			- Appends the pending records to the cache file.
+ *
+ * A cache file is a plain sequence of 32-byte records (all integers
+ * little-endian): u64 trace hash, u64 policy key, u32 wss, u32 reserved,
+ * i64 faults. Records are only ever appended, each batch by a single write to
+ * a file opened with O_APPEND under an exclusive flock, so any number of
+ * processes may share a cache file. Opening a cache file cuts off, under the
+ * same lock, a partial trailing record left by a killed run, so that records
+ * appended next stay aligned. Since the policy key covers the policy's
+ * version, bumping a version invalidates its old results without touching the
+ * file.
+ ***********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "resultcache.h"
+
+// Result cache table constants
+#define CACHE_INITIAL_CAPACITY	1024	// Initial number of slots (a power of two)
+
+static uint64_t policyKey(const Policy*);					// Keys a policy
+static int insertEntry(ResultCache*,const CacheEntry*);		// Inserts a result
+static size_t cellSlot(uint64_t,uint64_t,uint32_t,size_t);	// Gets the home slot of a cell
+static void flushPending(ResultCache*);						// Appends pending records
+
+/***********************************************************************************
+ * int resultCacheOpen( ResultCache *cache, const char *path )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Opens the cache file at the given path, creating it if needed,
+ *					loads every result it holds, and cuts off a partial trailing
+ *					record, all under an exclusive lock of the file.
+ *
+ * Parameters:
+ * 	cache			O/P	ResultCache *	The cache to initialize
+ * 	path			I/P	const char *	The path of the cache file
+ * 	resultCacheOpen	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int resultCacheOpen( ResultCache *cache, const char *path ) {
+	unsigned char record[CACHE_RECORD_BYTES];
+	CacheEntry entry;
+	struct stat status;
+	int policy, i;
+
+	// Prepare empty table
+	memset(cache, 0, sizeof(*cache));
+	cache->capacity = CACHE_INITIAL_CAPACITY;
+	cache->entries = calloc(cache->capacity, sizeof(CacheEntry));
+	if( cache->entries == NULL ) {
+		return -1;
+	}
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		cache->policyKeys[policy] = policyKey(&policies[policy]);
+	}
+	atomic_init(&cache->hits, 0);
+	atomic_init(&cache->misses, 0);
+
+	// Open file for appending; reading starts at the beginning regardless
+	cache->file = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+	if( cache->file < 0 ) {
+		free(cache->entries);
+		return -1;
+	}
+
+	// Load every complete record
+	FILE *in = NULL;
+	if( flock(cache->file, LOCK_EX) != 0 || (in = fdopen(dup(cache->file), "rb")) == NULL ) {
+		close(cache->file);
+		free(cache->entries);
+		return -1;
+	}
+	while( fread(record, sizeof(record), 1, in) == 1 ) {
+		entry.trace = entry.policy = 0;
+		for( i = 0; i < 8; i++ ) {
+			entry.trace |= (uint64_t)record[i] << (8 * i);
+			entry.policy |= (uint64_t)record[8 + i] << (8 * i);
+		}
+		entry.wss = record[16] | record[17] << 8 | record[18] << 16 | (uint32_t)record[19] << 24;
+		uint64_t faults = 0;
+		for( i = 0; i < 8; i++ ) {
+			faults |= (uint64_t)record[24 + i] << (8 * i);
+		}
+		entry.faults = (long)faults;
+		if( entry.wss != 0 && insertEntry(cache, &entry) != 0 ) {
+			fclose(in);
+			close(cache->file);
+			free(cache->entries);
+			return -1;
+		}
+	}
+	fclose(in);
+
+	// Cut off a partial trailing record
+	if( fstat(cache->file, &status) != 0 ||
+		(status.st_size % CACHE_RECORD_BYTES != 0 &&
+		 ftruncate(cache->file, status.st_size - status.st_size % CACHE_RECORD_BYTES) != 0) ) {
+		close(cache->file);
+		free(cache->entries);
+		return -1;
+	}
+	flock(cache->file, LOCK_UN);
+
+	pthread_mutex_init(&cache->lock, NULL);
+	return 0;
+}
+
+/***********************************************************************************
+ * int resultCacheLookup( ResultCache *cache, uint64_t trace, int policy, int wss,
+ *				long *faults )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Looks up the page faults of a policy for a wss on a trace.
+ *
+ * Parameters:
+ * 	cache				I/O	ResultCache *	The cache to look in
+ * 	trace				I/P	uint64_t		The hash of the trace
+ * 	policy				I/P	int				The index of the policy in policies[]
+ * 	wss					I/P	int				The working set size
+ * 	faults				O/P	long *			The cached page faults, if found
+ * 	resultCacheLookup	O/P	int				1 if found, 0 if not
+ ***********************************************************************************/
+int resultCacheLookup( ResultCache *cache, uint64_t trace, int policy, int wss, long *faults ) {
+	uint64_t key = cache->policyKeys[policy];
+	int found = 0;
+
+	pthread_mutex_lock(&cache->lock);
+
+	// Probe from the slot of the cell until the cell or an empty slot
+	size_t mask = cache->capacity - 1;
+	size_t slot = cellSlot(trace, key, (uint32_t)wss, mask);
+	while( cache->entries[slot].wss != 0 ) {
+		if( cache->entries[slot].trace == trace && cache->entries[slot].policy == key &&
+			cache->entries[slot].wss == (uint32_t)wss ) {
+			*faults = cache->entries[slot].faults;
+			found = 1;
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+
+	atomic_fetch_add_explicit(found ? &cache->hits : &cache->misses, 1, memory_order_relaxed);
+	return found;
+}
+
+/***********************************************************************************
+ * void resultCacheStore( ResultCache *cache, uint64_t trace, int policy, int wss,
+ *				long faults )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Records the page faults of a policy for a wss on a trace, both in
+ *					the table and, in batches, in the cache file. A result that
+ *					cannot be recorded is simply not cached.
+ *
+ * Parameters:
+ * 	cache	I/O	ResultCache *	The cache to record in
+ * 	trace	I/P	uint64_t		The hash of the trace
+ * 	policy	I/P	int				The index of the policy in policies[]
+ * 	wss		I/P	int				The working set size
+ * 	faults	I/P	long			The page faults of the simulation
+ ***********************************************************************************/
+void resultCacheStore( ResultCache *cache, uint64_t trace, int policy, int wss, long faults ) {
+	CacheEntry entry = { trace, cache->policyKeys[policy], (uint32_t)wss, faults };
+	int i;
+
+	pthread_mutex_lock(&cache->lock);
+
+	// Record in table
+	insertEntry(cache, &entry);
+
+	// Queue record for the cache file
+	unsigned char *record = cache->pending + cache->pendingRecords * CACHE_RECORD_BYTES;
+	for( i = 0; i < 8; i++ ) {
+		record[i] = (unsigned char)(entry.trace >> (8 * i));
+		record[8 + i] = (unsigned char)(entry.policy >> (8 * i));
+		record[24 + i] = (unsigned char)((uint64_t)entry.faults >> (8 * i));
+	}
+	for( i = 0; i < 4; i++ ) {
+		record[16 + i] = (unsigned char)(entry.wss >> (8 * i));
+		record[20 + i] = 0;
+	}
+	if( ++cache->pendingRecords == CACHE_PENDING_RECORDS ) {
+		flushPending(cache);
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/***********************************************************************************
+ * int resultCacheClose( ResultCache *cache )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Appends every pending result to the cache file, then closes it
+ *					and frees the table.
+ *
+ * Parameters:
+ * 	cache				I/O	ResultCache *	The cache to close
+ * 	resultCacheClose	O/P	int				0 on success, -1 if results were lost
+ ***********************************************************************************/
+int resultCacheClose( ResultCache *cache ) {
+	flushPending(cache);
+	if( close(cache->file) != 0 ) {
+		cache->failed = 1;
+	}
+	free(cache->entries);
+	pthread_mutex_destroy(&cache->lock);
+	return cache->failed ? -1 : 0;
+}
+
+/***********************************************************************************
+ * uint64_t policyKey( const Policy *policy )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Computes the key of a policy as the FNV-1a hash of its name
+ *					followed by its version.
+ *
+ * Parameters:
+ * 	policy		I/P	const Policy *	The policy to key
+ * 	policyKey	O/P	uint64_t		The key of the policy
+ ***********************************************************************************/
+static uint64_t policyKey( const Policy *policy ) {
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	const char *c;
+	int i;
+	for( c = policy->name; *c != '\0'; c++ ) {
+		hash = (hash ^ (unsigned char)*c) * 0x100000001B3ULL;
+	}
+	hash *= 0x100000001B3ULL;		// Terminating zero byte
+	for( i = 0; i < 4; i++ ) {
+		hash = (hash ^ ((unsigned)policy->version >> (8 * i) & 0xFF)) * 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+/***********************************************************************************
+ * int insertEntry( ResultCache *cache, const CacheEntry *entry )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Inserts a result into the table of a cache, replacing any result
+ *					of the same cell, and doubling the table when it becomes half
+ *					full.
+ *
+ * Parameters:
+ * 	cache		I/O	ResultCache *		The cache to insert into
+ * 	entry		I/P	const CacheEntry *	The result to insert
+ * 	insertEntry	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+static int insertEntry( ResultCache *cache, const CacheEntry *entry ) {
+	size_t i, mask, slot;
+
+	// Grow table if half full
+	if( 2 * (cache->count + 1) > cache->capacity ) {
+		CacheEntry *old = cache->entries;
+		size_t oldCapacity = cache->capacity;
+		cache->entries = calloc(2 * oldCapacity, sizeof(CacheEntry));
+		if( cache->entries == NULL ) {
+			cache->entries = old;
+			return -1;
+		}
+		cache->capacity = 2 * oldCapacity;
+		cache->count = 0;
+		for( i = 0; i < oldCapacity; i++ ) {
+			if( old[i].wss != 0 ) {
+				insertEntry(cache, &old[i]);
+			}
+		}
+		free(old);
+	}
+
+	// Probe from the slot of the cell until the cell or an empty slot
+	mask = cache->capacity - 1;
+	slot = cellSlot(entry->trace, entry->policy, entry->wss, mask);
+	while( cache->entries[slot].wss != 0 ) {
+		if( cache->entries[slot].trace == entry->trace && cache->entries[slot].policy == entry->policy &&
+			cache->entries[slot].wss == entry->wss ) {
+			cache->entries[slot].faults = entry->faults;
+			return 0;
+		}
+		slot = (slot + 1) & mask;
+	}
+	cache->entries[slot] = *entry;
+	cache->count++;
+	return 0;
+}
+
+/***********************************************************************************
+ * size_t cellSlot( uint64_t trace, uint64_t policy, uint32_t wss, size_t mask )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Computes the slot at which probing for a cell starts. The cells
+ *					of one trace are spread over the table so that they do not
+ *					form one long probe sequence.
+ *
+ * Parameters:
+ * 	trace		I/P	uint64_t	The hash of the trace
+ * 	policy		I/P	uint64_t	The key of the policy
+ * 	wss			I/P	uint32_t	The working set size
+ * 	mask		I/P	size_t		The capacity of the table minus one
+ * 	cellSlot	O/P	size_t		The home slot of the cell
+ ***********************************************************************************/
+static size_t cellSlot( uint64_t trace, uint64_t policy, uint32_t wss, size_t mask ) {
+	uint64_t hash = (trace ^ policy) + wss * 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ (hash >> 31)) * 0xBF58476D1CE4E5B9ULL;
+	return (size_t)(hash >> 32) & mask;
+}
+
+/***********************************************************************************
+ * void flushPending( ResultCache *cache )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Appends the pending records of a cache to its file in a single
+ *					write under an exclusive lock of the file, so that records of
+ *					processes sharing the file never interleave. A write cut short
+ *					is undone, so that no partial record is left behind, and ends
+ *					the appending of results.
+ *
+ * Parameters:
+ * 	cache	I/O	ResultCache *	The cache whose records are appended
+ ***********************************************************************************/
+static void flushPending( ResultCache *cache ) {
+	size_t bytes = (size_t)cache->pendingRecords * CACHE_RECORD_BYTES;
+	struct stat status;
+
+	// Once a write failed, results are no longer appended
+	cache->pendingRecords = 0;
+	if( bytes == 0 || cache->failed ) {
+		return;
+	}
+	if( flock(cache->file, LOCK_EX) != 0 ) {
+		cache->failed = 1;
+		return;
+	}
+	if( fstat(cache->file, &status) != 0 ) {
+		cache->failed = 1;
+	}
+	else if( write(cache->file, cache->pending, bytes) != (ssize_t)bytes ) {
+		cache->failed = 1;
+		if( ftruncate(cache->file, status.st_size) != 0 ) {
+			// The partial record is cut off when the file is next opened
+		}
+	}
+	flock(cache->file, LOCK_UN);
+}
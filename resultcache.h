@@ -0,0 +1,50 @@
+/***********************************************************************************
+ * File: resultcache.h
+ * Author: Justin Hardy
+ * Description: Declarations for the on-disk cache of simulation results, which
+ *					lets reruns skip every (trace, policy, wss) cell already
+ *					simulated. See resultcache.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "replaceAlgos.h"
+
+// Result cache constants
+#define CACHE_RECORD_BYTES		32		// Size of one record of a cache file
+#define CACHE_PENDING_RECORDS	128		// Records buffered before being appended
+
+// One cached result
+typedef struct cacheEntry {
+	uint64_t trace;				// Hash of the trace's content
+	uint64_t policy;			// Key of the policy's name and version
+	uint32_t wss;				// Working set size, 0 if the slot is empty
+	long faults;				// Page faults of the simulation
+} CacheEntry;
+
+// Result cache state
+typedef struct resultCache {
+	int file;					// Descriptor of the cache file, opened for appending
+	CacheEntry *entries;		// Open addressing table of cached results
+	size_t capacity;			// Number of slots of the table (a power of two)
+	size_t count;				// Number of cached results
+	unsigned char pending[CACHE_PENDING_RECORDS * CACHE_RECORD_BYTES];	// Records not yet appended
+	int pendingRecords;			// Number of records not yet appended
+	int failed;					// Non-zero if records could not be appended
+	uint64_t policyKeys[POLICY_COUNT];	// Key of every policy in policies[]
+	atomic_long hits;			// Number of lookups that found a result
+	atomic_long misses;			// Number of lookups that found nothing
+	pthread_mutex_t lock;		// Protects the table and the pending records
+} ResultCache;
+
+int resultCacheOpen(ResultCache*,const char*);					// Opens or creates a cache file
+int resultCacheLookup(ResultCache*,uint64_t,int,int,long*);		// Looks up a result
+void resultCacheStore(ResultCache*,uint64_t,int,int,long);		// Records a result
+int resultCacheClose(ResultCache*);								// Appends pending results and closes
+
+#endif
@@ -0,0 +1,448 @@
+/***********************************************************************************
+ * File: scheduler.c
+ * Author: Justin Hardy
+ * Procedures:
+ * schedulerStart	- Starts the worker threads of a scheduler.
+ * schedulerSubmit	- Submits a task to a scheduler from any thread.
+ * schedulerSpawn	- Spawns a task on the deque of the calling worker.
+ * schedulerWait	- Waits until every submitted and spawned task has finished.
+ * schedulerStop	- Waits for every task, then stops the worker threads.
+ * workerMain		- Runs tasks on a worker thread until the scheduler stops.
+ * findTask			- Finds the next task for a worker to run.
+ * finishTask		- Records that a task has finished.
+ * wakeWorker		- Wakes a sleeping worker, if there is one.
+ * hasWork			- Determines if any task is waiting to be run.
+ * dequePush		- Pushes a task at the bottom of a deque (owner only).
+ * dequeTake		- Takes the newest task from a deque (owner only).
+ * dequeSteal		- Steals the oldest task from a deque (any worker).
+ *
+ * Each worker owns a Chase-Lev deque. Tasks spawned by a task go on its worker's
+ * deque, which the worker empties newest first; idle workers steal the oldest
+ * tasks of randomly chosen victims, so expensive and cheap tasks even out across
+ * workers without any central lock. Tasks submitted from outside the workers go
+ * through a shared, locked queue.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include "scheduler.h"
+
+static void *workerMain(void*);						// Worker thread body
+static Task *findTask(Scheduler*,Deque*,uint32_t*);	// Finds a task to run
+static void finishTask(Scheduler*);					// Records a finished task
+static void wakeWorker(Scheduler*);					// Wakes a sleeping worker
+static int hasWork(Scheduler*);						// Checks for runnable tasks
+static int dequePush(Deque*,Task*);					// Pushes a task (owner)
+static Task *dequeTake(Deque*);						// Takes a task (owner)
+static Task *dequeSteal(Deque*);					// Steals a task (thief)
+
+/***********************************************************************************
+ * int schedulerStart( Scheduler *scheduler, int workers )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Starts the worker threads of a scheduler.
+ *
+ * Parameters:
+ * 	scheduler		O/P	Scheduler *	The scheduler to start
+ * 	workers			I/P	int			The number of worker threads
+ * 	schedulerStart	O/P	int			0 on success, -1 on failure
+ ***********************************************************************************/
+int schedulerStart( Scheduler *scheduler, int workers ) {
+	int i;
+
+	// Initialize shared state
+	scheduler->workers = workers;
+	scheduler->head = scheduler->tail = NULL;
+	atomic_init(&scheduler->submitted, 0);
+	atomic_init(&scheduler->pending, 0);
+	atomic_init(&scheduler->sleepers, 0);
+	atomic_init(&scheduler->stop, 0);
+	pthread_mutex_init(&scheduler->lock, NULL);
+	pthread_cond_init(&scheduler->wake, NULL);
+	pthread_cond_init(&scheduler->done, NULL);
+
+	// Allocate one deque per worker
+	scheduler->threads = malloc(workers * sizeof(pthread_t));
+	scheduler->deques = aligned_alloc(64, workers * sizeof(Deque));
+	if( scheduler->threads == NULL || scheduler->deques == NULL ) {
+		free(scheduler->threads);
+		free(scheduler->deques);
+		return -1;
+	}
+	for( i = 0; i < workers; i++ ) {
+		atomic_init(&scheduler->deques[i].top, 0);
+		atomic_init(&scheduler->deques[i].bottom, 0);
+		scheduler->deques[i].scheduler = scheduler;
+		scheduler->deques[i].worker = i;
+	}
+
+	// Start workers
+	for( i = 0; i < workers; i++ ) {
+		if( pthread_create(&scheduler->threads[i], NULL, workerMain, &scheduler->deques[i]) != 0 ) {
+			scheduler->workers = i;
+			schedulerStop(scheduler);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * void schedulerSubmit( Scheduler *scheduler, Task *task )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Submits a task from any thread, through the shared queue.
+ *
+ * Parameters:
+ * 	scheduler	I/O	Scheduler *	The scheduler to run the task
+ * 	task		I/P	Task *		The task to run
+ ***********************************************************************************/
+void schedulerSubmit( Scheduler *scheduler, Task *task ) {
+	// Count the task before anyone can finish it
+	atomic_fetch_add(&scheduler->pending, 1);
+
+	// Append task to the shared queue
+	task->next = NULL;
+	pthread_mutex_lock(&scheduler->lock);
+	if( scheduler->tail != NULL ) {
+		scheduler->tail->next = task;
+	}
+	else {
+		scheduler->head = task;
+	}
+	scheduler->tail = task;
+	atomic_fetch_add(&scheduler->submitted, 1);
+
+	// Wake a worker to run it
+	if( atomic_load(&scheduler->sleepers) > 0 ) {
+		pthread_cond_signal(&scheduler->wake);
+	}
+	pthread_mutex_unlock(&scheduler->lock);
+}
+
+/***********************************************************************************
+ * void schedulerSpawn( Scheduler *scheduler, int worker, Task *task )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Spawns a task from a task running on a given worker, by pushing it
+ *					on the worker's own deque. If the deque is full, the task is
+ *					run immediately instead.
+ *
+ * Parameters:
+ * 	scheduler	I/O	Scheduler *	The scheduler to run the task
+ * 	worker		I/P	int			The number of the calling worker
+ * 	task		I/P	Task *		The task to run
+ ***********************************************************************************/
+void schedulerSpawn( Scheduler *scheduler, int worker, Task *task ) {
+	// Count the task before anyone can finish it
+	atomic_fetch_add(&scheduler->pending, 1);
+
+	// Run the task now if the deque is full
+	if( !dequePush(&scheduler->deques[worker], task) ) {
+		task->run(task, worker);
+		finishTask(scheduler);
+		return;
+	}
+
+	// Let a sleeping worker steal it
+	wakeWorker(scheduler);
+}
+
+/***********************************************************************************
+ * void schedulerWait( Scheduler *scheduler )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Waits until every submitted and spawned task has finished. Must
+ *					not be called from a worker.
+ *
+ * Parameters:
+ * 	scheduler	I/O	Scheduler *	The scheduler to wait for
+ ***********************************************************************************/
+void schedulerWait( Scheduler *scheduler ) {
+	pthread_mutex_lock(&scheduler->lock);
+	while( atomic_load(&scheduler->pending) > 0 ) {
+		pthread_cond_wait(&scheduler->done, &scheduler->lock);
+	}
+	pthread_mutex_unlock(&scheduler->lock);
+}
+
+/***********************************************************************************
+ * void schedulerStop( Scheduler *scheduler )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Waits for every task to finish, then stops and joins the worker
+ *					threads and frees the scheduler's memory.
+ *
+ * Parameters:
+ * 	scheduler	I/O	Scheduler *	The scheduler to stop
+ ***********************************************************************************/
+void schedulerStop( Scheduler *scheduler ) {
+	int i;
+
+	// Let every task finish
+	schedulerWait(scheduler);
+
+	// Tell workers to exit, and wake the sleeping ones
+	pthread_mutex_lock(&scheduler->lock);
+	atomic_store(&scheduler->stop, 1);
+	pthread_cond_broadcast(&scheduler->wake);
+	pthread_mutex_unlock(&scheduler->lock);
+
+	// Join workers and free memory
+	for( i = 0; i < scheduler->workers; i++ ) {
+		pthread_join(scheduler->threads[i], NULL);
+	}
+	free(scheduler->threads);
+	free(scheduler->deques);
+	pthread_mutex_destroy(&scheduler->lock);
+	pthread_cond_destroy(&scheduler->wake);
+	pthread_cond_destroy(&scheduler->done);
+}
+
+/***********************************************************************************
+ * void *workerMain( void *argument )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs tasks on a worker thread until the scheduler stops. A worker
+ *					that finds no task goes to sleep until one is submitted or
+ *					spawned. The sleeper count is raised before the final check
+ *					for work, and spawners check it after pushing, so that a
+ *					wakeup can never be lost between the two.
+ *
+ * Parameters:
+ * 	argument	I/P	void *	The deque of the worker
+ * 	workerMain	O/P	void *	Always NULL
+ ***********************************************************************************/
+static void *workerMain( void *argument ) {
+	Deque *deque = argument;
+	Scheduler *scheduler = deque->scheduler;
+	uint32_t random = 2654435761u * (uint32_t)(deque->worker + 1);
+
+	for( ; ; ) {
+		// Run the next task, if any
+		Task *task = findTask(scheduler, deque, &random);
+		if( task != NULL ) {
+			task->run(task, deque->worker);
+			finishTask(scheduler);
+			continue;
+		}
+
+		// Sleep until there is work, or the scheduler stops
+		pthread_mutex_lock(&scheduler->lock);
+		atomic_fetch_add(&scheduler->sleepers, 1);
+		if( !atomic_load(&scheduler->stop) && !hasWork(scheduler) ) {
+			pthread_cond_wait(&scheduler->wake, &scheduler->lock);
+		}
+		atomic_fetch_sub(&scheduler->sleepers, 1);
+		int stop = atomic_load(&scheduler->stop) && !hasWork(scheduler);
+		pthread_mutex_unlock(&scheduler->lock);
+		if( stop ) {
+			return NULL;
+		}
+	}
+}
+
+/***********************************************************************************
+ * Task *findTask( Scheduler *scheduler, Deque *deque, uint32_t *random )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Finds the next task for a worker to run: the newest task of its
+ *					own deque, else the oldest submitted task, else a task stolen
+ *					from a randomly chosen worker.
+ *
+ * Parameters:
+ * 	scheduler	I/O	Scheduler *	The scheduler of the worker
+ * 	deque		I/O	Deque *		The deque of the worker
+ * 	random		I/O	uint32_t *	The worker's random victim state
+ * 	findTask	O/P	Task *		The task to run, NULL if none was found
+ ***********************************************************************************/
+static Task *findTask( Scheduler *scheduler, Deque *deque, uint32_t *random ) {
+	Task *task;
+	int attempt, i;
+
+	for( attempt = 0; attempt < STEAL_ATTEMPTS; attempt++ ) {
+		// Own deque first, newest task first
+		task = dequeTake(deque);
+		if( task != NULL ) {
+			return task;
+		}
+
+		// Then the shared queue
+		if( atomic_load_explicit(&scheduler->submitted, memory_order_relaxed) > 0 ) {
+			pthread_mutex_lock(&scheduler->lock);
+			task = scheduler->head;
+			if( task != NULL ) {
+				scheduler->head = task->next;
+				if( scheduler->head == NULL ) {
+					scheduler->tail = NULL;
+				}
+				atomic_fetch_sub(&scheduler->submitted, 1);
+			}
+			pthread_mutex_unlock(&scheduler->lock);
+			if( task != NULL ) {
+				return task;
+			}
+		}
+
+		// Then steal, starting from a random victim
+		*random ^= *random << 13;
+		*random ^= *random >> 17;
+		*random ^= *random << 5;
+		for( i = 0; i < scheduler->workers; i++ ) {
+			Deque *victim = &scheduler->deques[(*random + i) % scheduler->workers];
+			if( victim != deque && (task = dequeSteal(victim)) != NULL ) {
+				return task;
+			}
+		}
+		sched_yield();
+	}
+	return NULL;
+}
+
+/***********************************************************************************
+ * void finishTask( Scheduler *scheduler )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Records that a task has finished, waking schedulerWait when it was
+ *					the last pending one.
+ *
+ * Parameters:
+ * 	scheduler	I/O	Scheduler *	The scheduler of the task
+ ***********************************************************************************/
+static void finishTask( Scheduler *scheduler ) {
+	if( atomic_fetch_sub(&scheduler->pending, 1) == 1 ) {
+		pthread_mutex_lock(&scheduler->lock);
+		pthread_cond_broadcast(&scheduler->done);
+		pthread_mutex_unlock(&scheduler->lock);
+	}
+}
+
+/***********************************************************************************
+ * void wakeWorker( Scheduler *scheduler )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Wakes a sleeping worker, if there is one, after a task was pushed.
+ *
+ * Parameters:
+ * 	scheduler	I/O	Scheduler *	The scheduler whose worker to wake
+ ***********************************************************************************/
+static void wakeWorker( Scheduler *scheduler ) {
+	atomic_thread_fence(memory_order_seq_cst);
+	if( atomic_load(&scheduler->sleepers) > 0 ) {
+		pthread_mutex_lock(&scheduler->lock);
+		pthread_cond_signal(&scheduler->wake);
+		pthread_mutex_unlock(&scheduler->lock);
+	}
+}
+
+/***********************************************************************************
+ * int hasWork( Scheduler *scheduler )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Determines if any task is waiting in the shared queue or in any
+ *					worker's deque.
+ *
+ * Parameters:
+ * 	scheduler	I/P	Scheduler *	The scheduler to check
+ * 	hasWork		O/P	int			1 if a task is waiting, 0 if not
+ ***********************************************************************************/
+static int hasWork( Scheduler *scheduler ) {
+	int i;
+	if( atomic_load(&scheduler->submitted) > 0 ) {
+		return 1;
+	}
+	for( i = 0; i < scheduler->workers; i++ ) {
+		if( atomic_load(&scheduler->deques[i].bottom) > atomic_load(&scheduler->deques[i].top) ) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int dequePush( Deque *deque, Task *task )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Pushes a task at the bottom of a deque. Only the owning worker
+ *					may push.
+ *
+ * Parameters:
+ * 	deque		I/O	Deque *	The deque to push on
+ * 	task		I/P	Task *	The task to push
+ * 	dequePush	O/P	int		1 if the task was pushed, 0 if the deque is full
+ ***********************************************************************************/
+static int dequePush( Deque *deque, Task *task ) {
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+	long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	if( bottom - top >= DEQUE_CAPACITY ) {
+		return 0;
+	}
+	atomic_store_explicit(&deque->buffer[bottom & (DEQUE_CAPACITY - 1)], task, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+	return 1;
+}
+
+/***********************************************************************************
+ * Task *dequeTake( Deque *deque )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Takes the newest task from the bottom of a deque. Only the owning
+ *					worker may take; it races thieves only for the last task.
+ *
+ * Parameters:
+ * 	deque		I/O	Deque *	The deque to take from
+ * 	dequeTake	O/P	Task *	The task taken, NULL if the deque is empty
+ ***********************************************************************************/
+static Task *dequeTake( Deque *deque ) {
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+	Task *task = NULL;
+
+	if( top <= bottom ) {
+		// Deque is not empty
+		task = atomic_load_explicit(&deque->buffer[bottom & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+		if( top == bottom ) {
+			// Last task: race thieves for it
+			if( !atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+				memory_order_seq_cst, memory_order_relaxed) ) {
+				task = NULL;
+			}
+			atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+		}
+	}
+	else {
+		// Deque is empty
+		atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+	}
+	return task;
+}
+
+/***********************************************************************************
+ * Task *dequeSteal( Deque *deque )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Steals the oldest task from the top of a deque. Any worker may
+ *					steal; a steal that loses a race simply reports no task.
+ *
+ * Parameters:
+ * 	deque		I/O	Deque *	The deque to steal from
+ * 	dequeSteal	O/P	Task *	The task stolen, NULL if none was
+ ***********************************************************************************/
+static Task *dequeSteal( Deque *deque ) {
+	long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+	if( top < bottom ) {
+		Task *task = atomic_load_explicit(&deque->buffer[top & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+		if( atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+			memory_order_seq_cst, memory_order_relaxed) ) {
+			return task;
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,57 @@
+/***********************************************************************************
+ * File: scheduler.h
+ * Author: Justin Hardy
+ * Description: Declarations for the work-stealing task scheduler. See
+ *					scheduler.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Scheduler constants
+#define DEQUE_CAPACITY	4096	// Tasks a worker's deque holds (a power of two)
+#define STEAL_ATTEMPTS	64		// Failed steal rounds before a worker goes to sleep
+
+// A unit of work. Tasks are embedded in larger structures holding their
+// arguments; run receives the task itself and the number of the worker
+// running it, and may spawn further tasks on that worker.
+typedef struct task {
+	void (*run)(struct task*,int);	// Function performing the task
+	struct task *next;				// Next task in the shared submission queue
+} Task;
+
+// Chase-Lev work-stealing deque. The owning worker pushes and takes at the
+// bottom without locks; any other worker steals from the top.
+typedef struct deque {
+	_Alignas(64) atomic_long top;				// Index of the oldest task
+	_Alignas(64) atomic_long bottom;			// Index one past the newest task
+	_Atomic(Task*) buffer[DEQUE_CAPACITY];		// Circular task buffer
+	struct scheduler *scheduler;				// Scheduler owning the deque
+	int worker;									// Number of the worker owning the deque
+} Deque;
+
+// Scheduler state
+typedef struct scheduler {
+	int workers;				// Number of worker threads
+	pthread_t *threads;			// Worker threads
+	Deque *deques;				// One deque per worker
+	Task *head, *tail;			// Shared queue of submitted tasks
+	atomic_long submitted;		// Number of tasks in the shared queue
+	atomic_long pending;		// Number of tasks submitted or spawned but not finished
+	atomic_int sleepers;		// Number of workers waiting for work
+	atomic_int stop;			// Non-zero once workers should exit
+	pthread_mutex_t lock;		// Protects the shared queue and sleeping
+	pthread_cond_t wake;		// Signalled when work becomes available
+	pthread_cond_t done;		// Signalled when no task is pending
+} Scheduler;
+
+int schedulerStart(Scheduler*,int);		// Starts worker threads
+void schedulerSubmit(Scheduler*,Task*);		// Submits a task from any thread
+void schedulerSpawn(Scheduler*,int,Task*);	// Spawns a task from a worker
+void schedulerWait(Scheduler*);				// Waits for every pending task
+void schedulerStop(Scheduler*);				// Waits, then stops worker threads
+
+#endif
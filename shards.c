@@ -0,0 +1,273 @@
+/***********************************************************************************
+ * File: shards.c
+ * Author: Justin Hardy
+ * Procedures:
+ * shardsParse	- Parses a sampling specification.
+ * shardsLru	- Estimates the LRU faults of every wss of a range from a sample.
+ * shardsHash	- Hashes a page for sampling.
+ * heapPush		- Adds a sampled page to the heap of a fixed-size sample.
+ * heapPop		- Removes the sampled page with the largest hash.
+ *
+ * SHARDS (Waldspurger et al., FAST '15) runs the stack distance engine on only
+ * the references to a spatially hashed sample of the pages: a page is sampled
+ * if its hash modulo SHARDS_MODULUS is below a threshold, so every reference to
+ * it is, and at rate R the distances between sampled references are R times
+ * the true ones. Each sampled reference thus stands for 1/R references at 1/R
+ * times its sampled distance, and the curve costs a fraction R of an exact
+ * pass, with an error that depends on the number of pages sampled rather than
+ * on the length of the trace. Sampled distances are multiples of 1/R, so the
+ * curve is only resolved at wss above 1/R.
+ *
+ * With a fixed rate, the sample, and the engine's state, grow with the pages
+ * of the trace. With a maximum sample size, the rate starts as given and is
+ * lowered whenever the sample overflows, to the largest hash sampled, whose
+ * pages are then forgotten; a heap of the sampled pages by hash finds them.
+ * The estimated misses are normalized by the total weight of the sampled
+ * references, as in SHARDS-adj, so a sample that happens to hold more or
+ * fewer references than expected does not bias the curve.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "shards.h"
+#include "stackdist.h"
+
+// A sampled page and its hash
+typedef struct shardsSample {
+	uint64_t hash;				// Hash of the page modulo SHARDS_MODULUS
+	PageKey page;				// The page
+} ShardsSample;
+
+static uint64_t shardsHash(PageKey);					// Hashes a page for sampling
+static void heapPush(ShardsSample*,long*,ShardsSample);	// Adds a sampled page
+static void heapPop(ShardsSample*,long*);				// Removes the largest hash
+
+/***********************************************************************************
+ * int shardsParse( const char *spec, Shards *shards )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a sampling specification of the form key=value,... with
+ *					keys rate (the initial sampling rate, default 1 if max or
+ *					error is given), max (the most pages sampled at once) and
+ *					error (a bound on the error of each point of the curve, which
+ *					sets max to 1/(4 error^2), the sample size for which the
+ *					standard error of a sampled miss ratio is at most error).
+ *
+ * Parameters:
+ * 	spec		I/P	const char *	The specification to be parsed
+ * 	shards		O/P	Shards *		The sampling
+ * 	shardsParse	O/P	int				0 on success, -1 if spec is invalid
+ ***********************************************************************************/
+int shardsParse( const char *spec, Shards *shards ) {
+	char buffer[256], *key, *value, *rest;
+	double error;
+
+	// Copy the specification so that it can be tokenized
+	if( strlen(spec) >= sizeof(buffer) ) {
+		return -1;
+	}
+	strcpy(buffer, spec);
+
+	// Parse key=value parameters
+	shards->rate = 0.0;
+	shards->max = 0;
+	for( key = strtok(buffer, ","); key != NULL; key = strtok(NULL, ",") ) {
+		value = strchr(key, '=');
+		if( value == NULL ) {
+			return -1;
+		}
+		*value++ = '\0';
+		if( strcmp(key, "rate") == 0 ) {
+			shards->rate = strtod(value, &rest);
+			if( !(shards->rate > 0.0 && shards->rate <= 1.0) ) {
+				return -1;
+			}
+		}
+		else if( strcmp(key, "max") == 0 ) {
+			shards->max = strtol(value, &rest, 10);
+			if( shards->max <= 0 ) {
+				return -1;
+			}
+		}
+		else if( strcmp(key, "error") == 0 ) {
+			error = strtod(value, &rest);
+			if( !(error > 0.0 && error <= 0.5) ) {
+				return -1;
+			}
+			shards->max = (long)ceil(1.0 / (4.0 * error * error));
+		}
+		else {
+			rest = value;
+		}
+		if( rest == value || *rest != '\0' ) {
+			return -1;
+		}
+	}
+
+	// A fixed-size sample starts with every page
+	if( shards->rate == 0.0 ) {
+		if( shards->max == 0 ) {
+			return -1;
+		}
+		shards->rate = 1.0;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int shardsLru( int lower, int upper, const PageKey data[], long length,
+ *				long faults[], const EngineConfig *settings,
+ *				Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Estimates the page faults of the LRU virtual memory replacement
+ *					algorithm on a given data set for every wss from lower to
+ *					upper at once, sampling pages as set by the engine
+ *					settings.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size
+ * 	data		I/P	const PageKey []	The data to perform the algorithm on
+ * 	length		I/P	long				The number of references in the data
+ * 	faults		O/P	long []				The estimated page faults, indexed by wss
+ * 	settings	I/P	const EngineConfig *	The engine settings
+ * 	arena		I/O	Arena *				The arena to allocate the engine from
+ * 	shardsLru	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int shardsLru( int lower, int upper, const PageKey data[], long length, long faults[],
+			   const EngineConfig *settings, Arena *arena ) {
+	const Shards *config = &settings->shards;
+	uint64_t threshold = (uint64_t)ceil(config->rate * SHARDS_MODULUS);
+	ShardsSample *heap = NULL;
+	StackDist engine;
+	long i, distance, samples = 0;
+	double rate, scaled, weight = 0.0, misses = 0.0, pages, estimate;
+	int wss;
+
+	// Weigh the sampled references at each scaled distance up to upper; any
+	// farther or cold reference misses at every wss
+	double *depths = arenaAlloc(arena, (upper + 1) * sizeof(double));
+	if( depths == NULL || stackDistInit(&engine, arena) != 0 ) {
+		return -1;
+	}
+	if( config->max > 0 && (heap = arenaAlloc(arena, (config->max + 1) * sizeof(ShardsSample))) == NULL ) {
+		return -1;
+	}
+	memset(depths, 0, (upper + 1) * sizeof(double));
+	for( i = 0; i < length; i++ ) {
+		// Skip the pages outside the sample
+		uint64_t hash = shardsHash(data[i]) & (SHARDS_MODULUS - 1);
+		if( hash >= threshold ) {
+			continue;
+		}
+		rate = (double)threshold / SHARDS_MODULUS;
+		distance = stackDistAccess(&engine, data[i]);
+		if( distance < 0 ) {
+			return -1;
+		}
+
+		// Weigh the reference as 1/rate references at 1/rate its distance
+		weight += 1.0 / rate;
+		scaled = distance / rate;
+		if( distance == STACK_DIST_COLD || scaled > upper ) {
+			misses += 1.0 / rate;
+		}
+		else {
+			depths[(long)ceil(scaled)] += 1.0 / rate;
+		}
+
+		// Keep a fixed-size sample by lowering the rate, forgetting the pages
+		// with the largest hash
+		if( heap != NULL && distance == STACK_DIST_COLD ) {
+			heapPush(heap, &samples, (ShardsSample){ hash, data[i] });
+			if( samples > config->max ) {
+				threshold = heap[0].hash;
+				while( samples > 0 && heap[0].hash >= threshold ) {
+					stackDistForget(&engine, heap[0].page);
+					heapPop(heap, &samples);
+				}
+			}
+		}
+	}
+
+	// Scale the curve to the length of the trace; a wss misses every reference
+	// farther than it, except the misses that filled its frames
+	rate = (double)threshold / SHARDS_MODULUS;
+	pages = threshold > 0 ? engine.pages / rate : 0.0;
+	for( wss = upper; wss >= lower; wss-- ) {
+		estimate = weight > 0.0 ? length * misses / weight - (pages < wss ? pages : wss) : 0.0;
+		faults[wss] = estimate > 0.0 ? (long)(estimate + 0.5) : 0;
+		misses += depths[wss];
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * uint64_t shardsHash( PageKey page )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Hashes a page for sampling with the SplitMix64 finalizer, so that
+ *					pages are sampled independently of how they are numbered.
+ *
+ * Parameters:
+ * 	page		I/P	PageKey		The page to hash
+ * 	shardsHash	O/P	uint64_t	The hash of the page
+ ***********************************************************************************/
+static uint64_t shardsHash( PageKey page ) {
+	uint64_t hash = page + 0x9E3779B97F4A7C15ULL;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+	return hash ^ (hash >> 31);
+}
+
+/***********************************************************************************
+ * void heapPush( ShardsSample heap[], long *samples, ShardsSample sample )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Adds a sampled page to a binary max-heap ordered by hash.
+ *
+ * Parameters:
+ * 	heap	I/O	ShardsSample []	The heap, with room for one more page
+ * 	samples	I/O	long *			The number of pages in the heap
+ * 	sample	I/P	ShardsSample	The page to add
+ ***********************************************************************************/
+static void heapPush( ShardsSample heap[], long *samples, ShardsSample sample ) {
+	long child = (*samples)++, parent;
+
+	// Move parents with smaller hashes down until the page fits
+	while( child > 0 && heap[parent = (child - 1) / 2].hash < sample.hash ) {
+		heap[child] = heap[parent];
+		child = parent;
+	}
+	heap[child] = sample;
+}
+
+/***********************************************************************************
+ * void heapPop( ShardsSample heap[], long *samples )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Removes the page with the largest hash from a binary max-heap.
+ *
+ * Parameters:
+ * 	heap	I/O	ShardsSample []	The heap, holding at least one page
+ * 	samples	I/O	long *			The number of pages in the heap
+ ***********************************************************************************/
+static void heapPop( ShardsSample heap[], long *samples ) {
+	ShardsSample last = heap[--(*samples)];
+	long parent = 0, child;
+
+	// Move the last page down from the root, swapping with the larger child
+	while( (child = 2 * parent + 1) < *samples ) {
+		if( child + 1 < *samples && heap[child + 1].hash > heap[child].hash ) {
+			child++;
+		}
+		if( heap[child].hash <= last.hash ) {
+			break;
+		}
+		heap[parent] = heap[child];
+		parent = child;
+	}
+	heap[parent] = last;
+}
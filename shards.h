@@ -0,0 +1,21 @@
+/***********************************************************************************
+ * File: shards.h
+ * Author: Justin Hardy
+ * Description: Declarations for SHARDS, which estimates the LRU miss ratio curve
+ *					of a trace from a spatially hashed sample of its pages. See
+ *					shards.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef SHARDS_H
+#define SHARDS_H
+
+#include <stdint.h>
+#include "replaceAlgos.h"
+
+// SHARDS constants
+#define SHARDS_MODULUS		(1 << 24)	// Pages are sampled if their hash modulo this is below the threshold
+
+int shardsParse(const char*,Shards*);							// Parses a sampling specification
+int shardsLru(int,int,const PageKey[],long,long[],const EngineConfig*,Arena*);		// Estimates LRU for a range of wss
+
+#endif
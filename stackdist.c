@@ -0,0 +1,626 @@
+/***********************************************************************************
+ * File: stackdist.c
+ * Author: Justin Hardy
+ * Procedures:
+ * stackDistInit	- Prepares a stack distance engine with no pages.
+ * stackDistAccess	- References a page, returning its LRU stack distance.
+ * stackDistForget	- Stops tracking a page.
+ * lruBatch			- Performs LRU for every wss of a range in one trace pass.
+ * lruLazy			- Performs LRU for every wss of a range, pulling references.
+ * countDistances	- Counts the references of a trace at each stack distance.
+ * lruChunked		- Counts the stack distances of a trace split into chunks.
+ * chunkMain		- Counts the distances within one chunk of a trace.
+ * compareTimes		- Orders the entries of an engine by time.
+ * treeSum			- Counts the last references up to a time.
+ * treeAdd			- Adds to the count of a time.
+ * findEntry		- Finds the entry of a page in the table of an engine.
+ * compact			- Renumbers the last references of an engine from time 1.
+ * growTable		- Doubles the table of an engine.
+ *
+ * The stack distance of a reference is the number of distinct pages referenced
+ * since the previous reference to the same page, that page included. An LRU
+ * set of wss frames hits exactly the references at distance wss or less, so
+ * one pass computing every distance yields the faults of every wss at once.
+ *
+ * Every reference gets the next time. A table maps each tracked page to the
+ * time of its last reference, and a Fenwick tree over times holds a 1 at each
+ * such time, so the distance of a reference is the number of ones from the
+ * page's previous time on: a single prefix sum. Once every time of the tree
+ * is used, the last references are renumbered from 1 in order, which keeps
+ * the tree no larger than a small multiple of the tracked pages however long
+ * the trace is.
+ *
+ * A long trace can be split into chunks whose distances are counted by their
+ * own threads, each with its own engine. Within a chunk, only the first
+ * reference to each page cannot be resolved, since its previous reference is
+ * in an earlier chunk. A merge then replays, in chunk order, through one more
+ * engine, the first reference of every page of a chunk in order, followed by
+ * the last one in order. Every page referenced in a chunk before one of its
+ * first references is itself one of the earlier first references, so the
+ * merge engine yields exactly the distance of each, and replaying the last
+ * references leaves it in the order of the whole trace at the end of the
+ * chunk. The merge costs two references per distinct page of a chunk rather
+ * than one per reference, and runs while later chunks are still counted; the
+ * counts are exactly those of a serial pass.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "stackdist.h"
+
+// One chunk of a trace and the distances counted within it
+typedef struct stackDistChunk {
+	pthread_t thread;			// Thread counting the chunk
+	int started;				// Non-zero if the thread was started
+	const PageKey *data;		// References of the chunk
+	long length;				// Number of references of the chunk
+	int upper;					// Largest distance counted individually
+	Arena arena;				// Arena of the chunk's engine and results
+	long *depths;				// References reused within the chunk at each distance
+	long misses;				// References reused within the chunk farther than upper
+	PageKey *firsts;			// Pages of the chunk, in order of first reference
+	StackDistEntry *lasts;		// Pages of the chunk, in order of last reference
+	long pages;					// Number of pages of the chunk
+	int failed;					// Non-zero if the chunk could not be counted
+} StackDistChunk;
+
+static long treeSum(const StackDist*,long);					// Counts last references
+static void treeAdd(StackDist*,long,long);					// Adds to the count of a time
+static StackDistEntry *findEntry(StackDist*,PageKey);		// Finds the entry of a page
+static int compact(StackDist*);								// Renumbers last references
+static int growTable(StackDist*);							// Doubles the table
+static int countDistances(StackDist*,int,const PageKey[],long,long[],long*);	// Counts distances
+static int lruChunked(int,int,const PageKey[],long,long[],long*,long*,Arena*);	// Counts in chunks
+static void *chunkMain(void*);								// Counts within a chunk
+static int compareTimes(const void*,const void*);			// Orders entries by time
+
+/***********************************************************************************
+ * int stackDistInit( StackDist *engine, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prepares a stack distance engine tracking no pages, with its state
+ *					allocated from an arena.
+ *
+ * Parameters:
+ * 	engine			O/P	StackDist *	The engine to prepare
+ * 	arena			I/O	Arena *		The arena to allocate the state from
+ * 	stackDistInit	O/P	int			0 on success, -1 on failure
+ ***********************************************************************************/
+int stackDistInit( StackDist *engine, Arena *arena ) {
+	engine->arena = arena;
+	engine->capacity = STACK_DIST_INITIAL;
+	engine->now = 0;
+	engine->pages = 0;
+	engine->mask = 2 * STACK_DIST_INITIAL - 1;
+	engine->tree = arenaAlloc(arena, (engine->capacity + 1) * sizeof(long));
+	engine->entries = arenaAlloc(arena, (engine->mask + 1) * sizeof(StackDistEntry));
+	if( engine->tree == NULL || engine->entries == NULL ) {
+		return -1;
+	}
+	memset(engine->tree, 0, (engine->capacity + 1) * sizeof(long));
+	memset(engine->entries, 0, (engine->mask + 1) * sizeof(StackDistEntry));
+	return 0;
+}
+
+/***********************************************************************************
+ * long stackDistAccess( StackDist *engine, PageKey page )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: References a page, tracking it from now on if it was not.
+ *
+ * Parameters:
+ * 	engine			I/O	StackDist *	The engine
+ * 	page			I/P	PageKey		The page referenced
+ * 	stackDistAccess	O/P	long		The stack distance of the reference, from 1,
+ *									STACK_DIST_COLD if the page was not tracked,
+ *									or -1 if the state could not grow
+ ***********************************************************************************/
+long stackDistAccess( StackDist *engine, PageKey page ) {
+	StackDistEntry *entry;
+	long distance;
+
+	// Free times once every one is used
+	if( engine->now == engine->capacity && compact(engine) != 0 ) {
+		return -1;
+	}
+
+	entry = findEntry(engine, page);
+	if( entry->time == 0 ) {
+		// Start tracking the page, keeping the table under half full
+		if( 2 * (size_t)(engine->pages + 1) > engine->mask + 1 ) {
+			if( growTable(engine) != 0 ) {
+				return -1;
+			}
+			entry = findEntry(engine, page);
+		}
+		entry->page = page;
+		engine->pages++;
+		distance = STACK_DIST_COLD;
+	}
+	else {
+		// Count the pages last referenced since the page, itself included
+		distance = engine->pages - treeSum(engine, entry->time - 1);
+		treeAdd(engine, entry->time, -1);
+	}
+
+	// Move the page's last reference to now
+	entry->time = ++engine->now;
+	treeAdd(engine, entry->time, 1);
+	return distance;
+}
+
+/***********************************************************************************
+ * void stackDistForget( StackDist *engine, PageKey page )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Stops tracking a page, as if it had never been referenced. Its next
+ *					reference is cold, and it no longer counts towards the
+ *					distances of other pages.
+ *
+ * Parameters:
+ * 	engine	I/O	StackDist *	The engine
+ * 	page	I/P	PageKey		The page to forget
+ ***********************************************************************************/
+void stackDistForget( StackDist *engine, PageKey page ) {
+	StackDistEntry *entries = engine->entries;
+	size_t hole = findEntry(engine, page) - entries, slot, home;
+
+	if( entries[hole].time == 0 ) {
+		return;
+	}
+	treeAdd(engine, entries[hole].time, -1);
+	engine->pages--;
+
+	// Delete the entry, moving back every later entry of the cluster whose
+	// home slot is not between the hole and itself
+	for( slot = (hole + 1) & engine->mask; entries[slot].time != 0; slot = (slot + 1) & engine->mask ) {
+		home = (size_t)((entries[slot].page * 0x9E3779B97F4A7C15ULL) >> 32) & engine->mask;
+		if( ((slot - home) & engine->mask) >= ((slot - hole) & engine->mask) ) {
+			entries[hole] = entries[slot];
+			hole = slot;
+		}
+	}
+	entries[hole].time = 0;
+}
+
+/***********************************************************************************
+ * int lruBatch( int lower, int upper, const PageKey data[], long length,
+ *				long faults[], const EngineConfig *settings,
+ *				Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the LRU virtual memory replacement algorithm on a given
+ *					data set for every wss from lower to upper at once, from the
+ *					stack distance of every reference, counting the page faults
+ *					of each exactly as LRU() does.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size
+ * 	data		I/P	const PageKey []	The data to perform the algorithm on
+ * 	length		I/P	long				The number of references in the data
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	settings	I/P	const EngineConfig *	The engine settings
+ * 	arena		I/O	Arena *				The arena to allocate the engine from
+ * 	lruBatch	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int lruBatch( int lower, int upper, const PageKey data[], long length, long faults[],
+			   const EngineConfig *settings, Arena *arena ) {
+	StackDist engine;
+	long misses = 0, pages;
+	int wss;
+
+	// Count the references at each distance up to upper; any farther or cold
+	// reference misses at every wss
+	long *depths = arenaAlloc(arena, (upper + 1) * sizeof(long));
+	if( depths == NULL ) {
+		return -1;
+	}
+	memset(depths, 0, (upper + 1) * sizeof(long));
+	if( settings->threads > 1 && length >= 2 * (long)STACK_DIST_CHUNK ) {
+		if( lruChunked(settings->threads, upper, data, length, depths, &misses, &pages, arena) != 0 ) {
+			return -1;
+		}
+	}
+	else {
+		if( stackDistInit(&engine, arena) != 0 || countDistances(&engine, upper, data, length, depths, &misses) != 0 ) {
+			return -1;
+		}
+		pages = engine.pages;
+	}
+
+	// A wss misses every reference farther than it, except the misses that
+	// filled its frames
+	for( wss = upper; wss >= lower; wss-- ) {
+		faults[wss] = misses - (pages < wss ? pages : wss);
+		misses += depths[wss];
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int lruLazy( int lower, int upper, const PageSource *source, long length,
+ *				long faults[], Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Performs the LRU virtual memory replacement algorithm for every
+ *					wss from lower to upper at once, as lruBatch() does, on
+ *					references pulled from a source a block at a time.
+ *
+ * Parameters:
+ * 	lower		I/P	int					The smallest working set size
+ * 	upper		I/P	int					The largest working set size
+ * 	source		I/P	const PageSource *	The source of the references
+ * 	length		I/P	long				The number of references to pull
+ * 	faults		O/P	long []				The page faults, indexed by wss
+ * 	arena		I/O	Arena *				The arena to allocate the engine from
+ * 	lruLazy		O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int lruLazy( int lower, int upper, const PageSource *source, long length, long faults[], Arena *arena ) {
+	StackDist engine;
+	long start, count, misses = 0;
+	int wss;
+
+	long *depths = arenaAlloc(arena, (upper + 1) * sizeof(long));
+	PageKey *block = arenaAlloc(arena, PAGE_SOURCE_BLOCK * sizeof(PageKey));
+	if( depths == NULL || block == NULL || stackDistInit(&engine, arena) != 0 ) {
+		return -1;
+	}
+	memset(depths, 0, (upper + 1) * sizeof(long));
+	for( start = 0; start < length; start += count ) {
+		count = length - start < PAGE_SOURCE_BLOCK ? length - start : PAGE_SOURCE_BLOCK;
+		source->fill(source, start, block, count);
+		if( countDistances(&engine, upper, block, count, depths, &misses) != 0 ) {
+			return -1;
+		}
+	}
+	for( wss = upper; wss >= lower; wss-- ) {
+		faults[wss] = misses - (engine.pages < wss ? engine.pages : wss);
+		misses += depths[wss];
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int countDistances( StackDist *engine, int upper, const PageKey data[],
+ *					long length, long depths[], long *misses )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: References every page of a trace in an engine, counting the
+ *					references at each stack distance up to upper.
+ *
+ * Parameters:
+ * 	engine			I/O	StackDist *			The engine
+ * 	upper			I/P	int					The largest distance counted individually
+ * 	data			I/P	const PageKey []	The trace
+ * 	length			I/P	long				The number of references in the trace
+ * 	depths			I/O	long []				The references at each distance up to upper
+ * 	misses			I/O	long *				The references farther than upper, or cold
+ * 	countDistances	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+static int countDistances( StackDist *engine, int upper, const PageKey data[], long length, long depths[],
+						   long *misses ) {
+	long i, distance;
+
+	for( i = 0; i < length; i++ ) {
+		distance = stackDistAccess(engine, data[i]);
+		if( distance < 0 ) {
+			return -1;
+		}
+		if( distance == STACK_DIST_COLD || distance > upper ) {
+			(*misses)++;
+		}
+		else {
+			depths[distance]++;
+		}
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int lruChunked( int threads, int upper, const PageKey data[], long length,
+ *				long depths[], long *misses, long *pages, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Counts the references of a trace at each stack distance, splitting
+ *					it into up to threads chunks counted concurrently and merging
+ *					them in order on the calling thread.
+ *
+ * Parameters:
+ * 	threads		I/P	int					The most chunks counted concurrently
+ * 	upper		I/P	int					The largest distance counted individually
+ * 	data		I/P	const PageKey []	The trace
+ * 	length		I/P	long				The number of references in the trace
+ * 	depths		I/O	long []				The references at each distance up to upper
+ * 	misses		I/O	long *				The references farther than upper, or cold
+ * 	pages		O/P	long *				The number of pages of the trace
+ * 	arena		I/O	Arena *				The arena to allocate the merge engine from
+ * 	lruChunked	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+static int lruChunked( int threads, int upper, const PageKey data[], long length, long depths[],
+					   long *misses, long *pages, Arena *arena ) {
+	StackDist engine;
+	StackDistChunk *chunks;
+	long i, distance, start = 0;
+	int chunkCount = threads, k, wss, failed;
+
+	// Split the trace into chunks of at least STACK_DIST_CHUNK references
+	if( chunkCount > length / STACK_DIST_CHUNK ) {
+		chunkCount = (int)(length / STACK_DIST_CHUNK);
+	}
+	chunks = arenaAlloc(arena, chunkCount * sizeof(StackDistChunk));
+	if( chunks == NULL || stackDistInit(&engine, arena) != 0 ) {
+		return -1;
+	}
+	for( k = 0; k < chunkCount; k++ ) {
+		chunks[k].data = data + start;
+		chunks[k].length = (length - start) / (chunkCount - k);
+		chunks[k].upper = upper;
+		start += chunks[k].length;
+	}
+
+	// Count every chunk but the first on its own thread, or here if a thread
+	// cannot be started, then the first here
+	for( k = 1; k < chunkCount; k++ ) {
+		chunks[k].started = pthread_create(&chunks[k].thread, NULL, chunkMain, &chunks[k]) == 0;
+	}
+	chunks[0].started = 0;
+	chunkMain(&chunks[0]);
+
+	// Merge the chunks in order as they finish
+	failed = 0;
+	for( k = 0; k < chunkCount; k++ ) {
+		if( chunks[k].started ) {
+			pthread_join(chunks[k].thread, NULL);
+		}
+		else if( k > 0 ) {
+			chunkMain(&chunks[k]);
+		}
+		failed |= chunks[k].failed;
+		if( failed ) {
+			arenaFree(&chunks[k].arena);
+			continue;
+		}
+
+		// Add the distances within the chunk
+		for( wss = 1; wss <= upper; wss++ ) {
+			depths[wss] += chunks[k].depths[wss];
+		}
+		*misses += chunks[k].misses;
+
+		// Resolve the first reference to each page, then move each to its last
+		// reference; the last chunk needs no moves
+		for( i = 0; i < chunks[k].pages && !failed; i++ ) {
+			distance = stackDistAccess(&engine, chunks[k].firsts[i]);
+			if( distance < 0 ) {
+				failed = 1;
+			}
+			else if( distance == STACK_DIST_COLD || distance > upper ) {
+				(*misses)++;
+			}
+			else {
+				depths[distance]++;
+			}
+		}
+		for( i = 0; i < chunks[k].pages && k < chunkCount - 1 && !failed; i++ ) {
+			failed = stackDistAccess(&engine, chunks[k].lasts[i].page) < 0;
+		}
+		arenaFree(&chunks[k].arena);
+	}
+	*pages = engine.pages;
+	return failed ? -1 : 0;
+}
+
+/***********************************************************************************
+ * void *chunkMain( void *argument )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Counts the references of a chunk reused within it at each stack
+ *					distance, and lists its pages in order of first and of last
+ *					reference. Every allocation is made from the chunk's own
+ *					arena, which the caller frees.
+ *
+ * Parameters:
+ * 	argument	I/O	void *	The StackDistChunk to count
+ * 	chunkMain	O/P	void *	NULL
+ ***********************************************************************************/
+static void *chunkMain( void *argument ) {
+	StackDistChunk *chunk = argument;
+	StackDist engine;
+	long i, distance;
+	size_t slot;
+
+	chunk->failed = 1;
+	chunk->misses = 0;
+	chunk->pages = 0;
+	if( arenaInit(&chunk->arena) != 0 ) {
+		return NULL;
+	}
+	chunk->depths = arenaAlloc(&chunk->arena, (chunk->upper + 1) * sizeof(long));
+	chunk->firsts = arenaAlloc(&chunk->arena, chunk->length * sizeof(PageKey));
+	if( chunk->depths == NULL || chunk->firsts == NULL || stackDistInit(&engine, &chunk->arena) != 0 ) {
+		return NULL;
+	}
+	memset(chunk->depths, 0, (chunk->upper + 1) * sizeof(long));
+
+	// Count the reuses within the chunk, listing the first references
+	for( i = 0; i < chunk->length; i++ ) {
+		distance = stackDistAccess(&engine, chunk->data[i]);
+		if( distance < 0 ) {
+			return NULL;
+		}
+		if( distance == STACK_DIST_COLD ) {
+			chunk->firsts[chunk->pages++] = chunk->data[i];
+		}
+		else if( distance > chunk->upper ) {
+			chunk->misses++;
+		}
+		else {
+			chunk->depths[distance]++;
+		}
+	}
+
+	// List the last references by sorting the tracked pages by time
+	chunk->lasts = arenaAlloc(&chunk->arena, chunk->pages * sizeof(StackDistEntry));
+	if( chunk->lasts == NULL ) {
+		return NULL;
+	}
+	for( i = 0, slot = 0; slot <= engine.mask; slot++ ) {
+		if( engine.entries[slot].time != 0 ) {
+			chunk->lasts[i++] = engine.entries[slot];
+		}
+	}
+	qsort(chunk->lasts, chunk->pages, sizeof(StackDistEntry), compareTimes);
+	chunk->failed = 0;
+	return NULL;
+}
+
+/***********************************************************************************
+ * int compareTimes( const void *a, const void *b )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Orders two entries of an engine by the time of their last
+ *					reference, for qsort.
+ *
+ * Parameters:
+ * 	a				I/P	const void *	The first StackDistEntry
+ * 	b				I/P	const void *	The second StackDistEntry
+ * 	compareTimes	O/P	int				Negative, zero or positive as a is earlier
+ *										than, at the same time as, or later than b
+ ***********************************************************************************/
+static int compareTimes( const void *a, const void *b ) {
+	long first = ((const StackDistEntry*)a)->time, second = ((const StackDistEntry*)b)->time;
+	return (first > second) - (first < second);
+}
+
+/***********************************************************************************
+ * long treeSum( const StackDist *engine, long time )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Counts the last references of tracked pages at or before a time.
+ *
+ * Parameters:
+ * 	engine	I/P	const StackDist *	The engine
+ * 	time	I/P	long				The time, from 0
+ * 	treeSum	O/P	long				The number of last references up to time
+ ***********************************************************************************/
+static long treeSum( const StackDist *engine, long time ) {
+	long sum = 0;
+	for( ; time > 0; time &= time - 1 ) {
+		sum += engine->tree[time];
+	}
+	return sum;
+}
+
+/***********************************************************************************
+ * void treeAdd( StackDist *engine, long time, long delta )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Adds to the count of last references at a time.
+ *
+ * Parameters:
+ * 	engine	I/O	StackDist *	The engine
+ * 	time	I/P	long		The time, from 1
+ * 	delta	I/P	long		The amount to add
+ ***********************************************************************************/
+static void treeAdd( StackDist *engine, long time, long delta ) {
+	for( ; time <= engine->capacity; time += time & -time ) {
+		engine->tree[time] += delta;
+	}
+}
+
+/***********************************************************************************
+ * StackDistEntry *findEntry( StackDist *engine, PageKey page )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Finds the entry of a page in the table of an engine. If the page is
+ *					not tracked, the empty slot where its entry belongs is
+ *					returned.
+ *
+ * Parameters:
+ * 	engine		I/P	StackDist *			The engine
+ * 	page		I/P	PageKey				The page to find
+ * 	findEntry	O/P	StackDistEntry *	The entry of the page
+ ***********************************************************************************/
+static StackDistEntry *findEntry( StackDist *engine, PageKey page ) {
+	size_t slot = (size_t)((page * 0x9E3779B97F4A7C15ULL) >> 32) & engine->mask;
+	while( engine->entries[slot].time != 0 && engine->entries[slot].page != page ) {
+		slot = (slot + 1) & engine->mask;
+	}
+	return &engine->entries[slot];
+}
+
+/***********************************************************************************
+ * int compact( StackDist *engine )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Renumbers the last references of every tracked page from time 1,
+ *					keeping their order: each one's new time is its rank among
+ *					them. The tree is doubled first if the renumbered times would
+ *					fill more than half of it.
+ *
+ * Parameters:
+ * 	engine	I/O	StackDist *	The engine
+ * 	compact	O/P	int			0 on success, -1 on failure
+ ***********************************************************************************/
+static int compact( StackDist *engine ) {
+	long time, pages = engine->pages;
+	size_t slot;
+
+	// Rank every last reference with the old tree
+	for( slot = 0; slot <= engine->mask; slot++ ) {
+		if( engine->entries[slot].time != 0 ) {
+			engine->entries[slot].time = treeSum(engine, engine->entries[slot].time);
+		}
+	}
+
+	// Grow the tree if needed
+	if( 2 * pages > engine->capacity ) {
+		long *tree = arenaAlloc(engine->arena, (2 * engine->capacity + 1) * sizeof(long));
+		if( tree == NULL ) {
+			return -1;
+		}
+		engine->tree = tree;
+		engine->capacity *= 2;
+	}
+
+	// Rebuild the tree with ones at times 1 to pages; each node counts the
+	// times of its range up to pages
+	engine->tree[0] = 0;
+	for( time = 1; time <= engine->capacity; time++ ) {
+		long start = time - (time & -time);
+		engine->tree[time] = (time < pages ? time : pages) - (start < pages ? start : pages);
+	}
+	engine->now = pages;
+	return 0;
+}
+
+/***********************************************************************************
+ * int growTable( StackDist *engine )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Doubles the table of an engine, moving every entry to the new one.
+ *
+ * Parameters:
+ * 	engine		I/O	StackDist *	The engine
+ * 	growTable	O/P	int			0 on success, -1 on failure
+ ***********************************************************************************/
+static int growTable( StackDist *engine ) {
+	StackDistEntry *old = engine->entries;
+	size_t slots = engine->mask + 1, slot;
+
+	engine->entries = arenaAlloc(engine->arena, 2 * slots * sizeof(StackDistEntry));
+	if( engine->entries == NULL ) {
+		engine->entries = old;
+		return -1;
+	}
+	memset(engine->entries, 0, 2 * slots * sizeof(StackDistEntry));
+	engine->mask = 2 * slots - 1;
+	for( slot = 0; slot < slots; slot++ ) {
+		if( old[slot].time != 0 ) {
+			*findEntry(engine, old[slot].page) = old[slot];
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,43 @@
+/***********************************************************************************
+ * File: stackdist.h
+ * Author: Justin Hardy
+ * Description: Declarations for the stack distance engine, which computes the LRU
+ *					stack distance of every reference of a trace in logarithmic
+ *					time. See stackdist.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef STACKDIST_H
+#define STACKDIST_H
+
+#include "replaceAlgos.h"
+
+// Stack distance constants
+#define STACK_DIST_COLD		0		// Distance of the first reference to a page
+#define STACK_DIST_INITIAL	1024	// Initial number of times and pages tracked
+#define STACK_DIST_CHUNK	65536	// Fewest references of a chunk worth its own thread
+
+// Last reference to a tracked page
+typedef struct stackDistEntry {
+	PageKey page;				// The page
+	long time;					// Time of its last reference; 0 if the slot is empty
+} StackDistEntry;
+
+// Stack distance engine state
+typedef struct stackDist {
+	Arena *arena;				// Arena the state is allocated from
+	long *tree;					// Fenwick tree over times, counting the last reference
+								// to every tracked page
+	long capacity;				// Number of times the tree covers
+	long now;					// Time of the latest reference
+	StackDistEntry *entries;	// Open addressing table of tracked pages
+	size_t mask;				// Number of slots of the table minus one
+	long pages;					// Number of tracked pages
+} StackDist;
+
+int stackDistInit(StackDist*,Arena*);			// Prepares an engine with no pages
+long stackDistAccess(StackDist*,PageKey);		// References a page, returning its distance
+void stackDistForget(StackDist*,PageKey);		// Stops tracking a page
+int lruBatch(int,int,const PageKey[],long,long[],const EngineConfig*,Arena*);	// Performs LRU for a range of wss
+int lruLazy(int,int,const PageSource*,long,long[],Arena*);	// Performs LRU pulling references
+
+#endif
@@ -0,0 +1,483 @@
+/***********************************************************************************
+ * File: sweep.c
+ * Author: Justin Hardy
+ * Procedures:
+ * sweepStart		- Starts a sweep and its worker threads.
+ * sweepSubmit		- Submits a trace to be simulated for every wss and policy.
+ * sweepFinish		- Waits for every submitted trace, then stops the workers.
+ * runTraceJob		- Generates a trace if needed and spawns its units.
+ * runUnit			- Simulates one policy for one wss on one trace.
+ * finishTrace		- Records the results of a trace and frees its job.
+ * sweepNow			- Gets the monotonic time.
+ * freeArenas		- Frees the arenas of the workers of a sweep.
+ *
+ * Every (trace, wss, policy) combination is a separate task of a work-stealing
+ * scheduler, so one expensive combination (e.g. LRU at a large wss) never holds
+ * up the cheap ones queued behind it. The number of traces in flight is bounded
+ * so that memory stays constant however many traces are swept. Faults are only
+ * accumulated once every unit of a trace has finished, so the checkpoint always
+ * holds whole traces and can be saved at any time. With a result cache, units
+ * whose results are cached are never spawned, and every simulated result is
+ * added to the cache. A dirty sweep simulates each unit with the dirty engine
+ * of its policy, which also counts the evictions of pages written to. A lazy
+ * sweep never generates its traces: the batched engine of each policy pulls
+ * the references of a trace from a counter mode generator as it goes, so
+ * memory stays constant however long traces are.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sweep.h"
+#include "kernels.h"
+#include "shards.h"
+
+static void runTraceJob(Task*,int);		// Spawns the units of a trace
+static void runUnit(Task*,int);			// Simulates one unit
+static void runBatch(Unit*,Arena*);		// Simulates every uncached wss of a unit's policy
+static PolicyBatch batchEngine(const SweepConfig*,const Policy*);	// Gets the engine running every wss of a policy
+static void finishTrace(TraceJob*);		// Records the results of a trace and frees its job
+static long long sweepNow(void);		// Gets the monotonic time
+static void freeArenas(Sweep*);			// Frees the arenas of the workers
+
+/***********************************************************************************
+ * int sweepStart( Sweep *sweep, const SweepConfig *config )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Starts a sweep and its worker threads. Every finished trace is
+ *					recorded in the configured progress, which may be shared
+ *					with other sweeps, even in other processes. Finished traces
+ *					and their faults are accumulated into the configured
+ *					checkpoint, which is saved to its path every
+ *					SWEEP_CHECKPOINT_MS and when the sweep finishes. If a
+ *					result cache is given, only the results missing from it are
+ *					simulated. If a detector is given, every finished trace is
+ *					checked for Belady's anomaly. If traceFaults is given, the
+ *					faults and write-backs of every finished trace are also kept
+ *					apart, by its number.
+ *
+ * Parameters:
+ * 	sweep		O/P	Sweep *				The sweep to start
+ * 	config		I/P	const SweepConfig *	The parameters of the sweep
+ * 	sweepStart	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int sweepStart( Sweep *sweep, const SweepConfig *config ) {
+	int threads = config->threads;
+
+	// Record parameters
+	sweep->config = *config;
+	atomic_init(&sweep->failed, 0);
+	sweep->nextCheckpoint = sweepNow() + SWEEP_CHECKPOINT_MS * 1000000LL;
+
+	// Prepare one arena per worker for the state of its simulations
+	sweep->arenas = malloc(threads * sizeof(Arena));
+	if( sweep->arenas == NULL ) {
+		return -1;
+	}
+	for( sweep->workers = 0; sweep->workers < threads; sweep->workers++ ) {
+		if( arenaInit(&sweep->arenas[sweep->workers]) != 0 ) {
+			freeArenas(sweep);
+			return -1;
+		}
+	}
+
+	// Start workers
+	if( pthread_mutex_init(&sweep->lock, NULL) != 0 ) {
+		freeArenas(sweep);
+		return -1;
+	}
+	if( sem_init(&sweep->slots, 0, threads * SWEEP_TRACES_PER_WORKER) != 0 ) {
+		pthread_mutex_destroy(&sweep->lock);
+		freeArenas(sweep);
+		return -1;
+	}
+	if( schedulerStart(&sweep->scheduler, threads) != 0 ) {
+		sem_destroy(&sweep->slots);
+		pthread_mutex_destroy(&sweep->lock);
+		freeArenas(sweep);
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int sweepSubmit( Sweep *sweep, long number, Trace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Submits a trace to be simulated for every wss and policy, waiting
+ *					first if too many traces are already in flight. The sweep
+ *					takes over the caller's ownership of the trace. If trace is
+ *					NULL, the trace is generated by a worker from the sweep's
+ *					workload, using the random stream of its number.
+ *
+ * Parameters:
+ * 	sweep		I/O	Sweep *	The sweep to submit to
+ * 	number		I/P	long	The number of the trace within the sweep
+ * 	trace		I/P	Trace *	The trace, or NULL to generate it
+ * 	sweepSubmit	O/P	int		0 on success, -1 on failure
+ ***********************************************************************************/
+int sweepSubmit( Sweep *sweep, long number, Trace *trace ) {
+	// Wait for a free slot
+	while( sem_wait(&sweep->slots) != 0 );
+
+	// Create job
+	TraceJob *job = malloc(sizeof(TraceJob));
+	if( job == NULL ) {
+		sem_post(&sweep->slots);
+		return -1;
+	}
+	job->task.run = runTraceJob;
+	job->sweep = sweep;
+	job->trace = trace;
+	job->number = number;
+
+	// Let a worker spawn its units
+	schedulerSubmit(&sweep->scheduler, &job->task);
+	return 0;
+}
+
+/***********************************************************************************
+ * int sweepFinish( Sweep *sweep )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Waits for every submitted trace to be simulated, then stops the
+ *					worker threads and saves the final checkpoint. The results
+ *					are left in the checkpoint.
+ *
+ * Parameters:
+ * 	sweep		I/O	Sweep *	The sweep to finish
+ * 	sweepFinish	O/P	int		0 on success, -1 if a trace could not be
+ *							generated or simulated, or the checkpoint
+ *							could not be saved
+ ***********************************************************************************/
+int sweepFinish( Sweep *sweep ) {
+	const SweepConfig *config = &sweep->config;
+
+	schedulerStop(&sweep->scheduler);
+	sem_destroy(&sweep->slots);
+	pthread_mutex_destroy(&sweep->lock);
+	freeArenas(sweep);
+	if( config->checkpointPath != NULL && checkpointSave(config->checkpoint, config->checkpointPath) != 0 ) {
+		return -1;
+	}
+	return atomic_load(&sweep->failed) ? -1 : 0;
+}
+
+/***********************************************************************************
+ * void runTraceJob( Task *task, int worker )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Generates the trace of a job if it was submitted without one, then
+ *					spawns one unit per (wss, policy) on the worker's deque, from
+ *					where idle workers steal them. Units whose results are
+ *					found in the result cache are not spawned at all. For a
+ *					policy with a batched or, when sampling, approximate engine,
+ *					only its first uncached unit is spawned, and simulates every
+ *					wss of the policy at once, unless dirty pages are counted. A
+ *					lazy trace is never generated: one unit per policy pulls its
+ *					references as it goes.
+ *
+ * Parameters:
+ * 	task	I/O	Task *	The task of the trace job
+ * 	worker	I/P	int		The number of the worker running the task
+ ***********************************************************************************/
+static void runTraceJob( Task *task, int worker ) {
+	TraceJob *job = (TraceJob *)task;
+	Sweep *sweep = job->sweep;
+	const SweepConfig *config = &sweep->config;
+	int policy, wss, i = 0, missing = 0, leader[POLICY_COUNT];
+
+	// Generate trace if needed
+	if( config->lazy ) {
+		workloadSourceInit(&job->source, config->workload, config->seed, (uint64_t)job->number);
+	}
+	else if( job->trace == NULL ) {
+		PageKey *data;
+		Rng rng;
+		job->trace = traceCreate(job->number, config->length, config->hugePages, &data);
+		if( job->trace == NULL ) {
+			atomic_store(&sweep->failed, 1);
+			sem_post(&sweep->slots);
+			free(job);
+			return;
+		}
+		rngSeed(&rng, config->seed, (uint64_t)job->number);
+		workloadGenerate(config->workload, &rng, data, config->length);
+		if( config->writes > 0.0 ) {
+			uint64_t *writes = traceAddWrites(job->trace);
+			if( writes == NULL ) {
+				traceRelease(job->trace);
+				atomic_store(&sweep->failed, 1);
+				sem_post(&sweep->slots);
+				free(job);
+				return;
+			}
+			workloadWrites(&rng, config->writes, writes, config->length);
+		}
+		traceSeal(job->trace);
+	}
+
+	// Prepare units, taking the results of cached ones from the cache
+	if( config->cache != NULL ) {
+		job->hash = traceHash(job->trace);
+	}
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		leader[policy] = !config->dirty && (config->lazy || batchEngine(config, &policies[policy]) != NULL) ? -1 : 0;
+	}
+	for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+		for( policy = 0; policy < POLICY_COUNT; policy++, i++ ) {
+			job->units[i].task.run = runUnit;
+			job->units[i].job = job;
+			job->units[i].policy = policy;
+			job->units[i].wss = wss;
+			job->units[i].batch = 0;
+			job->units[i].writebacks = 0;
+			job->units[i].fills = 0;
+			job->units[i].cached = config->cache != NULL &&
+				resultCacheLookup(config->cache, job->hash, policy, wss, &job->units[i].faults);
+			if( job->units[i].cached ) {
+				continue;
+			}
+
+			// The first uncached unit of a batched policy leads the others
+			if( leader[policy] < 0 ) {
+				leader[policy] = 1;
+				job->units[i].batch = 1;
+			}
+			missing += leader[policy] == 0 || job->units[i].batch;
+		}
+	}
+
+	// Spawn missing units; the job is freed by the last one to finish
+	if( missing == 0 ) {
+		finishTrace(job);
+		return;
+	}
+	atomic_init(&job->remaining, missing);
+	for( i = 0; i < SET_SIZES * POLICY_COUNT; i++ ) {
+		if( !job->units[i].cached && (leader[job->units[i].policy] == 0 || job->units[i].batch) ) {
+			schedulerSpawn(&sweep->scheduler, worker, &job->units[i].task);
+		}
+	}
+}
+
+/***********************************************************************************
+ * void runUnit( Task *task, int worker )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Simulates one policy for one wss on one trace, adding the result
+ *					to the result cache if any, or for every uncached wss if the
+ *					unit leads a batch. The dirty engine of the policy is run
+ *					instead if dirty pages are counted. The last unit of a trace
+ *					to finish finishes the trace.
+ *
+ * Parameters:
+ * 	task	I/O	Task *	The task of the unit
+ * 	worker	I/P	int		The number of the worker running the task
+ ***********************************************************************************/
+static void runUnit( Task *task, int worker ) {
+	Unit *unit = (Unit *)task;
+	TraceJob *job = unit->job;
+	Sweep *sweep = job->sweep;
+	const SweepConfig *config = &sweep->config;
+
+	// Get # of page faults for the policy based on current wss and trace,
+	// with the policy's state in a fresh arena of the worker
+	Arena *arena = &sweep->arenas[worker];
+	arenaReset(arena);
+	if( unit->batch ) {
+		runBatch(unit, arena);
+	}
+	else if( config->dirty ) {
+		unit->faults = policies[unit->policy].dirty(unit->wss, job->trace->pages, job->trace->writes,
+													job->trace->length, &unit->writebacks, &unit->fills, arena);
+		if( unit->faults < 0 ) {
+			atomic_store(&sweep->failed, 1);
+			unit->faults = 0;
+			unit->writebacks = 0;
+			unit->fills = 0;
+		}
+	}
+	else {
+		unit->faults = policySimulate(&policies[unit->policy], unit->wss, job->trace->pages, job->trace->length,
+									  &config->engine, arena);
+		if( unit->faults < 0 ) {
+			atomic_store(&sweep->failed, 1);
+			unit->faults = 0;
+		}
+		else if( config->cache != NULL ) {
+			resultCacheStore(config->cache, job->hash, unit->policy, unit->wss, unit->faults);
+		}
+	}
+
+	// Finish the trace after its last unit
+	if( atomic_fetch_sub_explicit(&job->remaining, 1, memory_order_acq_rel) == 1 ) {
+		finishTrace(job);
+	}
+}
+
+/***********************************************************************************
+ * void runBatch( Unit *unit, Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs the batched or approximate engine of a unit's policy over
+ *					every wss in one pass, or its lazy engine for a lazy trace,
+ *					and hands each result to the uncached unit of that wss,
+ *					adding it to the result cache if any.
+ *
+ * Parameters:
+ * 	unit	I/O	Unit *	The unit leading the batch
+ * 	arena	I/O	Arena *	The arena to allocate the engine's state from
+ ***********************************************************************************/
+static void runBatch( Unit *unit, Arena *arena ) {
+	TraceJob *job = unit->job;
+	Sweep *sweep = job->sweep;
+	const SweepConfig *config = &sweep->config;
+	long faults[SET_SIZE_UPPER+1];
+	int wss, failed;
+
+	if( config->lazy ) {
+		failed = policies[unit->policy].lazy(SET_SIZE_LOWER, SET_SIZE_UPPER, &job->source.source, config->length,
+											 faults, arena) != 0;
+	}
+	else {
+		failed = batchEngine(config, &policies[unit->policy])(SET_SIZE_LOWER, SET_SIZE_UPPER, job->trace->pages,
+													   job->trace->length, faults, &config->engine, arena) != 0;
+	}
+	if( failed ) {
+		atomic_store(&sweep->failed, 1);
+	}
+	for( wss = SET_SIZE_LOWER; wss <= SET_SIZE_UPPER; wss++ ) {
+		Unit *sibling = &job->units[(wss - SET_SIZE_LOWER) * POLICY_COUNT + unit->policy];
+		if( sibling->cached ) {
+			continue;
+		}
+		sibling->faults = failed ? 0 : faults[wss];
+		if( !failed && config->cache != NULL ) {
+			resultCacheStore(config->cache, job->hash, sibling->policy, wss, sibling->faults);
+		}
+	}
+}
+
+/***********************************************************************************
+ * PolicyBatch batchEngine( const SweepConfig *config, const Policy *policy )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Gets the engine that runs a policy for every wss in one pass: its
+ *					approximate engine if sampling is configured, or else its
+ *					batched engine if the sweep enables kernels.
+ *
+ * Parameters:
+ * 	config		I/P	const SweepConfig *	The parameters of the sweep
+ * 	policy		I/P	const Policy *		The policy
+ * 	batchEngine	O/P	PolicyBatch			The engine, NULL to simulate each wss alone
+ ***********************************************************************************/
+static PolicyBatch batchEngine( const SweepConfig *config, const Policy *policy ) {
+	if( config->engine.shards.rate > 0.0 && policy->estimate != NULL ) {
+		return policy->estimate;
+	}
+	return config->engine.kernels ? policy->batch : NULL;
+}
+
+/***********************************************************************************
+ * void finishTrace( TraceJob *job )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Accumulates the faults and write-backs of every unit of a finished
+ *					trace into the checkpoint, keeps them apart if the faults of
+ *					each trace are kept, checks them for Belady's anomaly if
+ *					requested, and marks the trace finished, saving the
+ *					checkpoint if one is due. A checkpoint that cannot be saved
+ *					is retried with the next finished trace. Then saves the trace
+ *					if it is anomalous, releases it, records progress, frees the
+ *					job and frees a slot for the next trace.
+ *
+ * Parameters:
+ * 	job		I/P	TraceJob *	The job of the finished trace
+ ***********************************************************************************/
+static void finishTrace( TraceJob *job ) {
+	Sweep *sweep = job->sweep;
+	const SweepConfig *config = &sweep->config;
+	Checkpoint *checkpoint = config->checkpoint;
+	long faults[POLICY_COUNT][SET_SIZE_UPPER+1];
+	int i, anomalous = 0;
+
+	pthread_mutex_lock(&sweep->lock);
+
+	// Accumulate # of page faults of every unit
+	for( i = 0; i < SET_SIZES * POLICY_COUNT; i++ ) {
+		Unit *unit = &job->units[i];
+		faults[unit->policy][unit->wss] = unit->faults;
+		checkpoint->faults[unit->policy][unit->wss] += unit->faults;
+		checkpoint->writebacks[unit->policy][unit->wss] += unit->writebacks;
+		checkpoint->fills[unit->policy][unit->wss] += unit->fills;
+		if( config->traceFaults != NULL ) {
+			config->traceFaults[job->number].faults[unit->policy][unit->wss] = unit->faults;
+			config->traceFaults[job->number].writebacks[unit->policy][unit->wss] = unit->writebacks;
+			config->traceFaults[job->number].fills[unit->policy][unit->wss] = unit->fills;
+		}
+	}
+	if( config->belady != NULL ) {
+		anomalous = beladyCheck(config->belady, faults);
+		checkpoint->checked = config->belady->checked;
+		memcpy(checkpoint->anomalousTraces, config->belady->traces, sizeof(checkpoint->anomalousTraces));
+		memcpy(checkpoint->anomalousCells, config->belady->cells, sizeof(checkpoint->anomalousCells));
+	}
+	bitmapSet(checkpoint->done, job->number);
+	checkpoint->completed++;
+
+	// Save checkpoint if due
+	if( config->checkpointPath != NULL && sweepNow() >= sweep->nextCheckpoint &&
+		checkpointSave(checkpoint, config->checkpointPath) == 0 ) {
+		sweep->nextCheckpoint = sweepNow() + SWEEP_CHECKPOINT_MS * 1000000LL;
+	}
+
+	pthread_mutex_unlock(&sweep->lock);
+
+	// Save an offending trace outside the lock; the job still owns the trace
+	if( anomalous && beladySave(config->belady, job->trace) != 0 ) {
+		atomic_store(&sweep->failed, 1);
+	}
+
+	// Free the trace and its slot
+	if( job->trace != NULL ) {
+		traceRelease(job->trace);
+	}
+	progressAdvance(config->progress, 1);
+	free(job);
+	sem_post(&sweep->slots);
+}
+
+/***********************************************************************************
+ * long long sweepNow( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Gets the current monotonic time in nanoseconds.
+ *
+ * Parameters:
+ * 	sweepNow	O/P	long long	The current monotonic time, in nanoseconds
+ ***********************************************************************************/
+static long long sweepNow( void ) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/***********************************************************************************
+ * void freeArenas( Sweep *sweep )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Frees the arenas of the workers of a sweep.
+ *
+ * Parameters:
+ * 	sweep	I/O	Sweep *	The sweep whose arenas are freed
+ ***********************************************************************************/
+static void freeArenas( Sweep *sweep ) {
+	int i;
+	for( i = 0; i < sweep->workers; i++ ) {
+		arenaFree(&sweep->arenas[i]);
+	}
+	free(sweep->arenas);
+	sweep->arenas = NULL;
+	sweep->workers = 0;
+}
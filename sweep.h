@@ -0,0 +1,102 @@
+/***********************************************************************************
+ * File: sweep.h
+ * Author: Justin Hardy
+ * Description: Declarations for the parallel sweep, which simulates every
+ *					(trace, wss, policy) combination as its own task. See
+ *					sweep.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <semaphore.h>
+#include <pthread.h>
+#include "replaceAlgos.h"
+#include "checkpoint.h"
+#include "resultcache.h"
+#include "belady.h"
+#include "progress.h"
+#include "scheduler.h"
+#include "trace.h"
+#include "workload.h"
+
+// Sweep constants
+#define SWEEP_TRACES_PER_WORKER	2		// Traces in flight per worker thread
+#define SWEEP_CHECKPOINT_MS		10000	// Minimum time between two checkpoints
+
+// Results of one trace under every policy and wss
+typedef struct traceFaults {
+	long faults[POLICY_COUNT][SET_SIZE_UPPER+1];		// Page faults
+	long writebacks[POLICY_COUNT][SET_SIZE_UPPER+1];	// Evictions of dirty pages, when counted
+	long fills[POLICY_COUNT][SET_SIZE_UPPER+1];		// Fills of empty frames, when counted
+} TraceFaults;
+
+// Parameters of a sweep, filled in by the caller
+typedef struct sweepConfig {
+	int threads;				// Number of worker threads
+	EngineConfig engine;		// Settings of the engines simulating the policies
+	const Workload *workload;	// Workload of generated traces
+	uint64_t seed;				// Seed of generated traces
+	long length;				// Length of generated traces
+	int hugePages;				// Non-zero to back traces with huge pages
+	int lazy;					// Non-zero to pull generated references on demand instead
+								// of generating whole traces; needs no cache or detector
+	int dirty;					// Non-zero to count the evictions of dirty pages; needs
+								// no cache
+	double writes;				// Fraction of the references of generated traces that
+								// are writes; 0 to generate only reads
+	Progress *progress;			// Progress of the run, in traces, possibly shared with
+								// other sweeps
+	Checkpoint *checkpoint;		// Finished traces and their accumulated faults
+	const char *checkpointPath;	// Checkpoint file, NULL to never save one
+	ResultCache *cache;			// Cache of simulation results, NULL for none
+	Belady *belady;				// Detector of Belady's anomaly, NULL for none
+	TraceFaults *traceFaults;	// Faults of every finished trace by number, NULL to keep
+								// only the totals
+} SweepConfig;
+
+// Sweep state
+typedef struct sweep {
+	SweepConfig config;			// Parameters of the sweep
+	Scheduler scheduler;		// Scheduler running the simulations
+	sem_t slots;				// Bounds the number of traces in flight
+	atomic_int failed;			// Non-zero if a trace could not be generated
+	long long nextCheckpoint;	// Monotonic time (ns) at which the next save is due
+	Arena *arenas;				// Arena of each worker, holding the state of its simulation
+	int workers;				// Number of arenas
+	pthread_mutex_t lock;		// Protects the checkpoint and the detector
+} Sweep;
+
+// One (trace, wss, policy) simulation
+typedef struct unit {
+	Task task;					// Scheduler task
+	struct traceJob *job;		// Trace the unit belongs to
+	int policy;					// Index of the policy in policies[]
+	int wss;					// Working set size
+	long faults;				// Page faults of the simulation
+	long writebacks;			// Evictions of dirty pages, when counted
+	long fills;					// Fills of empty frames, when counted
+	int cached;					// Non-zero if the faults came from the result cache
+	int batch;					// Non-zero if the unit simulates every uncached wss of its
+								// policy in one pass, with the policy's batched engine
+} Unit;
+
+// Every simulation of one trace
+typedef struct traceJob {
+	Task task;					// Scheduler task creating the units
+	Sweep *sweep;				// Sweep the trace belongs to
+	Trace *trace;				// The trace, NULL until generated, or always when lazy
+	WorkloadSource source;		// Source of the references of a lazy trace
+	long number;				// Number of the trace within the sweep
+	uint64_t hash;				// Hash of the trace, if there is a result cache
+	atomic_int remaining;		// Units not yet finished
+	Unit units[SET_SIZES * POLICY_COUNT];	// Units of the trace
+} TraceJob;
+
+int sweepStart(Sweep*,const SweepConfig*);	// Starts a sweep
+int sweepSubmit(Sweep*,long,Trace*);		// Submits a trace to a sweep
+int sweepFinish(Sweep*);					// Waits for a sweep to finish
+
+#endif
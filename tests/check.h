@@ -0,0 +1,75 @@
+/***********************************************************************************
+ * File: check.h
+ * Author: Justin Hardy
+ * Description: A minimal harness for the test programs run by make check. CHECK
+ *					reports a failed condition with its file and line, and
+ *					checkDone ends a test program with a status counting them.
+ ***********************************************************************************/
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Number of failed checks of the test program
+static int checkFailures = 0;
+
+// Reports a condition that does not hold, and carries on
+#define CHECK(condition)	do { \
+		if( !(condition) ) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			checkFailures++; \
+		} \
+	} while( 0 )
+
+/***********************************************************************************
+ * char *checkTempFile( char path[], const char *contents, size_t size )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Creates a temporary file holding the given bytes, to be removed by
+ *					the caller.
+ *
+ * Parameters:
+ * 	path			O/P	char []			At least 32 bytes for the path of the file
+ * 	contents		I/P	const char *	The bytes of the file, NULL for none
+ * 	size			I/P	size_t			The number of bytes
+ * 	checkTempFile	O/P	char *			The path, or NULL on failure
+ ***********************************************************************************/
+static inline char *checkTempFile( char path[], const char *contents, size_t size ) {
+	int fd;
+	snprintf(path, 32, "/tmp/replaceAlgosXXXXXX");
+	fd = mkstemp(path);
+	if( fd < 0 ) {
+		return NULL;
+	}
+	if( size > 0 && write(fd, contents, size) != (ssize_t)size ) {
+		close(fd);
+		unlink(path);
+		return NULL;
+	}
+	close(fd);
+	return path;
+}
+
+/***********************************************************************************
+ * int checkDone( const char *name )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Reports the outcome of a test program.
+ *
+ * Parameters:
+ * 	name		I/P	const char *	The name of the test program
+ * 	checkDone	O/P	int				0 if every check held, 1 if not
+ ***********************************************************************************/
+static inline int checkDone( const char *name ) {
+	if( checkFailures > 0 ) {
+		printf("%s: %d checks failed\n", name, checkFailures);
+		return 1;
+	}
+	printf("%s: ok\n", name);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,225 @@
+/***********************************************************************************
+ * File: testEngines.c
+ * Author: Justin Hardy
+ * Procedures:
+ * main			- Runs the tests of the engines simulating the policies.
+ * testEngines	- Checks every engine of every policy against the plain one.
+ * testDirty	- Checks the write-backs of the dirty engines on a small trace.
+ * makeTrace	- Fills a trace of a given pattern.
+ * fillArray	- Produces the references of a trace held in an array.
+ *
+ * The plain algorithms of replaceAlgos.c are the reference: the kernels, the
+ * batched engines, serial and speculative, the lazy engines and the dirty
+ * engines must all count exactly their faults. Traces are long enough for the
+ * speculative segments and the chunked LRU distances to split them.
+ ***********************************************************************************/
+
+#include <string.h>
+#include "replaceAlgos.h"
+#include "kernels.h"
+#include "batch.h"
+#include "dirty.h"
+#include "check.h"
+
+// Test constants
+#define TEST_LENGTH		(4 * BATCH_SEGMENT + 777)	// References of every trace
+#define TEST_LOWER		2			// Smallest wss tested
+#define TEST_UPPER		40			// Largest wss tested
+#define TEST_THREADS	4			// Threads of the speculative engines
+#define TEST_PATTERNS	3			// Patterns of traces
+#define TEST_PAGES		200			// Pages of every trace, numbered from 0
+
+// A trace held in an array, as a source of references
+typedef struct arraySource {
+	PageSource source;			// The source; must come first
+	const PageKey *data;		// The references
+} ArraySource;
+
+static void testEngines(const PageKey[],long,const uint64_t[],Arena*);	// Tests every engine
+static void testDirty(Arena*);											// Tests write-backs
+static void makeTrace(PageKey[],uint64_t[],long,int);					// Fills a trace
+static void fillArray(const PageSource*,long,PageKey[],long);			// Produces references
+
+/***********************************************************************************
+ * int main( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs the tests of the engines simulating the policies on traces of
+ *					every pattern.
+ *
+ * Parameters:
+ * 	main	O/P	int	0 if every check held, 1 if not
+ ***********************************************************************************/
+int main( void ) {
+	PageKey *data = malloc(TEST_LENGTH * sizeof(PageKey));
+	uint64_t *writes = calloc(BITMAP_WORDS(TEST_LENGTH), sizeof(uint64_t));
+	Arena arena;
+	int pattern;
+
+	if( data == NULL || writes == NULL || arenaInit(&arena) != 0 ) {
+		printf("testEngines: failed to allocate\n");
+		return 1;
+	}
+	testDirty(&arena);
+	for( pattern = 0; pattern < TEST_PATTERNS; pattern++ ) {
+		makeTrace(data, writes, TEST_LENGTH, pattern);
+		testEngines(data, TEST_LENGTH, writes, &arena);
+	}
+	arenaFree(&arena);
+	free(data);
+	free(writes);
+	return checkDone("testEngines");
+}
+
+/***********************************************************************************
+ * void testEngines( const PageKey data[], long length, const uint64_t writes[],
+ *				Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Simulates a trace with every engine of every policy for every wss
+ *					from TEST_LOWER to TEST_UPPER, and checks their faults
+ *					against the plain algorithm. The dirty engines must also
+ *					fill min(wss, pages) frames, write nothing back when nothing
+ *					is written, and write back some but never more of the pages
+ *					they evict, counted as faults.
+ *
+ * Parameters:
+ * 	data	I/P	const PageKey []	The trace
+ * 	length	I/P	long				The number of references of the trace
+ * 	writes	I/P	const uint64_t []	Bitmap of the references that are writes
+ * 	arena	I/O	Arena *				The arena of the engines
+ ***********************************************************************************/
+static void testEngines( const PageKey data[], long length, const uint64_t writes[], Arena *arena ) {
+	static long plain[TEST_UPPER+1], serial[TEST_UPPER+1], speculative[TEST_UPPER+1], lazy[TEST_UPPER+1];
+	EngineConfig settings = { .kernels = 1, .threads = 1 }, parallel = { .kernels = 1, .threads = TEST_THREADS };
+	ArraySource source = { { fillArray }, data };
+	uint64_t seen[BITMAP_WORDS(TEST_PAGES)] = { 0 };
+	long writebacks, fills, pages = 0, i;
+	int policy, wss;
+
+	// Count the pages of the trace
+	for( i = 0; i < length; i++ ) {
+		if( !bitmapTest(seen, data[i]) ) {
+			bitmapSet(seen, data[i]);
+			pages++;
+		}
+	}
+
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		const Policy *p = &policies[policy];
+
+		// Batched engines, serial, speculative and lazy
+		CHECK(p->batch(TEST_LOWER, TEST_UPPER, data, length, serial, &settings, arena) == 0);
+		arenaReset(arena);
+		CHECK(p->batch(TEST_LOWER, TEST_UPPER, data, length, speculative, &parallel, arena) == 0);
+		arenaReset(arena);
+		CHECK(p->lazy(TEST_LOWER, TEST_UPPER, &source.source, length, lazy, arena) == 0);
+		arenaReset(arena);
+
+		for( wss = TEST_LOWER; wss <= TEST_UPPER; wss++ ) {
+			plain[wss] = p->run(wss, data, length, arena);
+			arenaReset(arena);
+			CHECK(plain[wss] >= 0);
+			CHECK(policySimulate(p, wss, data, length, &settings, arena) == plain[wss]);
+			arenaReset(arena);
+			CHECK(serial[wss] == plain[wss]);
+			CHECK(speculative[wss] == plain[wss]);
+			CHECK(lazy[wss] == plain[wss]);
+
+			// Dirty engines, with and without writes
+			CHECK(p->dirty(wss, data, writes, length, &writebacks, &fills, arena) == plain[wss]);
+			arenaReset(arena);
+			CHECK(writebacks <= plain[wss] && (writebacks > 0) == (plain[wss] > 0));
+			CHECK(fills == (wss < pages ? wss : pages));
+			CHECK(p->dirty(wss, data, NULL, length, &writebacks, &fills, arena) == plain[wss]);
+			arenaReset(arena);
+			CHECK(writebacks == 0);
+		}
+	}
+}
+
+/***********************************************************************************
+ * void testDirty( Arena *arena )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Checks the write-backs of the dirty engines on a trace small
+ *					enough to follow by hand: with 2 frames, pages 1 and 2 fill
+ *					them, page 3 evicts page 1, written to, and pages 1 and 2
+ *					then evict clean pages under every policy.
+ *
+ * Parameters:
+ * 	arena	I/O	Arena *	The arena of the engines
+ ***********************************************************************************/
+static void testDirty( Arena *arena ) {
+	static const PageKey data[] = { 1, 2, 3, 1, 2 };
+	uint64_t writes[1] = { 0x1 }, all[1] = { 0x1f };
+	long writebacks, fills;
+	int policy;
+
+	for( policy = 0; policy < POLICY_COUNT; policy++ ) {
+		CHECK(policies[policy].dirty(2, data, writes, 5, &writebacks, &fills, arena) == 3);
+		arenaReset(arena);
+		CHECK(writebacks == 1 && fills == 2);
+
+		// Every page evicted was written to
+		CHECK(policies[policy].dirty(2, data, all, 5, &writebacks, &fills, arena) == 3);
+		arenaReset(arena);
+		CHECK(writebacks == 3 && fills == 2);
+	}
+}
+
+/***********************************************************************************
+ * void makeTrace( PageKey data[], uint64_t writes[], long length, int pattern )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Fills a trace of pages numbered from 0 with one of three patterns:
+ *					a loop over 30 pages, uniform over 60 pages, or phases of 10
+ *					local pages moving over all TEST_PAGES. A quarter of the
+ *					references are writes.
+ *
+ * Parameters:
+ * 	data	O/P	PageKey []	The references of the trace
+ * 	writes	O/P	uint64_t []	Bitmap of the references that are writes
+ * 	length	I/P	long		The number of references
+ * 	pattern	I/P	int			The pattern, from 0 to TEST_PATTERNS - 1
+ ***********************************************************************************/
+static void makeTrace( PageKey data[], uint64_t writes[], long length, int pattern ) {
+	uint64_t state = 12345 + pattern;
+	long i;
+
+	memset(writes, 0, BITMAP_WORDS(length) * sizeof(uint64_t));
+	for( i = 0; i < length; i++ ) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		switch( pattern ) {
+			case 0:
+				data[i] = i % 30;
+				break;
+			case 1:
+				data[i] = (state >> 33) % 60;
+				break;
+			default:
+				data[i] = (i / 5000 * 7 + (state >> 33) % 10) % TEST_PAGES;
+				break;
+		}
+		if( (state >> 40) % 4 == 0 ) {
+			bitmapSet(writes, i);
+		}
+	}
+}
+
+/***********************************************************************************
+ * void fillArray( const PageSource *source, long start, PageKey block[],
+ *				long count )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Produces references of a trace held in an array.
+ *
+ * Parameters:
+ * 	source	I/P	const PageSource *	The ArraySource of the trace
+ * 	start	I/P	long				The position of the first reference
+ * 	block	O/P	PageKey []			The references
+ * 	count	I/P	long				The number of references
+ ***********************************************************************************/
+static void fillArray( const PageSource *source, long start, PageKey block[], long count ) {
+	memcpy(block, ((const ArraySource *)source)->data + start, count * sizeof(PageKey));
+}
@@ -0,0 +1,77 @@
+/***********************************************************************************
+ * File: testFormats.c
+ * Author: Justin Hardy
+ * Procedures:
+ * main			- Runs the tests of the text trace formats of other tools.
+ * testFormat	- Reads a fixture of one format and checks its accesses.
+ *
+ * The fixtures under tests/fixtures record the same accesses as Valgrind Lackey,
+ * DineroIV and perf script would, among the lines each tool adds that hold no
+ * access: Valgrind messages, escapes and flushes, and the perf header.
+ ***********************************************************************************/
+
+#include <string.h>
+#include "tracefile.h"
+#include "check.h"
+
+// Test constants
+#define TEST_ACCESSES	8		// Accesses of every fixture
+
+static void testFormat(const char*,int,uint64_t);	// Tests the fixture of a format
+
+// Addresses of the accesses of every fixture
+static const PageKey addresses[TEST_ACCESSES] = {
+	0x4678fb, 0x12b7399, 0xd0064a, 0x4fe71a, 0x6e848f, 0x7ffd1230, 0x4678fb, 0x1000
+};
+
+/***********************************************************************************
+ * int main( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs the tests of the text trace formats of other tools. The
+ *					second, third and sixth accesses are writes: stores and
+ *					modifies, DineroIV writes, and perf mem-stores samples.
+ *
+ * Parameters:
+ * 	main	O/P	int	0 if every check held, 1 if not
+ ***********************************************************************************/
+int main( void ) {
+	testFormat("tests/fixtures/small.lackey", TEXT_FORMAT_LACKEY, 0x26);
+	testFormat("tests/fixtures/small.din", TEXT_FORMAT_DINERO, 0x26);
+	testFormat("tests/fixtures/small.perf", TEXT_FORMAT_PERF, 0x26);
+	return checkDone("testFormats");
+}
+
+/***********************************************************************************
+ * void testFormat( const char *path, int format, uint64_t writes )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Reads a fixture of one format as a trace file holding a single
+ *					trace of byte addresses that tells writes from reads, and
+ *					checks its accesses.
+ *
+ * Parameters:
+ * 	path	I/P	const char *	The path of the fixture
+ * 	format	I/P	int				The format of the fixture, a TEXT_FORMAT_
+ * 	writes	I/P	uint64_t		Bitmap of the accesses that are writes
+ ***********************************************************************************/
+static void testFormat( const char *path, int format, uint64_t writes ) {
+	PageKey pages[TEST_ACCESSES];
+	uint64_t read[1];
+	TraceReader reader;
+	long length;
+
+	if( traceReaderOpen(&reader, path, format) != 0 ) {
+		fprintf(stderr, "%s: failed to open\n", path);
+		checkFailures++;
+		return;
+	}
+	CHECK(reader.traces == 1 && reader.flags == (TRACE_FLAG_ADDRESSES | TRACE_FLAG_WRITES));
+	CHECK(traceReaderNext(&reader, &length) == 1 && length == TEST_ACCESSES);
+	if( length == TEST_ACCESSES ) {
+		CHECK(traceReaderDecode(&reader, pages, read, length) == 0);
+		CHECK(memcmp(pages, addresses, sizeof(pages)) == 0);
+		CHECK(read[0] == writes);
+	}
+	traceReaderClose(&reader);
+}
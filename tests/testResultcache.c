@@ -0,0 +1,122 @@
+/***********************************************************************************
+ * File: testResultcache.c
+ * Author: Justin Hardy
+ * Procedures:
+ * main			- Runs the tests of the on-disk cache of results.
+ * testCut		- Reloads a cache file cut mid-record and appends to it.
+ * storeResults	- Records a range of results in a cache.
+ * checkResults	- Checks that a cache holds a range of results.
+ *
+ * A killed run may leave a partial record at the end of a cache file. Results
+ * stored after reopening it must read back exactly, and not shifted by the
+ * bytes of the partial record.
+ ***********************************************************************************/
+
+#include <sys/stat.h>
+#include "resultcache.h"
+#include "check.h"
+
+// Test constants
+#define TEST_FIRST_RUN	200			// Results stored by the run that is cut
+#define TEST_SECOND_RUN	50			// Results stored after reopening
+#define TEST_CUT		13			// Bytes cut off the last record
+
+static void testCut(void);										// Tests a cut cache file
+static void storeResults(ResultCache*,int,int);					// Stores results
+static void checkResults(ResultCache*,int,int);					// Checks results
+
+/***********************************************************************************
+ * int main( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs the tests of the on-disk cache of results.
+ *
+ * Parameters:
+ * 	main	O/P	int	0 if every check held, 1 if not
+ ***********************************************************************************/
+int main( void ) {
+	testCut();
+	return checkDone("testResultcache");
+}
+
+/***********************************************************************************
+ * void testCut( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Stores results in a cache file, cuts its last record in the middle,
+ *					reopens it and stores more results, then reopens it again and
+ *					checks that every result but the cut one reads back, and that
+ *					the file holds whole records only.
+ ***********************************************************************************/
+static void testCut( void ) {
+	ResultCache cache;
+	struct stat status;
+	char path[32];
+	long faults;
+
+	CHECK(checkTempFile(path, NULL, 0) != NULL);
+
+	// A run killed while appending its last record
+	CHECK(resultCacheOpen(&cache, path) == 0);
+	storeResults(&cache, 0, TEST_FIRST_RUN);
+	CHECK(resultCacheClose(&cache) == 0);
+	CHECK(stat(path, &status) == 0 && status.st_size == TEST_FIRST_RUN * CACHE_RECORD_BYTES);
+	CHECK(truncate(path, status.st_size - TEST_CUT) == 0);
+
+	// A rerun loads the whole records and appends more
+	CHECK(resultCacheOpen(&cache, path) == 0);
+	checkResults(&cache, 0, TEST_FIRST_RUN - 1);
+	CHECK(resultCacheLookup(&cache, 1, (TEST_FIRST_RUN - 1) % POLICY_COUNT, TEST_FIRST_RUN, &faults) == 0);
+	storeResults(&cache, TEST_FIRST_RUN, TEST_FIRST_RUN + TEST_SECOND_RUN);
+	CHECK(resultCacheClose(&cache) == 0);
+
+	// Every result appended after the cut reads back
+	CHECK(stat(path, &status) == 0 && status.st_size % CACHE_RECORD_BYTES == 0);
+	CHECK(resultCacheOpen(&cache, path) == 0);
+	checkResults(&cache, 0, TEST_FIRST_RUN - 1);
+	checkResults(&cache, TEST_FIRST_RUN, TEST_FIRST_RUN + TEST_SECOND_RUN);
+	CHECK(resultCacheLookup(&cache, 1, (TEST_FIRST_RUN - 1) % POLICY_COUNT, TEST_FIRST_RUN, &faults) == 0);
+	CHECK(cache.count == TEST_FIRST_RUN - 1 + TEST_SECOND_RUN);
+	CHECK(resultCacheClose(&cache) == 0);
+	unlink(path);
+}
+
+/***********************************************************************************
+ * void storeResults( ResultCache *cache, int first, int last )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Records the results of cells first to last - 1; cell i is the
+ *					wss i + 1 of policy i % POLICY_COUNT on trace 1.
+ *
+ * Parameters:
+ * 	cache	I/O	ResultCache *	The cache to record in
+ * 	first	I/P	int				The first cell
+ * 	last	I/P	int				The cell past the last one
+ ***********************************************************************************/
+static void storeResults( ResultCache *cache, int first, int last ) {
+	int i;
+	for( i = first; i < last; i++ ) {
+		resultCacheStore(cache, 1, i % POLICY_COUNT, i + 1, 7L * i + 3);
+	}
+}
+
+/***********************************************************************************
+ * void checkResults( ResultCache *cache, int first, int last )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Checks that a cache holds the results of cells first to last - 1,
+ *					as storeResults records them.
+ *
+ * Parameters:
+ * 	cache	I/O	ResultCache *	The cache to look in
+ * 	first	I/P	int				The first cell
+ * 	last	I/P	int				The cell past the last one
+ ***********************************************************************************/
+static void checkResults( ResultCache *cache, int first, int last ) {
+	long faults;
+	int i;
+	for( i = first; i < last; i++ ) {
+		faults = -1;
+		CHECK(resultCacheLookup(cache, 1, i % POLICY_COUNT, i + 1, &faults) == 1 && faults == 7L * i + 3);
+	}
+}
@@ -0,0 +1,172 @@
+/***********************************************************************************
+ * File: testTexttrace.c
+ * Author: Justin Hardy
+ * Procedures:
+ * main			- Runs the tests of plain text traces.
+ * testLines	- Parses short texts of decimal and hex lines, blanks and CRLF.
+ * testLong		- Parses many lines of every length, in uneven batches.
+ * parseText	- Parses every reference of a text, in batches of a given size.
+ *
+ * The parser finds the newlines of 64 bytes at once and the digits of a value 8
+ * bytes at a time, so the texts place lines and values across both boundaries,
+ * with values of up to 20 digits.
+ ***********************************************************************************/
+
+#include <string.h>
+#include <inttypes.h>
+#include "texttrace.h"
+#include "check.h"
+
+// Test constants
+#define TEST_MAX_REFS	4096		// Most references of one text
+#define TEST_LONG_LINES	2000		// Lines of the long text
+
+static void testLines(void);			// Tests short texts
+static void testLong(void);				// Tests a long text
+static long parseText(const char*,int,long,PageKey[],uint64_t[],int*);	// Parses a text
+
+/***********************************************************************************
+ * int main( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs the tests of plain text traces.
+ *
+ * Parameters:
+ * 	main	O/P	int	0 if every check held, 1 if not
+ ***********************************************************************************/
+int main( void ) {
+	testLines();
+	testLong();
+	return checkDone("testTexttrace");
+}
+
+/***********************************************************************************
+ * void testLines( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses short texts of decimal and hex values, with values longer
+ *					than 8 digits, surrounding blanks, CRLF line ends, trailing
+ *					blank lines and the addresses header, and checks that a line
+ *					holding no value, or a value beyond 64 bits, is rejected.
+ ***********************************************************************************/
+static void testLines( void ) {
+	static PageKey pages[TEST_MAX_REFS];
+	int addresses;
+
+	// Decimal, up to the largest 64-bit value
+	CHECK(parseText("1\n22\n333\n123456789\n12345678901234567\n18446744073709551615\n",
+					TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) == 6);
+	CHECK(pages[0] == 1 && pages[1] == 22 && pages[2] == 333 && pages[3] == 123456789);
+	CHECK(pages[4] == 12345678901234567ULL && pages[5] == UINT64_MAX && !addresses);
+
+	// Hex, of either case
+	CHECK(parseText("0x1f\n0xDeadBeef\n0x0123456789abcdef\n0xffffffffffffffff",
+					TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) == 4);
+	CHECK(pages[0] == 0x1f && pages[1] == 0xdeadbeef && pages[2] == 0x0123456789abcdefULL &&
+		  pages[3] == UINT64_MAX);
+
+	// Blanks, CRLF and trailing blank lines
+	CHECK(parseText("  7\r\n\t8 \r\n0x9\r\n100000000\r\n\r\n\n",
+					TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) == 4);
+	CHECK(pages[0] == 7 && pages[1] == 8 && pages[2] == 9 && pages[3] == 100000000);
+
+	// The addresses header, and comments before it
+	CHECK(parseText("# recorded by hand\r\n" TEXT_TRACE_ADDRESSES "\r\n4096\r\n8191\r\n",
+					TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) == 2);
+	CHECK(pages[0] == 4096 && pages[1] == 8191 && addresses);
+
+	// An empty text, and lines holding no value
+	CHECK(parseText("", TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) == 0);
+	CHECK(parseText("12\nabc\n13\n", TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) < 0);
+	CHECK(parseText("12\n\n13\n", TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) < 0);
+	CHECK(parseText("0x\n", TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) < 0);
+
+	// Decimal values beyond 64 bits, by one and by far
+	CHECK(parseText("18446744073709551616\n", TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) < 0);
+	CHECK(parseText("99999999999999999999\n", TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) < 0);
+	CHECK(parseText("1\n28446744073709551615\n", TEXT_FORMAT_PLAIN, 64, pages, NULL, &addresses) < 0);
+}
+
+/***********************************************************************************
+ * void testLong( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a text of lines holding from 1 to 20 digits, in decimal or
+ *					hex, with LF or CRLF ends, in batches that end mid-way through
+ *					the newlines of 64 bytes.
+ ***********************************************************************************/
+static void testLong( void ) {
+	static PageKey expected[TEST_LONG_LINES], pages[TEST_LONG_LINES];
+	static char text[TEST_LONG_LINES * 32];
+	uint64_t state = 1, limit;
+	int addresses, digits;
+	long i, size = 0;
+
+	// Line i holds at most i % 20 + 1 digits, in decimal for two lines in three
+	for( i = 0; i < TEST_LONG_LINES; i++ ) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		for( limit = 1, digits = 0; digits <= i % 20 && digits < 19; digits++ ) {
+			limit *= 10;
+		}
+		expected[i] = i % 20 < 19 ? state % limit : state;
+		size += sprintf(text + size, i % 3 == 0 ? "0x%" PRIx64 "%s" : "%" PRIu64 "%s", expected[i],
+						i % 2 ? "\r\n" : "\n");
+	}
+	CHECK(parseText(text, TEXT_FORMAT_PLAIN, 37, pages, NULL, &addresses) == TEST_LONG_LINES);
+	CHECK(memcmp(pages, expected, sizeof(pages)) == 0);
+}
+
+/***********************************************************************************
+ * long parseText( const char *contents, int format, long batch, PageKey pages[],
+ *				uint64_t writes[], int *addresses )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Writes a text to a temporary file, and parses every reference of
+ *					it as a text trace of the given format, at most a batch at a
+ *					time.
+ *
+ * Parameters:
+ * 	contents	I/P	const char *	The text
+ * 	format		I/P	int				The format of the text, a TEXT_FORMAT_
+ * 	batch		I/P	long			The most references parsed at once
+ * 	pages		O/P	PageKey []		The references
+ * 	writes		O/P	uint64_t []		Bitmap of the references that are writes,
+ *									NULL to discard it
+ * 	addresses	O/P	int *			Non-zero if the references are addresses
+ * 	parseText	O/P	long			The number of references, or -1 if the text
+ *									is no valid text trace
+ ***********************************************************************************/
+static long parseText( const char *contents, int format, long batch, PageKey pages[], uint64_t writes[],
+					   int *addresses ) {
+	TextTrace trace;
+	char path[32];
+	long parsed = 0, count;
+
+	if( checkTempFile(path, contents, strlen(contents)) == NULL ) {
+		return -1;
+	}
+	if( textTraceOpen(&trace, path, format) != 0 ) {
+		unlink(path);
+		return -1;
+	}
+	unlink(path);
+	*addresses = trace.addresses;
+	if( trace.references > TEST_MAX_REFS ) {
+		textTraceClose(&trace);
+		return -1;
+	}
+
+	// Batches start on a word of the write bitmap
+	batch = format == TEXT_FORMAT_PLAIN ? batch : (batch + BITMAP_BITS - 1) / BITMAP_BITS * BITMAP_BITS;
+	while( parsed < trace.references ) {
+		count = trace.references - parsed < batch ? trace.references - parsed : batch;
+		if( textTraceParse(&trace, pages + parsed, writes != NULL ? writes + parsed / BITMAP_BITS : NULL,
+						   count) != count ) {
+			textTraceClose(&trace);
+			return -1;
+		}
+		parsed += count;
+	}
+	textTraceClose(&trace);
+	return parsed;
+}
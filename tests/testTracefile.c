@@ -0,0 +1,209 @@
+/***********************************************************************************
+ * File: testTracefile.c
+ * Author: Justin Hardy
+ * Procedures:
+ * main			- Runs the tests of the binary trace file format.
+ * testBlock	- Round-trips extreme references through the varint block codec.
+ * testLz		- Round-trips bytes through the LZ compressor.
+ * testFile		- Round-trips traces through a trace file of given flags.
+ * testAddresses	- Checks that pages are written as byte addresses.
+ * makeTrace	- Fills a trace and its writes with a mix of local and far pages.
+ *
+ * Every trace written is read back exactly, with and without compression and
+ * the writes flag, including a trace spanning several blocks and traces whose
+ * write bitmaps end mid-word.
+ ***********************************************************************************/
+
+#include <string.h>
+#include "tracefile.h"
+#include "check.h"
+
+// Test constants
+#define TEST_TRACES	4			// Traces written to each file
+
+static void testBlock(void);						// Tests the block codec
+static void testLz(void);							// Tests the LZ compressor
+static void testFile(uint16_t);						// Tests a trace file
+static void testAddresses(void);					// Tests a trace file of addresses
+static void makeTrace(PageKey[],uint64_t[],long,uint64_t);	// Fills a trace
+
+// Lengths of the traces of each file; the third spans several blocks
+static const long lengths[TEST_TRACES] = { 1, 777, 2 * TRACE_BLOCK_REFS + 12345, 64 };
+
+/***********************************************************************************
+ * int main( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Runs the tests of the binary trace file format.
+ *
+ * Parameters:
+ * 	main	O/P	int	0 if every check held, 1 if not
+ ***********************************************************************************/
+int main( void ) {
+	testBlock();
+	testLz();
+	testFile(0);
+	testFile(TRACE_FLAG_COMPRESSED);
+	testFile(TRACE_FLAG_WRITES);
+	testFile(TRACE_FLAG_COMPRESSED | TRACE_FLAG_WRITES);
+	testAddresses();
+	return checkDone("testTracefile");
+}
+
+/***********************************************************************************
+ * void testBlock( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Encodes and decodes references whose differences take every size
+ *					of varint, and checks that truncated blocks are rejected.
+ ***********************************************************************************/
+static void testBlock( void ) {
+	static const PageKey pages[] = { 0, 1, UINT64_MAX, 0, (PageKey)1 << 63, 5, 4, 3, 1000000, 127, 128,
+									 UINT64_MAX - 1, 42 };
+	long count = sizeof(pages) / sizeof(pages[0]), bytes;
+	unsigned char raw[sizeof(pages) / sizeof(pages[0]) * TRACE_VARINT_MAX];
+	PageKey decoded[sizeof(pages) / sizeof(pages[0])];
+
+	bytes = traceEncodeBlock(pages, count, raw);
+	CHECK(bytes > count && bytes <= count * TRACE_VARINT_MAX);
+	CHECK(traceDecodeBlock(raw, bytes, decoded, count) == count);
+	CHECK(memcmp(decoded, pages, sizeof(pages)) == 0);
+	CHECK(traceDecodeBlock(raw, bytes - 1, decoded, count) < 0);
+}
+
+/***********************************************************************************
+ * void testLz( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Compresses and decompresses repetitive bytes, and checks that the
+ *					decompressor rejects a wrong expected size.
+ ***********************************************************************************/
+static void testLz( void ) {
+	static unsigned char in[20000], packed[20000], out[20000];
+	long i, bytes;
+
+	for( i = 0; i < (long)sizeof(in); i++ ) {
+		in[i] = (unsigned char)(i % 251 < 200 ? i % 7 : i * 37);
+	}
+	bytes = lzCompress(in, sizeof(in), packed, sizeof(packed) - 1);
+	CHECK(bytes > 0 && bytes < (long)sizeof(in));
+	CHECK(lzDecompress(packed, bytes, out, sizeof(out)) == (long)sizeof(in));
+	CHECK(memcmp(in, out, sizeof(in)) == 0);
+	CHECK(lzDecompress(packed, bytes, out, sizeof(out) - 1) < 0);
+}
+
+/***********************************************************************************
+ * void testFile( uint16_t flags )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Writes traces to a trace file of the given flags, the second one
+ *					without writes, then reads them back and compares them.
+ *					Without the writes flag every reference reads back as a read.
+ *
+ * Parameters:
+ * 	flags	I/P	uint16_t	Header flags of the file (TRACE_FLAG_*)
+ ***********************************************************************************/
+static void testFile( uint16_t flags ) {
+	long maximum = lengths[2], length;
+	PageKey *pages = malloc(maximum * sizeof(PageKey)), *decoded = malloc(maximum * sizeof(PageKey));
+	uint64_t *writes = calloc(BITMAP_WORDS(maximum), sizeof(uint64_t));
+	uint64_t *read = calloc(BITMAP_WORDS(maximum), sizeof(uint64_t));
+	TraceWriter writer;
+	TraceReader reader;
+	char path[32];
+	long i, t;
+
+	CHECK(pages != NULL && decoded != NULL && writes != NULL && read != NULL);
+	CHECK(checkTempFile(path, NULL, 0) != NULL);
+
+	// Write every trace; the second has no writes
+	CHECK(traceWriterOpen(&writer, path, flags, 0) == 0);
+	for( t = 0; t < TEST_TRACES; t++ ) {
+		makeTrace(pages, writes, lengths[t], t);
+		CHECK(traceWriterAppend(&writer, pages, t == 1 ? NULL : writes, lengths[t]) == 0);
+	}
+	CHECK(traceWriterClose(&writer) == 0);
+
+	// Read them back
+	CHECK(traceReaderOpen(&reader, path, TEXT_FORMAT_PLAIN) == 0);
+	CHECK(reader.flags == flags && reader.traces == TEST_TRACES);
+	for( t = 0; t < TEST_TRACES; t++ ) {
+		makeTrace(pages, writes, lengths[t], t);
+		CHECK(traceReaderNext(&reader, &length) == 1 && length == lengths[t]);
+		CHECK(traceReaderDecode(&reader, decoded, read, length) == 0);
+		CHECK(memcmp(decoded, pages, length * sizeof(PageKey)) == 0);
+		for( i = 0; i < length; i++ ) {
+			if( bitmapTest(read, i) != ((flags & TRACE_FLAG_WRITES) && t != 1 && bitmapTest(writes, i)) ) {
+				break;
+			}
+		}
+		CHECK(i == length);
+	}
+	CHECK(traceReaderNext(&reader, &length) == 0);
+	traceReaderClose(&reader);
+
+	unlink(path);
+	free(pages);
+	free(decoded);
+	free(writes);
+	free(read);
+}
+
+/***********************************************************************************
+ * void testAddresses( void )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Writes a trace of pages to a trace file of 2 MiB page addresses,
+ *					and checks that the file holds the address of the first byte
+ *					of every page.
+ ***********************************************************************************/
+static void testAddresses( void ) {
+	static const PageKey pages[] = { 0, 1, 7, 3, 1 };
+	long count = sizeof(pages) / sizeof(pages[0]), length, i;
+	PageKey decoded[sizeof(pages) / sizeof(pages[0])];
+	TraceWriter writer;
+	TraceReader reader;
+	char path[32];
+
+	CHECK(checkTempFile(path, NULL, 0) != NULL);
+	CHECK(traceWriterOpen(&writer, path, TRACE_FLAG_ADDRESSES, PAGE_SHIFT_2M) == 0);
+	CHECK(traceWriterAppend(&writer, pages, NULL, count) == 0);
+	CHECK(traceWriterClose(&writer) == 0);
+	CHECK(traceReaderOpen(&reader, path, TEXT_FORMAT_PLAIN) == 0);
+	CHECK(reader.flags == TRACE_FLAG_ADDRESSES);
+	CHECK(traceReaderNext(&reader, &length) == 1 && length == count);
+	CHECK(traceReaderDecode(&reader, decoded, NULL, length) == 0);
+	for( i = 0; i < count; i++ ) {
+		CHECK(decoded[i] == pages[i] << PAGE_SHIFT_2M);
+	}
+	traceReaderClose(&reader);
+	unlink(path);
+}
+
+/***********************************************************************************
+ * void makeTrace( PageKey pages[], uint64_t writes[], long length, uint64_t seed )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Fills a trace with a walk over nearby pages broken by far jumps,
+ *					and marks a pseudo-random third of its references as writes.
+ *
+ * Parameters:
+ * 	pages	O/P	PageKey []	The references of the trace
+ * 	writes	O/P	uint64_t []	Bitmap of the references that are writes
+ * 	length	I/P	long		The number of references
+ * 	seed	I/P	uint64_t	Selects the trace
+ ***********************************************************************************/
+static void makeTrace( PageKey pages[], uint64_t writes[], long length, uint64_t seed ) {
+	uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 1, page = 1000;
+	long i;
+
+	memset(writes, 0, BITMAP_WORDS(length) * sizeof(uint64_t));
+	for( i = 0; i < length; i++ ) {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		page = (state >> 60) == 0 ? state : page + (state >> 61) - 3;
+		pages[i] = page;
+		if( (state >> 33) % 3 == 0 ) {
+			bitmapSet(writes, i);
+		}
+	}
+}
@@ -0,0 +1,767 @@
+/***********************************************************************************
+ * File: texttrace.c
+ * Author: Justin Hardy
+ * Procedures:
+ * textTraceOpen	- Maps a text trace, reads its header and counts its lines.
+ * textTraceParse	- Parses the next references of a text trace.
+ * textTraceClose	- Unmaps a text trace.
+ * textFormatParse	- Parses the name of a text trace format.
+ * countRecords		- Counts the references of a text trace of another tool.
+ * parseRecord		- Parses the line of a text trace of another tool.
+ * parseLackey		- Parses a line of Valgrind Lackey output.
+ * parseDinero		- Parses a DineroIV din record.
+ * parsePerf		- Parses a line of perf script output.
+ * parseLine		- Parses the value of one line.
+ * countLines		- Counts the newlines of a range of text.
+ * newlineMask		- Finds the newlines of 64 bytes of text.
+ * loadWord			- Loads up to 8 bytes of text as a little-endian word.
+ * nonDigits		- Finds the bytes of a word that are not decimal digits.
+ * decimalChunk		- Combines up to 8 decimal digits.
+ * parseDecimal		- Parses a decimal value 8 digits at a time.
+ * parseHex			- Parses a hex value 8 digits at a time.
+ *
+ * A text trace holds one reference per line, in decimal, or in hex after a 0x
+ * prefix, optionally surrounded by blanks and ended by CRLF. Lines starting with
+ * # at the top of the file are a header, ignored except for "# addresses",
+ * which marks the values as byte addresses instead of pages; any other line
+ * must hold a value, though blank lines may end the file. The file is mapped
+ * rather than read, and parsed in two passes over the mapping, both finding the
+ * newlines of 64 bytes at once as a bitmask, with SSE2 where available and SWAR
+ * bit tricks otherwise. The first pass only counts them, so that the length of
+ * the trace is known before its references are. The second takes the lines of
+ * each 64 bytes from the bitmask, so that where a line ends never waits for the
+ * line before it to be parsed, and parses their values 8 bytes at a time,
+ * finding the end of the digits with a mask of the non-digit bytes and
+ * converting them with three multiplications, without a branch or a table
+ * lookup per digit. A line of at most 8 digits alone, by far the most common,
+ * takes a single word.
+ *
+ * With --format, text traces are instead read as the memory accesses recorded
+ * by another tool, as byte addresses, one reference per access:
+ *	lackey	- Valgrind --tool=lackey --trace-mem=yes output: instruction fetches
+ *			  ("I  addr,size") and loads, stores and modifies (" L addr,size",
+ *			  " S", " M"); the ==pid== messages of Valgrind are ignored.
+ *	dinero	- DineroIV din records ("label addr"): reads (0), writes (1) and
+ *			  instruction fetches (2); escapes (3) and flushes (4) are ignored.
+ *	perf	- perf script output of memory samples, such as perf mem record:
+ *			  the data address is the token after the event name, the first
+ *			  token ending in ':' that does not start with a digit, or the first
+ *			  token of lines without one, as printed by perf script -F addr.
+ * Addresses are in hex, with or without a 0x prefix; an access is counted once,
+ * at its first byte, and stores, modifies and DineroIV writes are writes.
+ * Which lines hold an access is only known once they are parsed, so the first
+ * pass parses every line too, without keeping the values.
+ ***********************************************************************************/
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "texttrace.h"
+
+// Bytes of a word, repeated across its 8 lanes
+#define WORD_BYTES(byte)	(0x0101010101010101ULL * (byte))
+
+static int parseLine(const char*,const char*,const char*,uint64_t*);	// Parses one line
+static long countRecords(const TextTrace*);						// Counts the references of a tool
+static int parseRecord(int,const char*,const char*,uint64_t*,int*);	// Parses the line of a tool
+static int parseLackey(const char*,const char*,uint64_t*,int*);		// Parses Lackey output
+static int parseDinero(const char*,const char*,uint64_t*,int*);		// Parses a din record
+static int parsePerf(const char*,const char*,uint64_t*,int*);		// Parses perf script output
+static long countLines(const char*,const char*);		// Counts newlines
+static uint64_t newlineMask(const char*);				// Finds the newlines of 64 bytes
+static uint64_t loadWord(const char*,const char*);		// Loads up to 8 bytes
+static uint64_t nonDigits(uint64_t);					// Finds the non-digit bytes
+static uint64_t decimalChunk(uint64_t,int);				// Combines up to 8 digits
+static int parseDecimal(const char**,const char*,uint64_t*);	// Parses a decimal value
+static int parseHex(const char**,const char*,uint64_t*);		// Parses a hex value
+
+// Names of the formats, in TEXT_FORMAT_* order
+static const char *const formatNames[TEXT_FORMATS] = { "plain", "lackey", "dinero", "perf" };
+
+// Powers of ten by number of digits of a chunk
+static const uint64_t powers[9] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+/***********************************************************************************
+ * int textTraceOpen( TextTrace *trace, const char *path, int format )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Maps a text trace of a given format, reads its header and counts
+ *					its references. The first reference is parsed as well, so
+ *					that a file that is no text trace at all is rejected when
+ *					it is opened; the traces of other tools are parsed in full.
+ *
+ * Parameters:
+ * 	trace			O/P	TextTrace *		The text trace to open
+ * 	path			I/P	const char *	The path of the file to open
+ * 	format			I/P	int				The format of the lines, a TEXT_FORMAT_
+ * 	textTraceOpen	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int textTraceOpen( TextTrace *trace, const char *path, int format ) {
+	struct stat info;
+	const char *end, *newline;
+	TextTrace probe;
+	PageKey first;
+	size_t length;
+	void *map;
+	int fd;
+
+	// Map the whole file; an empty file cannot be mapped, and holds no reference
+	memset(trace, 0, sizeof(*trace));
+	trace->format = format;
+	fd = open(path, O_RDONLY);
+	if( fd < 0 ) {
+		return -1;
+	}
+	if( fstat(fd, &info) != 0 ) {
+		close(fd);
+		return -1;
+	}
+	trace->size = (size_t)info.st_size;
+	if( trace->size > 0 ) {
+		map = mmap(NULL, trace->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if( map == MAP_FAILED ) {
+			close(fd);
+			return -1;
+		}
+		madvise(map, trace->size, MADV_SEQUENTIAL);
+		trace->data = map;
+	}
+	close(fd);
+
+	// Read the header
+	trace->next = trace->data;
+	end = trace->data + trace->size;
+	while( trace->next < end && *trace->next == TEXT_TRACE_COMMENT ) {
+		newline = memchr(trace->next, '\n', end - trace->next);
+		length = (newline != NULL ? newline : end) - trace->next;
+		if( length > 0 && trace->next[length - 1] == '\r' ) {
+			length--;
+		}
+		if( length == strlen(TEXT_TRACE_ADDRESSES) && memcmp(trace->next, TEXT_TRACE_ADDRESSES, length) == 0 ) {
+			trace->addresses = 1;
+		}
+		trace->next = newline != NULL ? newline + 1 : end;
+	}
+
+	// Every line holds one reference, up to the last one; trailing blank lines
+	// are ignored
+	while( end > trace->next && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t') ) {
+		end--;
+	}
+	trace->end = end;
+
+	// The traces of other tools hold byte addresses, on only some of their lines
+	if( trace->format != TEXT_FORMAT_PLAIN ) {
+		trace->addresses = 1;
+		trace->references = countRecords(trace);
+		if( trace->references < 0 ) {
+			textTraceClose(trace);
+			return -1;
+		}
+		return 0;
+	}
+	trace->references = trace->next < end ? countLines(trace->next, end) + 1 : 0;
+	probe = *trace;
+	if( trace->references > 0 && textTraceParse(&probe, &first, NULL, 1) != 1 ) {
+		textTraceClose(trace);
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * long textTraceParse( TextTrace *trace, PageKey pages[], uint64_t writes[],
+ *				long count )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses the next references of a text trace, and which of them are
+ *					writes; those of plain text traces are all reads.
+ *
+ * Parameters:
+ * 	trace			I/O	TextTrace *	The text trace to parse
+ * 	pages			O/P	PageKey []	The references parsed
+ * 	writes			O/P	uint64_t []	Bitmap of the references parsed that are
+ *									writes, NULL to discard it
+ * 	count			I/P	long		The most references to parse
+ * 	textTraceParse	O/P	long		The number of references parsed, fewer than
+ *									count only at the end of the file; -1 if a
+ *									line holds no valid value
+ ***********************************************************************************/
+long textTraceParse( TextTrace *trace, PageKey pages[], uint64_t writes[], long count ) {
+	const char *p = trace->next, *end = trace->end, *line, *newline;
+	uint64_t mask, value;
+	long i = 0;
+	int status, write;
+
+	if( writes != NULL ) {
+		memset(writes, 0, BITMAP_WORDS(count) * sizeof(uint64_t));
+	}
+
+	// Keep the lines of the traces of other tools that hold an access
+	if( trace->format != TEXT_FORMAT_PLAIN ) {
+		while( i < count && p < end ) {
+			newline = memchr(p, '\n', end - p);
+			newline = newline != NULL ? newline : end;
+			status = parseRecord(trace->format, p, newline, &value, &write);
+			if( status < 0 ) {
+				return -1;
+			}
+			if( status > 0 ) {
+				if( write && writes != NULL ) {
+					bitmapSet(writes, i);
+				}
+				pages[i++] = value;
+			}
+			p = newline + (newline < end);
+		}
+		trace->next = p;
+		return i;
+	}
+
+	// Parse the lines ending within each 64 bytes, as long as any does and a
+	// word can be loaded past the last of them
+	while( i < count && end - p >= 64 + 8 ) {
+		mask = newlineMask(p);
+		for( line = p; mask != 0 && i < count; mask &= mask - 1 ) {
+			newline = p + __builtin_ctzll(mask);
+			if( parseLine(line, newline, end, &pages[i]) != 0 ) {
+				return -1;
+			}
+			i++;
+			line = newline + 1;
+		}
+		if( line == p ) {
+			break;
+		}
+		p = line;
+	}
+
+	// Parse the rest one line at a time
+	for( ; i < count && p < end; i++ ) {
+		newline = memchr(p, '\n', end - p);
+		newline = newline != NULL ? newline : end;
+		if( parseLine(p, newline, end, &pages[i]) != 0 ) {
+			return -1;
+		}
+		p = newline + (newline < end);
+	}
+	trace->next = p;
+	return i;
+}
+
+/***********************************************************************************
+ * int parseLine( const char *p, const char *newline, const char *end,
+ *				uint64_t *value )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses the value of one line, in decimal, or in hex after a 0x
+ *					prefix, with nothing but blanks around it.
+ *
+ * Parameters:
+ * 	p			I/P	const char *	The start of the line
+ * 	newline		I/P	const char *	The end of the line
+ * 	end			I/P	const char *	The end of the text
+ * 	value		O/P	uint64_t *		The value
+ * 	parseLine	O/P	int				0 on success, -1 if the line holds no value
+ ***********************************************************************************/
+static inline int parseLine( const char *p, const char *newline, const char *end, uint64_t *value ) {
+	uint64_t word = loadWord(p, end), other = nonDigits(word);
+	int digits = other != 0 ? __builtin_ctzll(other) / 8 : 8;
+
+	// A line of at most 8 digits alone is a single chunk
+	if( digits == newline - p && digits > 0 ) {
+		*value = decimalChunk(word, digits);
+		return 0;
+	}
+
+	// Parse any other line in full, after any leading blanks
+	while( p < newline && (*p == ' ' || *p == '\t') ) {
+		p++;
+	}
+	if( newline - p > 2 && p[0] == '0' && (p[1] | 0x20) == 'x' ) {
+		p += 2;
+		if( parseHex(&p, newline, value) != 0 ) {
+			return -1;
+		}
+	}
+	else if( parseDecimal(&p, newline, value) != 0 ) {
+		return -1;
+	}
+
+	// Nothing but blanks may follow it
+	while( p < newline && (*p == ' ' || *p == '\t' || *p == '\r') ) {
+		p++;
+	}
+	return p == newline ? 0 : -1;
+}
+
+/***********************************************************************************
+ * void textTraceClose( TextTrace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Unmaps a text trace.
+ *
+ * Parameters:
+ * 	trace	I/O	TextTrace *	The text trace to close
+ ***********************************************************************************/
+void textTraceClose( TextTrace *trace ) {
+	if( trace->data != NULL ) {
+		munmap(trace->data, trace->size);
+	}
+	memset(trace, 0, sizeof(*trace));
+}
+
+/***********************************************************************************
+ * int textFormatParse( const char *name, int *format )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses the name of a text trace format: plain, lackey, dinero or
+ *					perf.
+ *
+ * Parameters:
+ * 	name			I/P	const char *	The name to be parsed
+ * 	format			O/P	int *			The format, one of TEXT_FORMAT_*
+ * 	textFormatParse	O/P	int				0 on success, -1 if name is unknown
+ ***********************************************************************************/
+int textFormatParse( const char *name, int *format ) {
+	int i;
+
+	for( i = 0; i < TEXT_FORMATS; i++ ) {
+		if( strcmp(name, formatNames[i]) == 0 ) {
+			*format = i;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/***********************************************************************************
+ * long countRecords( const TextTrace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Counts the references of a text trace of another tool, parsing
+ *					every line.
+ *
+ * Parameters:
+ * 	trace			I/P	const TextTrace *	The text trace, its header read
+ * 	countRecords	O/P	long				The number of references, -1 if a
+ *											line is invalid
+ ***********************************************************************************/
+static long countRecords( const TextTrace *trace ) {
+	const char *p = trace->next, *end = trace->end, *newline;
+	uint64_t value;
+	long records = 0;
+	int status, write;
+
+	while( p < end ) {
+		newline = memchr(p, '\n', end - p);
+		newline = newline != NULL ? newline : end;
+		status = parseRecord(trace->format, p, newline, &value, &write);
+		if( status < 0 ) {
+			return -1;
+		}
+		records += status;
+		p = newline + (newline < end);
+	}
+	return records;
+}
+
+/***********************************************************************************
+ * int parseRecord( int format, const char *p, const char *newline,
+ *				uint64_t *address, int *write )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses the line of a text trace of another tool.
+ *
+ * Parameters:
+ * 	format		I/P	int				The format of the line, other than plain
+ * 	p			I/P	const char *	The start of the line
+ * 	newline		I/P	const char *	The end of the line
+ * 	address		O/P	uint64_t *		The address accessed, if any
+ * 	write		O/P	int *			Non-zero if the access is a write
+ * 	parseRecord	O/P	int				1 if the line holds an access, 0 if it
+ *									holds none, -1 if it is invalid
+ ***********************************************************************************/
+static int parseRecord( int format, const char *p, const char *newline, uint64_t *address, int *write ) {
+	// Lines ended by CRLF end before the CR
+	if( newline > p && newline[-1] == '\r' ) {
+		newline--;
+	}
+	switch( format ) {
+		case TEXT_FORMAT_LACKEY:
+			return parseLackey(p, newline, address, write);
+		case TEXT_FORMAT_DINERO:
+			return parseDinero(p, newline, address, write);
+		default:
+			return parsePerf(p, newline, address, write);
+	}
+}
+
+/***********************************************************************************
+ * int parseLackey( const char *p, const char *newline, uint64_t *address,
+ *				int *write )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a line of Valgrind --tool=lackey --trace-mem=yes output:
+ *					"I  addr,size" for an instruction fetch, or " L", " S" or
+ *					" M" then "addr,size" for a load, store or modify, the
+ *					latter two writes. Messages of Valgrind, starting with ==,
+ *					and blank lines hold none.
+ *
+ * Parameters:
+ * 	p			I/P	const char *	The start of the line
+ * 	newline		I/P	const char *	The end of the line
+ * 	address		O/P	uint64_t *		The address accessed, if any
+ * 	write		O/P	int *			Non-zero if the access is a write
+ * 	parseLackey	O/P	int				1 if the line holds an access, 0 if it
+ *									holds none, -1 if it is invalid
+ ***********************************************************************************/
+static int parseLackey( const char *p, const char *newline, uint64_t *address, int *write ) {
+	// Find the kind of the line
+	if( newline - p >= 3 && ((p[0] == 'I' && p[1] == ' ') ||
+		(p[0] == ' ' && (p[1] == 'L' || p[1] == 'S' || p[1] == 'M') && p[2] == ' ')) ) {
+		*write = p[1] == 'S' || p[1] == 'M';
+
+		// Parse the address, which the size follows
+		for( p += 2; p < newline && *p == ' '; p++ );
+		if( parseHex(&p, newline, address) != 0 || p == newline || *p != ',' ) {
+			return -1;
+		}
+		return 1;
+	}
+	if( newline - p >= 2 && p[0] == '=' && p[1] == '=' ) {
+		return 0;
+	}
+	for( ; p < newline && (*p == ' ' || *p == '\t'); p++ );
+	return p == newline ? 0 : -1;
+}
+
+/***********************************************************************************
+ * int parseDinero( const char *p, const char *newline, uint64_t *address,
+ *				int *write )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a DineroIV din record, "label addr" and possibly a size,
+ *					where the label is 0 for a read, 1 for a write, 2 for an
+ *					instruction fetch, 3 for an escape and 4 for a flush. Only
+ *					reads, writes and fetches, and no blank line, hold accesses.
+ *
+ * Parameters:
+ * 	p			I/P	const char *	The start of the line
+ * 	newline		I/P	const char *	The end of the line
+ * 	address		O/P	uint64_t *		The address accessed, if any
+ * 	write		O/P	int *			Non-zero if the access is a write
+ * 	parseDinero	O/P	int				1 if the line holds an access, 0 if it
+ *									holds none, -1 if it is invalid
+ ***********************************************************************************/
+static int parseDinero( const char *p, const char *newline, uint64_t *address, int *write ) {
+	int label;
+
+	// Parse the label
+	for( ; p < newline && (*p == ' ' || *p == '\t'); p++ );
+	if( p == newline ) {
+		return 0;
+	}
+	label = *p++ - '0';
+	if( label < 0 || label > 4 || p == newline || (*p != ' ' && *p != '\t') ) {
+		return -1;
+	}
+
+	// Parse the address, which anything may follow after a blank
+	for( ; p < newline && (*p == ' ' || *p == '\t'); p++ );
+	if( newline - p > 2 && p[0] == '0' && (p[1] | 0x20) == 'x' ) {
+		p += 2;
+	}
+	if( parseHex(&p, newline, address) != 0 || (p < newline && *p != ' ' && *p != '\t') ) {
+		return -1;
+	}
+	*write = label == 1;
+	return label <= 2;
+}
+
+/***********************************************************************************
+ * int parsePerf( const char *p, const char *newline, uint64_t *address,
+ *				int *write )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a line of perf script output of memory samples, such as
+ *					"comm pid [cpu] time: period event: addr ...". The address
+ *					is the token after the event name, the first token ending in
+ *					':' that does not start with a digit as times do, or the
+ *					first token of a line without one, as printed by perf
+ *					script -F addr. The access is a write if the event name
+ *					holds "store", as mem-stores does. Blank lines hold none.
+ *
+ * Parameters:
+ * 	p			I/P	const char *	The start of the line
+ * 	newline		I/P	const char *	The end of the line
+ * 	address		O/P	uint64_t *		The address accessed, if any
+ * 	write		O/P	int *			Non-zero if the access is a write
+ * 	parsePerf	O/P	int				1 if the line holds an access, 0 if it
+ *									holds none, -1 if it is invalid
+ ***********************************************************************************/
+static int parsePerf( const char *p, const char *newline, uint64_t *address, int *write ) {
+	const char *token, *first = NULL, *value = NULL;
+
+	*write = 0;
+	// Find the token after the event name
+	while( value == NULL ) {
+		for( ; p < newline && (*p == ' ' || *p == '\t'); p++ );
+		if( p == newline ) {
+			break;
+		}
+		for( token = p; p < newline && *p != ' ' && *p != '\t'; p++ );
+		if( first == NULL ) {
+			first = token;
+		}
+		if( p[-1] == ':' && !(*token >= '0' && *token <= '9') ) {
+			for( ; token + 5 <= p && !*write; token++ ) {
+				*write = memcmp(token, "store", 5) == 0;
+			}
+			for( ; p < newline && (*p == ' ' || *p == '\t'); p++ );
+			value = p;
+		}
+	}
+	if( first == NULL ) {
+		return 0;
+	}
+
+	// Parse the address, which anything may follow after a blank
+	p = value != NULL ? value : first;
+	if( newline - p > 2 && p[0] == '0' && (p[1] | 0x20) == 'x' ) {
+		p += 2;
+	}
+	if( parseHex(&p, newline, address) != 0 || (p < newline && *p != ' ' && *p != '\t') ) {
+		return -1;
+	}
+	return 1;
+}
+
+/***********************************************************************************
+ * long countLines( const char *p, const char *end )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Counts the newlines of a range of text, 64 bytes at a time.
+ *
+ * Parameters:
+ * 	p			I/P	const char *	The start of the text
+ * 	end			I/P	const char *	The end of the text
+ * 	countLines	O/P	long			The number of newlines
+ ***********************************************************************************/
+static long countLines( const char *p, const char *end ) {
+	long lines = 0;
+
+	for( ; end - p >= 64; p += 64 ) {
+		lines += __builtin_popcountll(newlineMask(p));
+	}
+	for( ; p < end; p++ ) {
+		lines += *p == '\n';
+	}
+	return lines;
+}
+
+/***********************************************************************************
+ * uint64_t newlineMask( const char *p )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Finds the newlines of 64 bytes of text, comparing 16 bytes at a
+ *					time with SSE2 where available. Otherwise, the newlines of
+ *					each 8 bytes are the zero bytes of the word XORed with
+ *					newlines: a byte is zero iff adding 0x7F to its low 7 bits
+ *					does not set its top bit, and neither is it already set. One
+ *					multiplication then gathers the top bits of the 8 bytes.
+ *
+ * Parameters:
+ * 	p			I/P	const char *	The start of the 64 bytes
+ * 	newlineMask	O/P	uint64_t		Bit i set iff byte i is a newline
+ ***********************************************************************************/
+static inline uint64_t newlineMask( const char *p ) {
+	uint64_t mask = 0;
+	int i;
+
+#ifdef __SSE2__
+	const __m128i newlines = _mm_set1_epi8('\n');
+	for( i = 0; i < 64; i += 16 ) {
+		__m128i block = _mm_loadu_si128((const __m128i*)(p + i));
+		mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newlines)) << i;
+	}
+#else
+	uint64_t word;
+	for( i = 0; i < 64; i += 8 ) {
+		memcpy(&word, p + i, 8);
+		word ^= WORD_BYTES('\n');
+		word = ~(((word & WORD_BYTES(0x7F)) + WORD_BYTES(0x7F)) | word) & WORD_BYTES(0x80);
+		mask |= ((word >> 7) * 0x0102040810204080ULL) >> 56 << i;
+	}
+#endif
+	return mask;
+}
+
+/***********************************************************************************
+ * uint64_t loadWord( const char *p, const char *end )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Loads the next 8 bytes of text as a little-endian word, padded with
+ *					zero bytes past the end of the text, which are never digits.
+ *
+ * Parameters:
+ * 	p			I/P	const char *	The start of the bytes
+ * 	end			I/P	const char *	The end of the text
+ * 	loadWord	O/P	uint64_t		The bytes, the first in the lowest byte
+ ***********************************************************************************/
+static inline uint64_t loadWord( const char *p, const char *end ) {
+	uint64_t word = 0;
+	if( end - p >= 8 ) {
+		memcpy(&word, p, 8);
+	}
+	else {
+		memcpy(&word, p, end - p);
+	}
+	return word;
+}
+
+/***********************************************************************************
+ * uint64_t nonDigits( uint64_t word )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Finds the bytes of a word that are not decimal digits. A byte is a
+ *					digit iff it is below 10 once XORed with '0', which adding
+ *					0x76 to its low 7 bits tells without carrying into the next
+ *					byte.
+ *
+ * Parameters:
+ * 	word		I/P	uint64_t	The bytes
+ * 	nonDigits	O/P	uint64_t	The top bit of every byte that is not a digit
+ ***********************************************************************************/
+static inline uint64_t nonDigits( uint64_t word ) {
+	uint64_t other = word ^ WORD_BYTES('0');
+	return (((other & WORD_BYTES(0x7F)) + WORD_BYTES(0x76)) | other) & WORD_BYTES(0x80);
+}
+
+/***********************************************************************************
+ * uint64_t decimalChunk( uint64_t word, int digits )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Combines the decimal digits at the start of a word. The digits are
+ *					aligned to the top of the word, so that the bytes below are
+ *					leading zeros, and pairs, quads and octets of digits are then
+ *					combined by one multiplication each.
+ *
+ * Parameters:
+ * 	word			I/P	uint64_t	The bytes, the first in the lowest byte
+ * 	digits			I/P	int			The number of digits, from 1 to 8
+ * 	decimalChunk	O/P	uint64_t	The value of the digits
+ ***********************************************************************************/
+static inline uint64_t decimalChunk( uint64_t word, int digits ) {
+	word = (word & WORD_BYTES(0x0F)) << (8 * (8 - digits));
+	word = (word * (10 * 256 + 1)) >> 8;
+	word = ((word & 0x00FF00FF00FF00FFULL) * (100 * 65536 + 1)) >> 16;
+	return ((word & 0x0000FFFF0000FFFFULL) * (10000 * 4294967296ULL + 1)) >> 32;
+}
+
+/***********************************************************************************
+ * int parseDecimal( const char **text, const char *end, uint64_t *value )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a decimal value 8 digits at a time. Only values of 20
+ *					digits can exceed 64 bits, so only their last chunk is checked
+ *					for overflow.
+ *
+ * Parameters:
+ * 	text			I/O	const char **	The start of the value, moved past it
+ * 	end				I/P	const char *	The end of the text
+ * 	value			O/P	uint64_t *		The value
+ * 	parseDecimal	O/P	int				0 on success, -1 if there are no digits,
+ *										more than TEXT_TRACE_DIGITS, or the value
+ *										exceeds 64 bits
+ ***********************************************************************************/
+static int parseDecimal( const char **text, const char *end, uint64_t *value ) {
+	const char *p = *text;
+	uint64_t result = 0, word, other;
+	int digits, total = 0;
+
+	do {
+		// Find and combine the digits of the next chunk
+		word = loadWord(p, end);
+		other = nonDigits(word);
+		digits = other != 0 ? __builtin_ctzll(other) / 8 : 8;
+		if( digits == 0 ) {
+			break;
+		}
+		if( total + digits < TEXT_TRACE_DIGITS ) {
+			result = result * powers[digits] + decimalChunk(word, digits);
+		}
+		else if( __builtin_mul_overflow(result, powers[digits], &result) ||
+				 __builtin_add_overflow(result, decimalChunk(word, digits), &result) ) {
+			return -1;
+		}
+		p += digits;
+		total += digits;
+	} while( digits == 8 && total <= TEXT_TRACE_DIGITS );
+
+	if( total == 0 || total > TEXT_TRACE_DIGITS ) {
+		return -1;
+	}
+	*text = p;
+	*value = result;
+	return 0;
+}
+
+/***********************************************************************************
+ * int parseHex( const char **text, const char *end, uint64_t *value )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a hex value 8 digits at a time, as parseDecimal does. A byte
+ *					is a hex digit if it is a decimal digit, or a letter from a
+ *					to f in either case once its case bit is set; the value of
+ *					each digit is its low nibble, plus 9 for letters, and the
+ *					nibbles are packed into bytes, then the bytes into a word.
+ *
+ * Parameters:
+ * 	text		I/O	const char **	The start of the digits, moved past them
+ * 	end			I/P	const char *	The end of the text
+ * 	value		O/P	uint64_t *		The value
+ * 	parseHex	O/P	int				0 on success, -1 if there are no digits or
+ *									more than 16
+ ***********************************************************************************/
+static int parseHex( const char **text, const char *end, uint64_t *value ) {
+	const char *p = *text;
+	uint64_t result = 0, word, decimal, letter, low;
+	int digits, total = 0;
+
+	do {
+		// Find the digits of the next chunk: letters XOR 'a' - 1 are from 1 to 6
+		word = loadWord(p, end);
+		decimal = nonDigits(word);
+		letter = (word | WORD_BYTES(0x20)) ^ WORD_BYTES(0x60);
+		low = letter & WORD_BYTES(0x7F);
+		letter = (low + WORD_BYTES(0x79)) | letter | ~(low + WORD_BYTES(0x7F));
+		decimal &= letter;
+		digits = decimal != 0 ? __builtin_ctzll(decimal) / 8 : 8;
+		if( digits == 0 ) {
+			break;
+		}
+
+		// Combine the digits of the chunk
+		word = (word & WORD_BYTES(0x0F)) + ((word >> 6) & WORD_BYTES(0x01)) * 9;
+		word <<= 8 * (8 - digits);
+		word = ((word & 0x000F000F000F000FULL) << 4) | ((word & 0x0F000F000F000F00ULL) >> 8);
+		word = (word | (word >> 8)) & 0x0000FFFF0000FFFFULL;
+		word = (word | (word >> 16)) & 0xFFFFFFFFULL;
+		result = (result << (4 * digits)) | __builtin_bswap32((uint32_t)word);
+		p += digits;
+		total += digits;
+	} while( digits == 8 && total <= 16 );
+
+	if( total == 0 || total > 16 ) {
+		return -1;
+	}
+	*text = p;
+	*value = result;
+	return 0;
+}
@@ -0,0 +1,45 @@
+/***********************************************************************************
+ * File: texttrace.h
+ * Author: Justin Hardy
+ * Description: Declarations for text traces, which hold one page or address per
+ *					line, in decimal or hex, or the memory accesses recorded by
+ *					other tools, and are parsed straight from the mapped file.
+ *					See texttrace.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef TEXTTRACE_H
+#define TEXTTRACE_H
+
+#include <stddef.h>
+#include "pages.h"
+
+// Text trace constants
+#define TEXT_TRACE_COMMENT		'#'				// First character of a header line
+#define TEXT_TRACE_ADDRESSES	"# addresses"	// Header line marking byte addresses
+#define TEXT_TRACE_DIGITS		20				// Most digits of one decimal value
+
+// Text trace formats
+#define TEXT_FORMAT_PLAIN		0		// One page or address per line
+#define TEXT_FORMAT_LACKEY		1		// Valgrind --tool=lackey --trace-mem=yes output
+#define TEXT_FORMAT_DINERO		2		// DineroIV din records
+#define TEXT_FORMAT_PERF		3		// perf script output of memory samples
+#define TEXT_FORMATS			4		// Number of formats
+
+// Text trace state
+typedef struct textTrace {
+	char *data;					// The mapped file, NULL if it is empty
+	size_t size;				// Size of the file, in bytes
+	const char *next;			// Start of the next line to parse
+	const char *end;			// End of the last line holding a value
+	long references;			// Number of references
+	int addresses;				// Non-zero if the values are byte addresses
+	int format;					// Format of the lines
+} TextTrace;
+
+int textFormatParse(const char*,int*);			// Parses the name of a format
+
+int textTraceOpen(TextTrace*,const char*,int);	// Maps and sizes a text trace
+long textTraceParse(TextTrace*,PageKey[],uint64_t[],long);	// Parses the next references
+void textTraceClose(TextTrace*);				// Unmaps a text trace
+
+#endif
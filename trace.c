@@ -0,0 +1,170 @@
+/***********************************************************************************
+ * File: trace.c
+ * Author: Justin Hardy
+ * Procedures:
+ * traceCreate	- Creates a trace, with memory for its references.
+ * traceAddWrites	- Adds a bitmap of the references that are writes to a trace.
+ * traceSeal	- Makes a trace read-only once its references are filled in.
+ * traceRetain	- Adds an owner to a trace.
+ * traceRelease	- Removes an owner from a trace, freeing it with the last one.
+ * traceHash		- Hashes the references of a trace.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "trace.h"
+
+/***********************************************************************************
+ * Trace *traceCreate( long number, long length, int hugePages, PageKey **pages )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Creates a trace with a single owner, and maps memory for its
+ *					references. With hugePages, the mapping is rounded up to
+ *					whole 2 MiB pages and backed by explicit huge pages if any
+ *					are reserved, or else by transparent huge pages, which cuts
+ *					the TLB misses of simulations over long traces.
+ *
+ * Parameters:
+ * 	number		I/P	long		The number of the trace within the sweep
+ * 	length		I/P	long		The number of references
+ * 	hugePages	I/P	int			Non-zero to back the trace with huge pages
+ * 	pages		O/P	PageKey **	Where the references are to be written
+ * 	traceCreate	O/P	Trace *		The trace, NULL on failure
+ ***********************************************************************************/
+Trace *traceCreate( long number, long length, int hugePages, PageKey **pages ) {
+	// Create trace object
+	Trace *trace = malloc(sizeof(Trace));
+	if( trace == NULL ) {
+		return NULL;
+	}
+	atomic_init(&trace->owners, 1);
+	trace->number = number;
+	trace->length = length;
+	trace->writes = NULL;
+
+	// Compute mapping size; empty traces still map something
+	size_t bytes = (length > 0 ? length : 1) * sizeof(PageKey);
+	void *memory = MAP_FAILED;
+	if( hugePages ) {
+		bytes = (bytes + TRACE_HUGE_PAGE_BYTES - 1) & ~(TRACE_HUGE_PAGE_BYTES - 1);
+#ifdef MAP_HUGETLB
+		memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+	}
+
+	// Fall back to normal pages, advising transparent huge pages if requested
+	if( memory == MAP_FAILED ) {
+		memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if( memory == MAP_FAILED ) {
+			free(trace);
+			return NULL;
+		}
+#ifdef MADV_HUGEPAGE
+		if( hugePages ) {
+			madvise(memory, bytes, MADV_HUGEPAGE);
+		}
+#endif
+	}
+
+	// Hand out writable references
+	trace->mappedBytes = bytes;
+	trace->pages = memory;
+	*pages = memory;
+	return trace;
+}
+
+/***********************************************************************************
+ * uint64_t *traceAddWrites( Trace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Adds a bitmap of the references that are writes to an unsealed
+ *					trace, with every reference a read until filled in.
+ *
+ * Parameters:
+ * 	trace			I/O	Trace *		The trace
+ * 	traceAddWrites	O/P	uint64_t *	The writable bitmap, NULL on failure
+ ***********************************************************************************/
+uint64_t *traceAddWrites( Trace *trace ) {
+	uint64_t *writes = calloc(BITMAP_WORDS(trace->length) + 1, sizeof(uint64_t));
+	trace->writes = writes;
+	return writes;
+}
+
+/***********************************************************************************
+ * void traceSeal( Trace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Makes a trace read-only once its references are filled in, so
+ *					that any stray write from a simulation faults immediately
+ *					instead of silently corrupting other simulations.
+ *
+ * Parameters:
+ * 	trace	I/O	Trace *	The trace to seal
+ ***********************************************************************************/
+void traceSeal( Trace *trace ) {
+	mprotect((void *)trace->pages, trace->mappedBytes, PROT_READ);
+}
+
+/***********************************************************************************
+ * Trace *traceRetain( Trace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Adds an owner to a trace.
+ *
+ * Parameters:
+ * 	trace		I/O	Trace *	The trace to retain
+ * 	traceRetain	O/P	Trace *	The same trace, for convenience
+ ***********************************************************************************/
+Trace *traceRetain( Trace *trace ) {
+	atomic_fetch_add_explicit(&trace->owners, 1, memory_order_relaxed);
+	return trace;
+}
+
+/***********************************************************************************
+ * void traceRelease( Trace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Removes an owner from a trace. The last owner to release the
+ *					trace unmaps its references and frees it.
+ *
+ * Parameters:
+ * 	trace	I/O	Trace *	The trace to release
+ ***********************************************************************************/
+void traceRelease( Trace *trace ) {
+	if( atomic_fetch_sub_explicit(&trace->owners, 1, memory_order_acq_rel) == 1 ) {
+		munmap((void *)trace->pages, trace->mappedBytes);
+		free((void *)trace->writes);
+		free(trace);
+	}
+}
+
+/***********************************************************************************
+ * uint64_t traceHash( const Trace *trace )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Hashes the length and references of a trace into 64 bits, which
+ *					identify the trace's content wherever it came from. Every
+ *					reference is mixed in with a multiply and xor-shift, and the
+ *					result is finalized with the SplitMix64 finalizer.
+ *
+ * Parameters:
+ * 	trace		I/P	const Trace *	The trace to hash
+ * 	traceHash	O/P	uint64_t		The hash of the trace
+ ***********************************************************************************/
+uint64_t traceHash( const Trace *trace ) {
+	uint64_t hash = (uint64_t)trace->length * 0x9E3779B97F4A7C15ULL;
+	long i;
+
+	// Mix in every reference
+	for( i = 0; i < trace->length; i++ ) {
+		hash = (hash ^ trace->pages[i]) * 0xFF51AFD7ED558CCDULL;
+		hash ^= hash >> 32;
+	}
+
+	// Finalize
+	hash ^= hash >> 30;
+	hash *= 0xBF58476D1CE4E5B9ULL;
+	hash ^= hash >> 27;
+	hash *= 0x94D049BB133111EBULL;
+	return hash ^ (hash >> 31);
+}
@@ -0,0 +1,40 @@
+/***********************************************************************************
+ * File: trace.h
+ * Author: Justin Hardy
+ * Description: Declarations for reference counted, immutable traces shared
+ *					read-only by every simulation. See trace.c for implementation
+ *					and details.
+ ***********************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "pages.h"
+
+// Trace constants
+#define TRACE_HUGE_PAGE_BYTES	(2UL << 20)		// Size of a transparent huge page
+
+// A trace of page references. A trace is filled in through the writable pointer
+// returned by traceCreate, then sealed, after which it is read-only and may be
+// simulated by any number of threads at once without copies.
+typedef struct trace {
+	atomic_long owners;			// Number of owners; the trace is freed by the last one
+	long number;				// Number of the trace within the sweep
+	long length;				// Number of references
+	const PageKey *pages;		// The references of the trace
+	const uint64_t *writes;		// Bitmap of the references that are writes, NULL if the
+								// trace tells no writes from reads
+	size_t mappedBytes;			// Size of the memory mapping holding the references
+} Trace;
+
+Trace *traceCreate(long,long,int,PageKey**);	// Creates an unsealed trace
+uint64_t *traceAddWrites(Trace*);				// Adds a write bitmap to an unsealed trace
+void traceSeal(Trace*);							// Makes a trace read-only
+Trace *traceRetain(Trace*);						// Adds an owner to a trace
+void traceRelease(Trace*);						// Removes an owner from a trace
+uint64_t traceHash(const Trace*);				// Hashes the references of a trace
+
+#endif
@@ -0,0 +1,814 @@
+/***********************************************************************************
+ * File: tracefile.c
+ * Author: Justin Hardy
+ * Procedures:
+ * traceWriterOpen		- Creates a trace file and writes its header.
+ * traceWriterAppend	- Appends a single trace to a trace file.
+ * traceWriterClose		- Finishes a trace file by updating its header.
+ * traceReaderOpen		- Opens a trace file and validates its header.
+ * traceReaderNext		- Reads the length of the next trace of a trace file.
+ * traceReaderDecode	- Reads and decodes the references of a trace.
+ * traceReaderBlock		- Reads and decodes the next block of references of a trace.
+ * traceReaderSkip		- Skips the references of a trace without decoding them.
+ * traceReaderClose		- Closes a trace file and frees its buffers.
+ * traceEncodeBlock		- Encodes a block of references as zigzag varint deltas.
+ * traceDecodeBlock		- Decodes a block of zigzag varint deltas.
+ * lzCompress			- Compresses bytes using an LZ4-style encoding.
+ * lzDecompress			- Decompresses bytes produced by lzCompress.
+ *
+ * File layout (all integers little-endian):
+ *	header	- magic "VMTR", u16 version, u16 flags, u32 trace count, u32 reserved
+ *	trace	- u64 reference count, followed by as many blocks as needed
+ *	block	- u32 reference count, u32 varint bytes, u32 stored bytes, payload,
+ *			  then, if the file has the writes flag, a bitmap of the references
+ *			  that are writes, one bit per reference rounded up to bytes
+ * A block's payload is the varint stream itself when its stored size equals its
+ * varint size, or the LZ compressed varint stream when it is smaller. Deltas
+ * restart at every block, so blocks can be decoded independently. A file with
+ * the addresses flag is written from pages all the same, each converted to the
+ * address of its first byte one block at a time.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "tracefile.h"
+
+// Block buffer sizes
+#define TRACE_RAW_BYTES		(TRACE_BLOCK_REFS * TRACE_VARINT_MAX)	// Largest varint block
+#define TRACE_HEADER_BYTES	16										// Size of the file header
+
+// LZ compression constants
+#define LZ_MIN_MATCH	4		// Shortest match that is encoded
+#define LZ_MAX_OFFSET	65535	// Furthest back a match may start
+#define LZ_HASH_BITS	12		// Number of bits in a match finder hash
+
+static void putLE(unsigned char*,uint64_t,int);		// Stores a little-endian integer
+static uint64_t getLE(const unsigned char*,int);	// Loads a little-endian integer
+static int writeHeader(TraceWriter*);				// Writes a trace file header
+
+/***********************************************************************************
+ * int traceWriterOpen( TraceWriter *writer, const char *path, uint16_t flags,
+ *				int pageShift )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Creates a trace file at the given path and writes its header. The
+ *					trace count in the header is filled in by traceWriterClose.
+ *
+ * Parameters:
+ * 	writer			I/O	TraceWriter *	The writer to initialize
+ * 	path			I/P	const char *	The path of the file to create
+ * 	flags			I/P	uint16_t		Header flags (TRACE_FLAG_*)
+ * 	pageShift		I/P	int				log2 of the page size, with which the pages
+ *										appended are written as byte addresses if
+ *										flags has TRACE_FLAG_ADDRESSES
+ * 	traceWriterOpen	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int traceWriterOpen( TraceWriter *writer, const char *path, uint16_t flags, int pageShift ) {
+	// Allocate block buffers
+	writer->flags = flags;
+	writer->traces = 0;
+	writer->pageShift = pageShift;
+	writer->addresses = NULL;
+	if( flags & TRACE_FLAG_ADDRESSES ) {
+		writer->addresses = malloc(TRACE_BLOCK_REFS * sizeof(PageKey));
+	}
+	writer->raw = malloc(TRACE_RAW_BYTES);
+	writer->packed = malloc(TRACE_RAW_BYTES);
+	writer->file = fopen(path, "wb");
+
+	// Check if everything was successfully created
+	if( writer->raw == NULL || writer->packed == NULL || writer->file == NULL ||
+		((flags & TRACE_FLAG_ADDRESSES) && writer->addresses == NULL) || writeHeader(writer) != 0 ) {
+		if( writer->file != NULL ) {
+			fclose(writer->file);
+		}
+		free(writer->addresses);
+		free(writer->raw);
+		free(writer->packed);
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * int traceWriterAppend( TraceWriter *writer, const PageKey pages[],
+ *				const uint64_t writes[], long length )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Appends a single trace to a trace file, splitting it into blocks
+ *					of at most TRACE_BLOCK_REFS references. When compression is
+ *					enabled, each block is stored compressed only if that makes
+ *					it smaller. When the file has the writes flag, the bitmap of
+ *					the writes of each block follows it. When it has the
+ *					addresses flag, each block of pages is first converted to
+ *					the addresses of their first bytes.
+ *
+ * Parameters:
+ * 	writer				I/O	TraceWriter *	The writer to append to
+ * 	pages				I/P	const PageKey []	The references of the trace
+ * 	writes				I/P	const uint64_t []	Bitmap of the references that are
+ *											writes, NULL if they are all reads
+ * 	length				I/P	long			The number of references
+ * 	traceWriterAppend	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int traceWriterAppend( TraceWriter *writer, const PageKey pages[], const uint64_t writes[], long length ) {
+	unsigned char header[12];
+	long i, j, count, rawBytes, storedBytes;
+	const unsigned char *payload;
+
+	// Write the trace length
+	putLE(header, (uint64_t)length, 8);
+	if( fwrite(header, 8, 1, writer->file) != 1 ) {
+		return -1;
+	}
+
+	// Write the trace one block at a time
+	for( i = 0; i < length; i += count ) {
+		// Encode block, as addresses if the file holds them
+		count = length - i < TRACE_BLOCK_REFS ? length - i : TRACE_BLOCK_REFS;
+		if( writer->addresses != NULL ) {
+			for( j = 0; j < count; j++ ) {
+				writer->addresses[j] = pages[i + j] << writer->pageShift;
+			}
+			rawBytes = traceEncodeBlock(writer->addresses, count, writer->raw);
+		}
+		else {
+			rawBytes = traceEncodeBlock(pages + i, count, writer->raw);
+		}
+
+		// Compress block if enabled and worthwhile
+		payload = writer->raw;
+		storedBytes = rawBytes;
+		if( writer->flags & TRACE_FLAG_COMPRESSED ) {
+			long packedBytes = lzCompress(writer->raw, rawBytes, writer->packed, rawBytes - 1);
+			if( packedBytes > 0 ) {
+				payload = writer->packed;
+				storedBytes = packedBytes;
+			}
+		}
+
+		// Write block header and payload
+		putLE(header, (uint64_t)count, 4);
+		putLE(header + 4, (uint64_t)rawBytes, 4);
+		putLE(header + 8, (uint64_t)storedBytes, 4);
+		if( fwrite(header, sizeof(header), 1, writer->file) != 1 ||
+			fwrite(payload, 1, storedBytes, writer->file) != (size_t)storedBytes ) {
+			return -1;
+		}
+
+		// Write the bytes of the block's writes, which start on a word boundary
+		if( writer->flags & TRACE_FLAG_WRITES ) {
+			for( j = 0; j < (count + 7) / 8; j++ ) {
+				writer->raw[j] = writes != NULL ? (unsigned char)(writes[(i + 8 * j) / 64] >> ((8 * j) % 64)) : 0;
+			}
+			if( fwrite(writer->raw, 1, j, writer->file) != (size_t)j ) {
+				return -1;
+			}
+		}
+	}
+
+	// Count trace
+	writer->traces++;
+	return 0;
+}
+
+/***********************************************************************************
+ * int traceWriterClose( TraceWriter *writer )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Finishes a trace file by rewriting its header with the final trace
+ *					count, then closes it and frees the writer's buffers.
+ *
+ * Parameters:
+ * 	writer				I/O	TraceWriter *	The writer to close
+ * 	traceWriterClose	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int traceWriterClose( TraceWriter *writer ) {
+	// Rewrite header now that the trace count is known
+	int status = 0;
+	if( fseek(writer->file, 0, SEEK_SET) != 0 || writeHeader(writer) != 0 ) {
+		status = -1;
+	}
+
+	// Close file and free buffers
+	if( fclose(writer->file) != 0 ) {
+		status = -1;
+	}
+	free(writer->addresses);
+	free(writer->raw);
+	free(writer->packed);
+	return status;
+}
+
+/***********************************************************************************
+ * int traceReaderOpen( TraceReader *reader, const char *path, int format )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Opens a trace file and validates its header. A file without the
+ *					header of a trace file is opened as a text trace instead,
+ *					holding a single trace of the given format (see
+ *					texttrace.c).
+ *
+ * Parameters:
+ * 	reader			I/O	TraceReader *	The reader to initialize
+ * 	path			I/P	const char *	The path of the file to open
+ * 	format			I/P	int				The format of a text trace, a TEXT_FORMAT_
+ * 	traceReaderOpen	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int traceReaderOpen( TraceReader *reader, const char *path, int format ) {
+	unsigned char header[TRACE_HEADER_BYTES];
+
+	// Allocate block buffers and open file
+	memset(reader, 0, sizeof(*reader));
+	reader->raw = malloc(TRACE_RAW_BYTES);
+	reader->packed = malloc(TRACE_RAW_BYTES);
+	reader->file = fopen(path, "rb");
+	if( reader->raw == NULL || reader->packed == NULL || reader->file == NULL ) {
+		traceReaderClose(reader);
+		return -1;
+	}
+
+	// Read header, falling back to a text trace without one
+	if( fread(header, sizeof(header), 1, reader->file) != 1 || memcmp(header, TRACE_MAGIC, 4) != 0 ) {
+		reader->text = malloc(sizeof(TextTrace));
+		if( reader->text == NULL || textTraceOpen(reader->text, path, format) != 0 ) {
+			free(reader->text);
+			reader->text = NULL;
+			traceReaderClose(reader);
+			return -1;
+		}
+		fclose(reader->file);
+		reader->file = NULL;
+		reader->flags = (reader->text->addresses ? TRACE_FLAG_ADDRESSES : 0) |
+						(reader->text->format != TEXT_FORMAT_PLAIN ? TRACE_FLAG_WRITES : 0);
+		reader->traces = 1;
+		return 0;
+	}
+
+	// Validate header
+	if( getLE(header + 4, 2) != TRACE_VERSION ) {
+		traceReaderClose(reader);
+		return -1;
+	}
+	reader->flags = (uint16_t)getLE(header + 6, 2);
+	reader->traces = (uint32_t)getLE(header + 8, 4);
+	return 0;
+}
+
+/***********************************************************************************
+ * int traceReaderNext( TraceReader *reader, long *length )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Reads the length of the next trace of a trace file. The trace's
+ *					references must then be decoded with traceReaderDecode into
+ *					a buffer of that length chosen by the caller, so that traces
+ *					can be decoded straight into shared memory.
+ *
+ * Parameters:
+ * 	reader			I/O	TraceReader *	The reader to read from
+ * 	length			O/P	long *			The number of references
+ * 	traceReaderNext	O/P	int				1 if a trace follows, 0 at the end
+ *										of the file, -1 on failure
+ ***********************************************************************************/
+int traceReaderNext( TraceReader *reader, long *length ) {
+	unsigned char header[8];
+
+	// Check if every trace was already read
+	if( reader->next == reader->traces ) {
+		return 0;
+	}
+
+	// Read trace length; a text trace knows it from its lines
+	if( reader->text != NULL ) {
+		*length = reader->text->references;
+	}
+	else if( fread(header, sizeof(header), 1, reader->file) != 1 ) {
+		return -1;
+	}
+	else {
+		*length = (long)getLE(header, 8);
+	}
+	if( *length < 0 ) {
+		return -1;
+	}
+	reader->next++;
+	return 1;
+}
+
+/***********************************************************************************
+ * int traceReaderDecode( TraceReader *reader, PageKey pages[], uint64_t writes[],
+ *				long length )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Reads and decodes the references of the trace whose length was
+ *					just read by traceReaderNext.
+ *
+ * Parameters:
+ * 	reader				I/O	TraceReader *	The reader to read from
+ * 	pages				O/P	PageKey []		The references of the trace
+ * 	writes				O/P	uint64_t []		Bitmap of the references that are
+ *											writes, NULL to discard it
+ * 	length				I/P	long			The number of references
+ * 	traceReaderDecode	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int traceReaderDecode( TraceReader *reader, PageKey pages[], uint64_t writes[], long length ) {
+	long i, count;
+
+	// Read the trace one block at a time; blocks start on a word of the bitmap
+	for( i = 0; i < length; i += count ) {
+		count = traceReaderBlock(reader, pages + i, writes != NULL ? writes + i / BITMAP_BITS : NULL, length - i);
+		if( count < 0 ) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * long traceReaderBlock( TraceReader *reader, PageKey pages[], uint64_t writes[],
+ *				long remaining )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Reads and decodes the next block of the trace whose length was
+ *					just read by traceReaderNext, so that a trace can be streamed
+ *					in at most TRACE_BLOCK_REFS references at a time. The writes
+ *					of a file without the writes flag are all clear.
+ *
+ * Parameters:
+ * 	reader				I/O	TraceReader *	The reader to read from
+ * 	pages				O/P	PageKey []		The references of the block, with room
+ *											for TRACE_BLOCK_REFS
+ * 	writes				O/P	uint64_t []		Bitmap of the references of the block
+ *											that are writes, with room for
+ *											TRACE_BLOCK_REFS; NULL to discard it
+ * 	remaining			I/P	long			The references of the trace not yet read
+ * 	traceReaderBlock	O/P	long			The number of references read, -1 on
+ *											failure
+ ***********************************************************************************/
+long traceReaderBlock( TraceReader *reader, PageKey pages[], uint64_t writes[], long remaining ) {
+	unsigned char header[12];
+	long i, count, rawBytes, storedBytes;
+
+	// Parse a block of a text trace, which must hold as many lines as counted
+	if( reader->text != NULL ) {
+		count = remaining < TRACE_BLOCK_REFS ? remaining : TRACE_BLOCK_REFS;
+		return count > 0 && textTraceParse(reader->text, pages, writes, count) == count ? count : -1;
+	}
+
+	// Read and validate block header
+	if( fread(header, sizeof(header), 1, reader->file) != 1 ) {
+		return -1;
+	}
+	count = (long)getLE(header, 4);
+	rawBytes = (long)getLE(header + 4, 4);
+	storedBytes = (long)getLE(header + 8, 4);
+	if( count == 0 || count > TRACE_BLOCK_REFS || count > remaining ||
+		rawBytes > TRACE_RAW_BYTES || storedBytes > rawBytes ) {
+		return -1;
+	}
+
+	// Read payload, decompressing it if it was stored compressed
+	if( storedBytes < rawBytes ) {
+		if( !(reader->flags & TRACE_FLAG_COMPRESSED) ||
+			fread(reader->packed, 1, storedBytes, reader->file) != (size_t)storedBytes ||
+			lzDecompress(reader->packed, storedBytes, reader->raw, rawBytes) != rawBytes ) {
+			return -1;
+		}
+	}
+	else if( fread(reader->raw, 1, rawBytes, reader->file) != (size_t)rawBytes ) {
+		return -1;
+	}
+
+	// Decode block
+	if( traceDecodeBlock(reader->raw, rawBytes, pages, count) != count ) {
+		return -1;
+	}
+
+	// Read the bytes of the block's writes
+	if( reader->flags & TRACE_FLAG_WRITES &&
+		fread(reader->raw, 1, (count + 7) / 8, reader->file) != (size_t)(count + 7) / 8 ) {
+		return -1;
+	}
+	if( writes != NULL ) {
+		memset(writes, 0, BITMAP_WORDS(count) * sizeof(uint64_t));
+		for( i = 0; reader->flags & TRACE_FLAG_WRITES && i < (count + 7) / 8; i++ ) {
+			writes[i / 8] |= (uint64_t)reader->raw[i] << (8 * (i % 8));
+		}
+	}
+	return count;
+}
+
+/***********************************************************************************
+ * int traceReaderSkip( TraceReader *reader, long length )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Skips the references of the trace whose length was just read by
+ *					traceReaderNext, seeking over the payload of each block
+ *					instead of decoding it.
+ *
+ * Parameters:
+ * 	reader			I/O	TraceReader *	The reader to read from
+ * 	length			I/P	long			The number of references
+ * 	traceReaderSkip	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+int traceReaderSkip( TraceReader *reader, long length ) {
+	unsigned char header[12];
+	long i, count, rawBytes, storedBytes;
+
+	// The only trace of a text trace is followed by nothing
+	if( reader->text != NULL ) {
+		return 0;
+	}
+
+	// Skip the trace one block at a time
+	for( i = 0; i < length; i += count ) {
+		// Read and validate block header
+		if( fread(header, sizeof(header), 1, reader->file) != 1 ) {
+			return -1;
+		}
+		count = (long)getLE(header, 4);
+		rawBytes = (long)getLE(header + 4, 4);
+		storedBytes = (long)getLE(header + 8, 4);
+		if( count == 0 || count > TRACE_BLOCK_REFS || count > length - i ||
+			rawBytes > TRACE_RAW_BYTES || storedBytes > rawBytes ) {
+			return -1;
+		}
+
+		// Seek over payload and writes
+		if( reader->flags & TRACE_FLAG_WRITES ) {
+			storedBytes += (count + 7) / 8;
+		}
+		if( fseek(reader->file, storedBytes, SEEK_CUR) != 0 ) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * void traceReaderClose( TraceReader *reader )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Closes a trace file and frees the reader's buffers.
+ *
+ * Parameters:
+ * 	reader	I/O	TraceReader *	The reader to close
+ ***********************************************************************************/
+void traceReaderClose( TraceReader *reader ) {
+	if( reader->file != NULL ) {
+		fclose(reader->file);
+	}
+	if( reader->text != NULL ) {
+		textTraceClose(reader->text);
+		free(reader->text);
+	}
+	free(reader->raw);
+	free(reader->packed);
+	memset(reader, 0, sizeof(*reader));
+}
+
+/***********************************************************************************
+ * long traceEncodeBlock( const PageKey pages[], long count, unsigned char *out )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Encodes a block of references as the differences between
+ *					consecutive references, zigzag mapped so that small negative
+ *					differences stay small, and stored as LEB128 varints. The
+ *					first reference is encoded relative to 0. The output buffer
+ *					must hold count * TRACE_VARINT_MAX bytes.
+ *
+ * Parameters:
+ * 	pages				I/P	const PageKey []	The references to encode
+ * 	count				I/P	long				The number of references
+ * 	out					O/P	unsigned char *		The encoded bytes
+ * 	traceEncodeBlock	O/P	long				The number of bytes written
+ ***********************************************************************************/
+long traceEncodeBlock( const PageKey pages[], long count, unsigned char *out ) {
+	unsigned char *op = out;
+	uint64_t previous = 0;
+	long i;
+
+	for( i = 0; i < count; i++ ) {
+		// Zigzag map the difference from the previous reference
+		int64_t delta = (int64_t)(pages[i] - previous);
+		uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+		previous = pages[i];
+
+		// Store seven bits at a time, low bits first
+		while( zigzag >= 0x80 ) {
+			*op++ = (unsigned char)(zigzag | 0x80);
+			zigzag >>= 7;
+		}
+		*op++ = (unsigned char)zigzag;
+	}
+	return op - out;
+}
+
+/***********************************************************************************
+ * long traceDecodeBlock( const unsigned char *in, long bytes, PageKey *pages,
+ *						long count )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Decodes a block produced by traceEncodeBlock. While at least one
+ *					maximum length varint remains in the input, varints are
+ *					decoded without per-byte bounds checks; single byte
+ *					varints, the common case for local traces, take one branch.
+ *
+ * Parameters:
+ * 	in					I/P	const unsigned char *	The encoded bytes
+ * 	bytes				I/P	long					The number of encoded bytes
+ * 	pages				O/P	PageKey *				The decoded references
+ * 	count				I/P	long					The number of references
+ * 	traceDecodeBlock	O/P	long					The number of references
+ *													decoded, -1 if malformed
+ ***********************************************************************************/
+long traceDecodeBlock( const unsigned char *in, long bytes, PageKey *pages, long count ) {
+	const unsigned char *ip = in, *end = in + bytes;
+	uint64_t previous = 0, zigzag;
+	long i;
+	int shift;
+
+	for( i = 0; i < count; i++ ) {
+		if( end - ip >= TRACE_VARINT_MAX ) {
+			// Fast path: the whole varint is known to be in bounds
+			zigzag = *ip++;
+			if( zigzag >= 0x80 ) {
+				zigzag &= 0x7f;
+				for( shift = 7; ; shift += 7 ) {
+					uint64_t byte = *ip++;
+					zigzag |= (byte & 0x7f) << shift;
+					if( byte < 0x80 ) {
+						break;
+					}
+					if( shift == 63 ) {
+						return -1;
+					}
+				}
+			}
+		}
+		else {
+			// Slow path: check bounds on every byte
+			zigzag = 0;
+			for( shift = 0; ; shift += 7 ) {
+				if( ip == end || shift > 63 ) {
+					return -1;
+				}
+				uint64_t byte = *ip++;
+				zigzag |= (byte & 0x7f) << shift;
+				if( byte < 0x80 ) {
+					break;
+				}
+			}
+		}
+
+		// Undo zigzag mapping and delta encoding
+		previous += (zigzag >> 1) ^ (0 - (zigzag & 1));
+		pages[i] = previous;
+	}
+
+	// The whole block must have been consumed
+	return ip == end ? count : -1;
+}
+
+/***********************************************************************************
+ * long lzCompress( const unsigned char *in, long length, unsigned char *out,
+ *					long capacity )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Compresses bytes using an LZ4-style encoding: a sequence of
+ *					tokens, each holding a literal run length and a match length
+ *					in its two nibbles (15 meaning "continued in 255-valued
+ *					extra bytes"), followed by the literals, a 16-bit match offset
+ *					and the match length extension. The last token carries only
+ *					literals. Matches are found through a single-entry hash table
+ *					of 4-byte sequences.
+ *
+ * Parameters:
+ * 	in			I/P	const unsigned char *	The bytes to compress
+ * 	length		I/P	long					The number of bytes to compress
+ * 	out			O/P	unsigned char *			The compressed bytes
+ * 	capacity	I/P	long					The size of the output buffer
+ * 	lzCompress	O/P	long					The compressed size, -1 if it does
+ *												not fit in the output buffer
+ ***********************************************************************************/
+long lzCompress( const unsigned char *in, long length, unsigned char *out, long capacity ) {
+	long table[1 << LZ_HASH_BITS];
+	long ip = 0, anchor = 0, op = 0, literals, match, extra;
+	uint32_t sequence;
+	int i;
+
+	// Empty the hash table
+	for( i = 0; i < (1 << LZ_HASH_BITS); i++ ) {
+		table[i] = -1;
+	}
+
+	// Find matches and emit sequences
+	while( ip <= length ) {
+		long reference = -1, matchLength = 0;
+
+		// Look for a match starting at the current position
+		if( ip + LZ_MIN_MATCH <= length ) {
+			memcpy(&sequence, in + ip, sizeof(sequence));
+			uint32_t hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+			reference = table[hash];
+			table[hash] = ip;
+			if( reference >= 0 && ip - reference <= LZ_MAX_OFFSET && memcmp(in + reference, in + ip, LZ_MIN_MATCH) == 0 ) {
+				matchLength = LZ_MIN_MATCH;
+				while( ip + matchLength < length && in[reference + matchLength] == in[ip + matchLength] ) {
+					matchLength++;
+				}
+			}
+			else {
+				ip++;
+				continue;
+			}
+		}
+		else if( anchor == length ) {
+			// Input ended right after a match; nothing left to emit
+			break;
+		}
+
+		// Make sure the sequence fits: token, lengths, literals and offset
+		literals = (matchLength ? ip : length) - anchor;
+		if( op + 1 + literals / 255 + 1 + literals + 2 + matchLength / 255 + 1 > capacity ) {
+			return -1;
+		}
+
+		// Emit token and literal run
+		out[op++] = (unsigned char)(((literals < 15 ? literals : 15) << 4) |
+			(matchLength ? (matchLength - LZ_MIN_MATCH < 15 ? matchLength - LZ_MIN_MATCH : 15) : 0));
+		if( literals >= 15 ) {
+			for( extra = literals - 15; extra >= 255; extra -= 255 ) {
+				out[op++] = 255;
+			}
+			out[op++] = (unsigned char)extra;
+		}
+		memcpy(out + op, in + anchor, literals);
+		op += literals;
+
+		// The last sequence carries literals only
+		if( !matchLength ) {
+			break;
+		}
+
+		// Emit match offset and length
+		match = matchLength - LZ_MIN_MATCH;
+		out[op++] = (unsigned char)((ip - reference) & 0xff);
+		out[op++] = (unsigned char)((ip - reference) >> 8);
+		if( match >= 15 ) {
+			for( extra = match - 15; extra >= 255; extra -= 255 ) {
+				out[op++] = 255;
+			}
+			out[op++] = (unsigned char)extra;
+		}
+
+		// Continue after the match
+		ip += matchLength;
+		anchor = ip;
+	}
+	return op;
+}
+
+/***********************************************************************************
+ * long lzDecompress( const unsigned char *in, long length, unsigned char *out,
+ *					long capacity )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Decompresses bytes produced by lzCompress, checking every length
+ *					and offset against the input and output bounds so that a
+ *					corrupted file cannot cause out of bounds accesses.
+ *
+ * Parameters:
+ * 	in				I/P	const unsigned char *	The compressed bytes
+ * 	length			I/P	long					The number of compressed bytes
+ * 	out				O/P	unsigned char *			The decompressed bytes
+ * 	capacity		I/P	long					The expected decompressed size
+ * 	lzDecompress	O/P	long					The decompressed size, -1 if
+ *												the input is malformed
+ ***********************************************************************************/
+long lzDecompress( const unsigned char *in, long length, unsigned char *out, long capacity ) {
+	const unsigned char *ip = in, *iend = in + length;
+	unsigned char *op = out, *oend = out + capacity;
+	long literals, match, offset;
+
+	while( op < oend ) {
+		// Read token and literal run length
+		if( ip == iend ) {
+			return -1;
+		}
+		unsigned token = *ip++;
+		literals = token >> 4;
+		if( literals == 15 ) {
+			do {
+				if( ip == iend ) {
+					return -1;
+				}
+				literals += *ip;
+			} while( *ip++ == 255 );
+		}
+
+		// Copy literals
+		if( literals > iend - ip || literals > oend - op ) {
+			return -1;
+		}
+		memcpy(op, ip, literals);
+		ip += literals;
+		op += literals;
+		if( op == oend ) {
+			break;
+		}
+
+		// Read match offset and length
+		if( iend - ip < 2 ) {
+			return -1;
+		}
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		match = token & 15;
+		if( match == 15 ) {
+			do {
+				if( ip == iend ) {
+					return -1;
+				}
+				match += *ip;
+			} while( *ip++ == 255 );
+		}
+		match += LZ_MIN_MATCH;
+
+		// Copy match; overlapping matches repeat the last offset bytes
+		if( offset == 0 || offset > op - out || match > oend - op ) {
+			return -1;
+		}
+		if( offset >= match ) {
+			memcpy(op, op - offset, match);
+			op += match;
+		}
+		else {
+			while( match-- > 0 ) {
+				*op = *(op - offset);
+				op++;
+			}
+		}
+	}
+
+	// The whole input must have been consumed
+	return ip == iend ? op - out : -1;
+}
+
+/***********************************************************************************
+ * void putLE( unsigned char *out, uint64_t value, int bytes )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Stores the low bytes of an integer in little-endian order.
+ *
+ * Parameters:
+ * 	out		O/P	unsigned char *	Where to store the integer
+ * 	value	I/P	uint64_t		The integer to store
+ * 	bytes	I/P	int				The number of bytes to store
+ ***********************************************************************************/
+static void putLE( unsigned char *out, uint64_t value, int bytes ) {
+	int i;
+	for( i = 0; i < bytes; i++ ) {
+		out[i] = (unsigned char)(value >> (8 * i));
+	}
+}
+
+/***********************************************************************************
+ * uint64_t getLE( const unsigned char *in, int bytes )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Loads an integer stored in little-endian order.
+ *
+ * Parameters:
+ * 	in		I/P	const unsigned char *	Where the integer is stored
+ * 	bytes	I/P	int						The number of bytes to load
+ * 	getLE	O/P	uint64_t				The loaded integer
+ ***********************************************************************************/
+static uint64_t getLE( const unsigned char *in, int bytes ) {
+	uint64_t value = 0;
+	int i;
+	for( i = 0; i < bytes; i++ ) {
+		value |= (uint64_t)in[i] << (8 * i);
+	}
+	return value;
+}
+
+/***********************************************************************************
+ * int writeHeader( TraceWriter *writer )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Writes the header of a trace file at the current file position.
+ *
+ * Parameters:
+ * 	writer		I/P	TraceWriter *	The writer whose header is written
+ * 	writeHeader	O/P	int				0 on success, -1 on failure
+ ***********************************************************************************/
+static int writeHeader( TraceWriter *writer ) {
+	unsigned char header[TRACE_HEADER_BYTES];
+	memcpy(header, TRACE_MAGIC, 4);
+	putLE(header + 4, TRACE_VERSION, 2);
+	putLE(header + 6, writer->flags, 2);
+	putLE(header + 8, writer->traces, 4);
+	putLE(header + 12, 0, 4);
+	return fwrite(header, sizeof(header), 1, writer->file) == 1 ? 0 : -1;
+}
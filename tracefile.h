@@ -0,0 +1,63 @@
+/***********************************************************************************
+ * File: tracefile.h
+ * Author: Justin Hardy
+ * Description: Declarations for the binary trace file format. See tracefile.c for
+ *					implementation and details of the on-disk layout.
+ ***********************************************************************************/
+
+#ifndef TRACEFILE_H
+#define TRACEFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "pages.h"
+#include "texttrace.h"
+
+// Trace file constants
+#define TRACE_MAGIC			"VMTR"		// Magic bytes at the start of every trace file
+#define TRACE_VERSION		1			// Current version of the trace file format
+#define TRACE_BLOCK_REFS	65536		// Maximum number of references in one block
+#define TRACE_VARINT_MAX	10			// Maximum encoded size of one reference
+
+// Trace file header flags
+#define TRACE_FLAG_COMPRESSED	0x0001	// Blocks may be LZ compressed
+#define TRACE_FLAG_ADDRESSES	0x0002	// References are byte addresses, not pages
+#define TRACE_FLAG_WRITES		0x0004	// Blocks tell the references that are writes
+
+// Trace file writer state
+typedef struct traceWriter {
+	FILE *file;					// The file being written
+	uint16_t flags;				// Header flags
+	uint32_t traces;			// Number of traces written so far
+	int pageShift;				// log2 of the page size pages are written as addresses with
+	PageKey *addresses;			// Buffer holding the addresses of one block, NULL for pages
+	unsigned char *raw;			// Buffer holding one varint encoded block
+	unsigned char *packed;		// Buffer holding one compressed block
+} TraceWriter;
+
+// Trace file reader state
+typedef struct traceReader {
+	FILE *file;					// The file being read
+	uint16_t flags;				// Header flags
+	uint32_t traces;			// Number of traces in the file
+	uint32_t next;				// Index of the next trace to be read
+	unsigned char *raw;			// Buffer holding one varint encoded block
+	unsigned char *packed;		// Buffer holding one compressed block
+	TextTrace *text;			// Text trace read instead of a trace file, NULL for none
+} TraceReader;
+
+int traceWriterOpen(TraceWriter*,const char*,uint16_t,int);	// Creates a trace file
+int traceWriterAppend(TraceWriter*,const PageKey[],const uint64_t[],long);	// Appends a trace to a file
+int traceWriterClose(TraceWriter*);							// Finishes a trace file
+int traceReaderOpen(TraceReader*,const char*,int);			// Opens a trace file
+int traceReaderNext(TraceReader*,long*);					// Reads the next trace length
+int traceReaderDecode(TraceReader*,PageKey[],uint64_t[],long);	// Decodes the next trace
+long traceReaderBlock(TraceReader*,PageKey[],uint64_t[],long);	// Decodes the next block of a trace
+int traceReaderSkip(TraceReader*,long);						// Skips the next trace
+void traceReaderClose(TraceReader*);						// Closes a trace file
+long traceEncodeBlock(const PageKey[],long,unsigned char*);		// Varint encodes a block
+long traceDecodeBlock(const unsigned char*,long,PageKey*,long);	// Decodes a block
+long lzCompress(const unsigned char*,long,unsigned char*,long);		// LZ compresses bytes
+long lzDecompress(const unsigned char*,long,unsigned char*,long);	// LZ decompresses bytes
+
+#endif
@@ -0,0 +1,290 @@
+/***********************************************************************************
+ * File: tracepipe.c
+ * Author: Justin Hardy
+ * Procedures:
+ * tracePipeOpen	- Opens a trace file and starts its reader thread.
+ * tracePipeTake	- Waits for the next chunk of decoded references.
+ * tracePipeRelease	- Hands the chunk taken last back to the reader.
+ * tracePipeClose	- Stops the reader thread and closes the trace file.
+ * readerMain		- Reads and decodes every trace of the file into the ring.
+ * pipeWait			- Waits until the other side of the ring moves.
+ * pipeAdvance		- Moves an index of the ring and wakes the other side.
+ *
+ * The reader thread reads, decompresses and decodes the file one block at a
+ * time into a ring of chunks, converting address traces to pages, while the
+ * consumer copies or simulates the chunks filled before. The ring is single
+ * producer, single consumer and lock-free: the reader publishes a chunk by
+ * advancing head with release ordering once it is filled, and the consumer
+ * hands it back by advancing tail once it is done with it, so neither ever
+ * touches a chunk the other owns. A side finding the ring full or empty polls
+ * briefly, then blocks on a condition variable, so that a reader ahead of the
+ * simulations leaves its CPU to them. Only a side seeing the other blocked
+ * takes the lock to wake it.
+ * Every trace is sent as one or more chunks in order, and the end of the file,
+ * or a failure to read it, as a chunk of its own.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "tracepipe.h"
+
+static void *readerMain(void*);						// Reader thread body
+static int pipeWait(TracePipe*,atomic_long*,long);	// Waits for the other side
+static void pipeAdvance(TracePipe*,atomic_long*);	// Moves an index of the ring
+
+/***********************************************************************************
+ * int tracePipeOpen( TracePipe *pipe, const char *path, int format,
+ *				int pageShift, const uint64_t skip[] )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Opens a trace file and starts reading it ahead on a new thread.
+ *
+ * Parameters:
+ * 	pipe			O/P	TracePipe *			The pipe to open
+ * 	path			I/P	const char *		The trace file
+ * 	format			I/P	int					The format of a text trace, a TEXT_FORMAT_
+ * 	pageShift		I/P	int					log2 of the page size of address traces
+ * 	skip			I/P	const uint64_t []	Bitmap of the traces to skip without
+ *											decoding, copied; NULL to skip none
+ * 	tracePipeOpen	O/P	int					0 on success, -1 on failure
+ ***********************************************************************************/
+int tracePipeOpen( TracePipe *pipe, const char *path, int format, int pageShift, const uint64_t skip[] ) {
+	int i;
+
+	if( traceReaderOpen(&pipe->reader, path, format) != 0 ) {
+		return -1;
+	}
+	pipe->pageShift = pageShift;
+	pipe->skip = calloc(BITMAP_WORDS(pipe->reader.traces) + 1, sizeof(uint64_t));
+	if( pipe->skip == NULL ) {
+		traceReaderClose(&pipe->reader);
+		return -1;
+	}
+	if( skip != NULL ) {
+		memcpy(pipe->skip, skip, BITMAP_WORDS(pipe->reader.traces) * sizeof(uint64_t));
+	}
+
+	// Allocate the chunks of the ring, each with its write bitmap after its pages
+	for( i = 0; i < PIPE_CHUNKS; i++ ) {
+		pipe->chunks[i].pages = malloc(TRACE_BLOCK_REFS * sizeof(PageKey) +
+			BITMAP_WORDS(TRACE_BLOCK_REFS) * sizeof(uint64_t));
+		pipe->chunks[i].writes = (uint64_t *) (pipe->chunks[i].pages + TRACE_BLOCK_REFS);
+		if( pipe->chunks[i].pages == NULL ) {
+			while( i-- > 0 ) {
+				free(pipe->chunks[i].pages);
+			}
+			free(pipe->skip);
+			traceReaderClose(&pipe->reader);
+			return -1;
+		}
+	}
+	atomic_init(&pipe->head, 0);
+	atomic_init(&pipe->tail, 0);
+	atomic_init(&pipe->stop, 0);
+	atomic_init(&pipe->sleepers, 0);
+	pthread_mutex_init(&pipe->lock, NULL);
+	pthread_cond_init(&pipe->moved, NULL);
+
+	// Start reading
+	if( pthread_create(&pipe->thread, NULL, readerMain, pipe) != 0 ) {
+		pthread_cond_destroy(&pipe->moved);
+		pthread_mutex_destroy(&pipe->lock);
+		for( i = 0; i < PIPE_CHUNKS; i++ ) {
+			free(pipe->chunks[i].pages);
+		}
+		free(pipe->skip);
+		traceReaderClose(&pipe->reader);
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * const PipeChunk *tracePipeTake( TracePipe *pipe )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Waits for the reader to fill the next chunk, and returns it. The
+ *					chunk is the consumer's until tracePipeRelease. After a chunk
+ *					past the last trace or of a failed read, no more are filled.
+ *
+ * Parameters:
+ * 	pipe			I/O	TracePipe *			The pipe
+ * 	tracePipeTake	O/P	const PipeChunk *	The next chunk
+ ***********************************************************************************/
+const PipeChunk *tracePipeTake( TracePipe *pipe ) {
+	long tail = atomic_load_explicit(&pipe->tail, memory_order_relaxed);
+	pipeWait(pipe, &pipe->head, tail);
+	return &pipe->chunks[tail & (PIPE_CHUNKS - 1)];
+}
+
+/***********************************************************************************
+ * void tracePipeRelease( TracePipe *pipe )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Hands the chunk returned by the last tracePipeTake back to the
+ *					reader, to be filled again.
+ *
+ * Parameters:
+ * 	pipe	I/O	TracePipe *	The pipe
+ ***********************************************************************************/
+void tracePipeRelease( TracePipe *pipe ) {
+	pipeAdvance(pipe, &pipe->tail);
+}
+
+/***********************************************************************************
+ * void tracePipeClose( TracePipe *pipe )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Stops the reader thread, wherever it is in the file, and frees the
+ *					pipe.
+ *
+ * Parameters:
+ * 	pipe	I/O	TracePipe *	The pipe to close
+ ***********************************************************************************/
+void tracePipeClose( TracePipe *pipe ) {
+	int i;
+
+	// Wake the reader if it is blocked on a full ring
+	atomic_store(&pipe->stop, 1);
+	pthread_mutex_lock(&pipe->lock);
+	pthread_cond_broadcast(&pipe->moved);
+	pthread_mutex_unlock(&pipe->lock);
+	pthread_join(pipe->thread, NULL);
+	pthread_cond_destroy(&pipe->moved);
+	pthread_mutex_destroy(&pipe->lock);
+	for( i = 0; i < PIPE_CHUNKS; i++ ) {
+		free(pipe->chunks[i].pages);
+	}
+	free(pipe->skip);
+	traceReaderClose(&pipe->reader);
+}
+
+/***********************************************************************************
+ * void *readerMain( void *argument )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Reads every trace of the file not to be skipped, one block per
+ *					chunk, until the end of the file, a failure, or the pipe is
+ *					closed.
+ *
+ * Parameters:
+ * 	argument	I/O	void *	The TracePipe to fill
+ * 	readerMain	O/P	void *	NULL
+ ***********************************************************************************/
+static void *readerMain( void *argument ) {
+	TracePipe *pipe = argument;
+	PipeChunk *chunk;
+	long head = 0, length, offset, trace;
+
+	for( trace = 0; ; trace++ ) {
+		// Read the length of the next trace, skipping it if requested
+		int status = traceReaderNext(&pipe->reader, &length);
+		if( status == 1 && bitmapTest(pipe->skip, trace) ) {
+			if( traceReaderSkip(&pipe->reader, length) != 0 ) {
+				status = -1;
+			}
+			else {
+				continue;
+			}
+		}
+
+		// Decode the trace a block per chunk; an empty trace is one empty chunk
+		offset = 0;
+		do {
+			if( pipeWait(pipe, &pipe->tail, head - PIPE_CHUNKS) != 0 ) {
+				return NULL;
+			}
+			chunk = &pipe->chunks[head & (PIPE_CHUNKS - 1)];
+			chunk->trace = status == 1 ? trace : -1;
+			chunk->length = length;
+			chunk->offset = offset;
+			chunk->count = status == 1 && length > 0 ? traceReaderBlock(&pipe->reader, chunk->pages, chunk->writes, length - offset) : 0;
+			if( status < 0 || chunk->count < 0 ) {
+				chunk->trace = -1;
+				chunk->count = -1;
+				status = -1;
+			}
+			else if( pipe->reader.flags & TRACE_FLAG_ADDRESSES ) {
+				// Ingest byte addresses as pages of the configured size
+				addressesToPages(chunk->pages, chunk->count, pipe->pageShift);
+			}
+			offset += chunk->count;
+
+			// Publish the chunk
+			pipeAdvance(pipe, &pipe->head);
+			head++;
+		} while( status == 1 && offset < length );
+
+		// Nothing follows the end of the file or a failure
+		if( status != 1 ) {
+			return NULL;
+		}
+	}
+}
+
+/***********************************************************************************
+ * int pipeWait( TracePipe *pipe, atomic_long *index, long past )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Waits until the other side of the ring moves an index past a
+ *					value, polling PIPE_SPINS times before blocking until it is
+ *					woken. The count of sleepers is raised before the index is
+ *					read again under the lock, and pipeAdvance moves the index
+ *					before reading the count, so that with sequentially
+ *					consistent ordering one of them always sees the other. The
+ *					reader also gives up waiting once the pipe is closed.
+ *
+ * Parameters:
+ * 	pipe		I/P	TracePipe *		The pipe
+ * 	index		I/P	atomic_long *	The head or tail of the ring
+ * 	past		I/P	long			The value the index must exceed
+ * 	pipeWait	O/P	int				0 once it does, -1 if the pipe was closed
+ ***********************************************************************************/
+static int pipeWait( TracePipe *pipe, atomic_long *index, long past ) {
+	int spins, closed = 0;
+
+	// Poll briefly
+	for( spins = 0; spins < PIPE_SPINS; spins++ ) {
+		if( atomic_load_explicit(index, memory_order_acquire) > past ) {
+			return 0;
+		}
+		if( index == &pipe->tail && atomic_load_explicit(&pipe->stop, memory_order_relaxed) ) {
+			return -1;
+		}
+	}
+
+	// Block until the other side moves or the pipe is closed
+	pthread_mutex_lock(&pipe->lock);
+	atomic_fetch_add(&pipe->sleepers, 1);
+	while( atomic_load(index) <= past ) {
+		if( index == &pipe->tail && atomic_load(&pipe->stop) ) {
+			closed = 1;
+			break;
+		}
+		pthread_cond_wait(&pipe->moved, &pipe->lock);
+	}
+	atomic_fetch_sub(&pipe->sleepers, 1);
+	pthread_mutex_unlock(&pipe->lock);
+	return closed ? -1 : 0;
+}
+
+/***********************************************************************************
+ * void pipeAdvance( TracePipe *pipe, atomic_long *index )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Moves the head or tail of the ring on by one chunk, which the
+ *					side moving it must own, and wakes the other side if it is
+ *					blocked in pipeWait.
+ *
+ * Parameters:
+ * 	pipe	I/O	TracePipe *		The pipe
+ * 	index	I/O	atomic_long *	The head or tail of the ring
+ ***********************************************************************************/
+static void pipeAdvance( TracePipe *pipe, atomic_long *index ) {
+	atomic_fetch_add(index, 1);
+	if( atomic_load(&pipe->sleepers) > 0 ) {
+		pthread_mutex_lock(&pipe->lock);
+		pthread_cond_broadcast(&pipe->moved);
+		pthread_mutex_unlock(&pipe->lock);
+	}
+}
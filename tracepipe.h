@@ -0,0 +1,53 @@
+/***********************************************************************************
+ * File: tracepipe.h
+ * Author: Justin Hardy
+ * Description: Declarations for the trace pipe, which reads and decodes a trace
+ *					file on its own thread, ahead of the simulations consuming it.
+ *					See tracepipe.c for implementation and details.
+ ***********************************************************************************/
+
+#ifndef TRACEPIPE_H
+#define TRACEPIPE_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "pages.h"
+#include "tracefile.h"
+
+// Trace pipe constants
+#define PIPE_CHUNKS		8		// Chunks of the ring (a power of two)
+#define PIPE_SPINS		64		// Polls of the ring before blocking
+
+// A block of decoded references of one trace
+typedef struct pipeChunk {
+	PageKey *pages;				// The references, with room for TRACE_BLOCK_REFS
+	uint64_t *writes;			// Bitmap of the references that are writes
+	long count;					// Number of references; -1 if the file could not be read
+	long trace;					// Number of the trace; -1 past the last trace or on failure
+	long length;				// Length of the trace
+	long offset;				// Position of the first reference within the trace
+} PipeChunk;
+
+// Trace pipe state. The reader thread is the only producer and the caller the
+// only consumer of the ring, so each index is written by one side only.
+typedef struct tracePipe {
+	TraceReader reader;			// The trace file
+	int pageShift;				// log2 of the page size of address traces
+	uint64_t *skip;				// Bitmap of the traces to skip without decoding
+	pthread_t thread;			// Reader thread
+	PipeChunk chunks[PIPE_CHUNKS];	// Ring of chunks
+	_Alignas(64) atomic_long head;	// Chunks filled by the reader so far
+	_Alignas(64) atomic_long tail;	// Chunks released by the consumer so far
+	atomic_int stop;			// Non-zero once the reader should exit
+	atomic_int sleepers;		// Number of sides blocked on moved
+	pthread_mutex_t lock;		// Protects the blocking on moved
+	pthread_cond_t moved;		// Signalled when head or tail moves with a side blocked
+} TracePipe;
+
+int tracePipeOpen(TracePipe*,const char*,int,int,const uint64_t[]);	// Starts reading a trace file
+const PipeChunk *tracePipeTake(TracePipe*);		// Waits for the next chunk
+void tracePipeRelease(TracePipe*);				// Hands the taken chunk back
+void tracePipeClose(TracePipe*);				// Stops reading and closes the file
+
+#endif
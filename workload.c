@@ -0,0 +1,708 @@
+/***********************************************************************************
+ * File: workload.c
+ * Author: Justin Hardy
+ * Procedures:
+ * rngSeed			- Seeds a random number generator for a given stream.
+ * rngSeedCounter	- Seeds a counter mode random number generator for a stream.
+ * rngSeek			- Moves a counter mode generator to a position of its stream.
+ * rngNext			- Generates 64 random bits (xoshiro256** or Philox4x32-10).
+ * rngUniform		- Generates a uniformly distributed double in [0, 1).
+ * rngBelow			- Generates a uniformly distributed integer below a bound.
+ * normal			- Generates a random number off of a normal distribution
+ *						with a specified mean and standard deviation.
+ * workloadParse	- Parses a workload specification given on the command line.
+ * workloadFree		- Frees a workload returned by workloadParse.
+ * workloadSample	- Samples the page referenced at a given position.
+ * workloadGenerate	- Generates a whole trace of a workload.
+ * workloadWrites		- Draws which references of a trace are writes.
+ * workloadSourceInit	- Prepares a source of the references of a trace on demand.
+ * workloadFill		- Generates references of a trace from any position.
+ * philox			- Generates 64 random bits in counter mode (Philox4x32-10).
+ * zipfSample		- Samples a Zipf distributed rank by rejection-inversion.
+ *
+ * Workload specifications have the form name[:key=value,...], where name is one of
+ *	regions						- the original 10 regions of normally distributed pages
+ *	uniform:pages=N				- pages drawn uniformly
+ *	zipf:pages=N,skew=S			- pages drawn with Zipf exponent S
+ *	scan						- a single sequential pass, never revisiting a page
+ *	loop:pages=N				- sequential passes over N pages, over and over
+ *	hotcold:pages=N,hot=F,prob=P	- a fraction F of the pages receives a
+ *									fraction P of the references
+ * and every simple workload also takes offset=K, the number of its first page.
+ * Simple workloads may be combined (without nesting) with
+ *	mix:A*w+B*w...				- each reference comes from a part chosen by weight
+ *	phase:L:A+B...				- parts take turns, each for L references
+ *
+ * Traces are normally generated whole by xoshiro256**, one stream per trace. A
+ * generator in counter mode instead uses Philox4x32-10 (Salmon et al., SC '11),
+ * a keyed bijection of a 128-bit counter: the draws of the reference at each
+ * position of a trace come from counters holding the trace, the position and
+ * the number of the draw, so any reference can be generated on its own, and a
+ * trace never has to be held in memory. Such traces are different from, but
+ * just as reproducible from the seed as, the ones generated whole.
+ ***********************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "workload.h"
+
+// Workload defaults
+#define WORKLOAD_PAGES		100		// Default number of distinct pages
+#define WORKLOAD_SKEW		0.99	// Default Zipf exponent
+#define WORKLOAD_HOT		0.2		// Default fraction of hot pages
+#define WORKLOAD_PROB		0.8		// Default probability of referencing a hot page
+
+static Workload *parseSimple(const char*,size_t);		// Parses a simple workload
+static uint64_t splitMix(uint64_t*);					// Advances a SplitMix64 state
+static uint64_t philox(Rng*);							// Generates in counter mode
+static void workloadFill(const PageSource*,long,PageKey[],long);	// Generates references
+static uint64_t zipfSample(const Workload*,Rng*);		// Samples a Zipf rank
+static double zipfH(const Workload*,double);			// Zipf hat function
+static double zipfIntegral(const Workload*,double);		// Integral of the hat function
+static double zipfIntegralInverse(const Workload*,double);	// Inverse of the integral
+
+/***********************************************************************************
+ * void rngSeed( Rng *rng, uint64_t seed, uint64_t stream )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Seeds a random number generator. Generators seeded with the same
+ *					seed but different streams (e.g. trace numbers) produce
+ *					unrelated sequences, so each trace can be generated on its
+ *					own, in any order and on any thread, with the same result.
+ *
+ * Parameters:
+ * 	rng		O/P	Rng *		The generator to seed
+ * 	seed	I/P	uint64_t	The seed of the whole run
+ * 	stream	I/P	uint64_t	The number of the stream within the run
+ ***********************************************************************************/
+void rngSeed( Rng *rng, uint64_t seed, uint64_t stream ) {
+	// Mix seed and stream, then expand them with SplitMix64
+	uint64_t state = seed ^ (stream * 0xd1b54a32d192ed03ULL);
+	int i;
+	splitMix(&state);
+	for( i = 0; i < 4; i++ ) {
+		rng->s[i] = splitMix(&state);
+	}
+	rng->counter = 0;
+}
+
+/***********************************************************************************
+ * void rngSeedCounter( Rng *rng, uint64_t seed, uint64_t stream )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Seeds a random number generator in counter mode, at position 0 of
+ *					a stream. Its draws depend only on the seed, the stream, the
+ *					position set with rngSeek and the number of draws since.
+ *
+ * Parameters:
+ * 	rng		O/P	Rng *		The generator to seed
+ * 	seed	I/P	uint64_t	The seed of the whole run
+ * 	stream	I/P	uint64_t	The number of the stream within the run
+ ***********************************************************************************/
+void rngSeedCounter( Rng *rng, uint64_t seed, uint64_t stream ) {
+	rng->s[0] = seed;
+	rng->s[1] = stream;
+	rng->s[2] = 0;
+	rng->s[3] = 0;
+	rng->counter = 1;
+}
+
+/***********************************************************************************
+ * void rngSeek( Rng *rng, long position )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Moves a counter mode generator to the first draw of a position of
+ *					its stream.
+ *
+ * Parameters:
+ * 	rng			I/O	Rng *	The generator to move
+ * 	position	I/P	long	The position, e.g. of a reference within a trace
+ ***********************************************************************************/
+void rngSeek( Rng *rng, long position ) {
+	rng->s[2] = (uint64_t)position;
+	rng->s[3] = 0;
+}
+
+/***********************************************************************************
+ * uint64_t rngNext( Rng *rng )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Generates 64 random bits using the xoshiro256** generator, or
+ *					Philox4x32-10 in counter mode.
+ *
+ * Parameters:
+ * 	rng		I/O	Rng *		The generator to advance
+ * 	rngNext	O/P	uint64_t	64 random bits
+ ***********************************************************************************/
+uint64_t rngNext( Rng *rng ) {
+	if( rng->counter ) {
+		return philox(rng);
+	}
+	uint64_t *s = rng->s;
+	uint64_t result = s[1] * 5;
+	result = ((result << 7) | (result >> 57)) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+	return result;
+}
+
+/***********************************************************************************
+ * double rngUniform( Rng *rng )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Generates a uniformly distributed double in [0, 1) from the top
+ *					53 bits of the generator's output.
+ *
+ * Parameters:
+ * 	rng			I/O	Rng *	The generator to advance
+ * 	rngUniform	O/P	double	A random number in [0, 1)
+ ***********************************************************************************/
+double rngUniform( Rng *rng ) {
+	return (rngNext(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/***********************************************************************************
+ * uint64_t rngBelow( Rng *rng, uint64_t bound )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Generates a uniformly distributed integer in [0, bound), using
+ *					Lemire's multiply-and-reject method, which avoids a division
+ *					in all but a tiny fraction of calls.
+ *
+ * Parameters:
+ * 	rng			I/O	Rng *		The generator to advance
+ * 	bound		I/P	uint64_t	The exclusive upper bound (non-zero)
+ * 	rngBelow	O/P	uint64_t	A random integer below bound
+ ***********************************************************************************/
+uint64_t rngBelow( Rng *rng, uint64_t bound ) {
+	__uint128_t product = (__uint128_t)rngNext(rng) * bound;
+	uint64_t low = (uint64_t)product;
+	if( low < bound ) {
+		uint64_t threshold = (0 - bound) % bound;
+		while( low < threshold ) {
+			product = (__uint128_t)rngNext(rng) * bound;
+			low = (uint64_t)product;
+		}
+	}
+	return (uint64_t)(product >> 64);
+}
+
+/***********************************************************************************
+ * int normal( Rng *rng, int mean, int sd )
+ * Author: Justin Hardy
+ * Date: 19 November 2021
+ * Description: Generates a normal, random number distribution with a specified mean
+ * 					and standard deviation.
+ *
+ * Parameters:
+ * 	rng		I/O	Rng *	The generator to draw random numbers from.
+ * 	mean	I/P	int		The mean of the normal distribution.
+ * 	sd		I/P	int		The standard deviation of the normal
+ *							distribution.
+ * 	normal	O/P	int		A randomly generated number within the
+ *							normal distribution.
+ ***********************************************************************************/
+int normal( Rng *rng, int mean, int sd ) {
+	// Generate random number 1
+	double r1;
+	do {
+		// Make sure the random number is not 0!!
+		// Otherwise the program crashes :(
+		r1 = rngUniform(rng);
+	} while(r1 == 0.0);
+
+	// Generate random number 2
+	double r2 = rngUniform(rng);
+
+	// Use normal distribution formula to generate random number
+	return (int) ((( sqrt(-2.0 * log(r1) ) * cos(2.0 * M_PI * r2 )) * sd) + mean);
+}
+
+/***********************************************************************************
+ * Workload *workloadParse( const char *text )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a workload specification (see the top of this file) and
+ *					precomputes the constants of its samplers.
+ *
+ * Parameters:
+ * 	text			I/P	const char *	The specification to be parsed
+ * 	workloadParse	O/P	Workload *		The workload, NULL if text is invalid
+ ***********************************************************************************/
+Workload *workloadParse( const char *text ) {
+	Workload *workload;
+	const char *part, *end;
+	char *rest;
+
+	// Simple workloads are parsed directly
+	int phase = strncmp(text, "phase:", 6) == 0;
+	if( !phase && strncmp(text, "mix:", 4) != 0 ) {
+		return parseSimple(text, strlen(text));
+	}
+
+	// Create combined workload
+	workload = calloc(1, sizeof(Workload));
+	if( workload == NULL ) {
+		return NULL;
+	}
+	workload->kind = phase ? WORKLOAD_PHASE : WORKLOAD_MIX;
+	part = text + (phase ? 6 : 4);
+
+	// Phases are preceded by their length
+	if( phase ) {
+		workload->phaseLength = strtol(part, &rest, 10);
+		if( rest == part || *rest != ':' || workload->phaseLength <= 0 ) {
+			workloadFree(workload);
+			return NULL;
+		}
+		part = rest + 1;
+	}
+
+	// Parse each part up to the next '+'
+	double total = 0.0;
+	for( ; ; part = end + 1 ) {
+		end = strchr(part, '+');
+		if( end == NULL ) {
+			end = part + strlen(part);
+		}
+
+		// Mix parts may end with a weight
+		size_t length = end - part;
+		double weight = 1.0;
+		const char *star = memchr(part, '*', length);
+		if( !phase && star != NULL ) {
+			weight = strtod(star + 1, &rest);
+			if( rest != end || !(weight > 0.0) ) {
+				workloadFree(workload);
+				return NULL;
+			}
+			length = star - part;
+		}
+
+		// Parse part
+		if( workload->parts == WORKLOAD_MAX_PARTS ||
+			(workload->part[workload->parts] = parseSimple(part, length)) == NULL ) {
+			workloadFree(workload);
+			return NULL;
+		}
+		total += weight;
+		workload->weight[workload->parts++] = total;
+
+		// Stop after the last part
+		if( *end == '\0' ) {
+			break;
+		}
+	}
+
+	// Normalize cumulative weights so that the last one is exactly 1
+	int i;
+	for( i = 0; i < workload->parts; i++ ) {
+		workload->weight[i] /= total;
+	}
+	workload->weight[workload->parts - 1] = 1.0;
+	return workload;
+}
+
+/***********************************************************************************
+ * void workloadFree( Workload *workload )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Frees a workload returned by workloadParse, including its parts.
+ *
+ * Parameters:
+ * 	workload	I/O	Workload *	The workload to be freed
+ ***********************************************************************************/
+void workloadFree( Workload *workload ) {
+	int i;
+	if( workload != NULL ) {
+		for( i = 0; i < workload->parts; i++ ) {
+			free(workload->part[i]);
+		}
+		free(workload);
+	}
+}
+
+/***********************************************************************************
+ * PageKey workloadSample( const Workload *workload, Rng *rng, long position )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Samples the page referenced at a given position of a trace. Every
+ *					sampler takes constant time per reference.
+ *
+ * Parameters:
+ * 	workload		I/P	const Workload *	The workload to sample
+ * 	rng				I/O	Rng *				The generator to draw from
+ * 	position		I/P	long				The position in the trace
+ * 	workloadSample	O/P	PageKey				The page referenced
+ ***********************************************************************************/
+PageKey workloadSample( const Workload *workload, Rng *rng, long position ) {
+	uint64_t hot;
+	double u;
+	int i;
+
+	switch( workload->kind ) {
+		case WORKLOAD_REGIONS:
+			// Generate a random set of numbers (mean 10, sd 2), in 10 regions
+			return workload->offset + (PageKey)(int64_t)( ( 10 * ((int)(position/100)) ) + normal(rng, 10, 2) );
+		case WORKLOAD_UNIFORM:
+			return workload->offset + rngBelow(rng, workload->pages);
+		case WORKLOAD_ZIPF:
+			return workload->offset + zipfSample(workload, rng) - 1;
+		case WORKLOAD_SCAN:
+			return workload->offset + (PageKey)position;
+		case WORKLOAD_LOOP:
+			return workload->offset + (PageKey)position % workload->pages;
+		case WORKLOAD_HOTCOLD:
+			// Pick the hot or the cold set, then a page within it
+			hot = (uint64_t)(workload->pages * workload->hotFraction);
+			hot = hot < 1 ? 1 : hot;
+			if( hot == workload->pages || rngUniform(rng) < workload->hotProbability ) {
+				return workload->offset + rngBelow(rng, hot);
+			}
+			return workload->offset + hot + rngBelow(rng, workload->pages - hot);
+		case WORKLOAD_MIX:
+			// Pick a part by its weight
+			u = rngUniform(rng);
+			for( i = 0; u >= workload->weight[i]; i++ );
+			return workloadSample(workload->part[i], rng, position);
+		case WORKLOAD_PHASE:
+			// Pick the part whose turn it is
+			return workloadSample(workload->part[(position / workload->phaseLength) % workload->parts], rng, position);
+	}
+	return 0;
+}
+
+/***********************************************************************************
+ * void workloadGenerate( const Workload *workload, Rng *rng, PageKey trace[],
+ *						long length )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Generates a whole trace of a workload.
+ *
+ * Parameters:
+ * 	workload	I/P	const Workload *	The workload to generate
+ * 	rng			I/O	Rng *				The generator to draw from
+ * 	trace		O/P	PageKey []			The generated references
+ * 	length		I/P	long				The number of references
+ ***********************************************************************************/
+void workloadGenerate( const Workload *workload, Rng *rng, PageKey trace[], long length ) {
+	long j;
+	for( j = 0; j < length; j++ ) {
+		trace[j] = workloadSample(workload, rng, j);
+	}
+}
+
+/***********************************************************************************
+ * void workloadWrites( Rng *rng, double fraction, uint64_t writes[], long length )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Draws which references of a trace are writes, each one with the
+ *					same probability. Drawn after the references themselves, so
+ *					that the pages of a trace do not depend on its writes.
+ *
+ * Parameters:
+ * 	rng			I/O	Rng *		The generator to draw from
+ * 	fraction	I/P	double		The probability of a reference being a write
+ * 	writes		O/P	uint64_t []	Bitmap of the references that are writes
+ * 	length		I/P	long		The number of references
+ ***********************************************************************************/
+void workloadWrites( Rng *rng, double fraction, uint64_t writes[], long length ) {
+	long j;
+	memset(writes, 0, BITMAP_WORDS(length) * sizeof(uint64_t));
+	for( j = 0; j < length; j++ ) {
+		if( rngUniform(rng) < fraction ) {
+			bitmapSet(writes, j);
+		}
+	}
+}
+
+/***********************************************************************************
+ * void workloadSourceInit( WorkloadSource *source, const Workload *workload,
+ *						uint64_t seed, uint64_t stream )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Prepares a source producing the references of one trace of a
+ *					workload on demand, from a counter mode generator.
+ *
+ * Parameters:
+ * 	source		O/P	WorkloadSource *	The source to prepare
+ * 	workload	I/P	const Workload *	The workload to generate
+ * 	seed		I/P	uint64_t			The seed of the whole run
+ * 	stream		I/P	uint64_t			The number of the trace within the run
+ ***********************************************************************************/
+void workloadSourceInit( WorkloadSource *source, const Workload *workload, uint64_t seed, uint64_t stream ) {
+	source->source.fill = workloadFill;
+	source->workload = workload;
+	rngSeedCounter(&source->rng, seed, stream);
+}
+
+/***********************************************************************************
+ * void workloadFill( const PageSource *source, long start, PageKey block[],
+ *					long count )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Generates the references of a workload source at positions start
+ *					to start + count - 1, each from its own position of the
+ *					counter mode generator.
+ *
+ * Parameters:
+ * 	source	I/P	const PageSource *	The WorkloadSource to generate from
+ * 	start	I/P	long				The position of the first reference
+ * 	block	O/P	PageKey []			The generated references
+ * 	count	I/P	long				The number of references
+ ***********************************************************************************/
+static void workloadFill( const PageSource *source, long start, PageKey block[], long count ) {
+	const WorkloadSource *workload = (const WorkloadSource *)source;
+	Rng rng = workload->rng;
+	long j;
+
+	for( j = 0; j < count; j++ ) {
+		rngSeek(&rng, start + j);
+		block[j] = workloadSample(workload->workload, &rng, start + j);
+	}
+}
+
+/***********************************************************************************
+ * Workload *parseSimple( const char *text, size_t length )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Parses a simple (not combined) workload specification of the form
+ *					name[:key=value,...], which need not be null terminated.
+ *
+ * Parameters:
+ * 	text		I/P	const char *	The specification to be parsed
+ * 	length		I/P	size_t			The length of the specification
+ * 	parseSimple	O/P	Workload *		The workload, NULL if text is invalid
+ ***********************************************************************************/
+static Workload *parseSimple( const char *text, size_t length ) {
+	static const char *names[] = { "regions", "uniform", "zipf", "scan", "loop", "hotcold" };
+	char buffer[256], *key, *value, *rest;
+	size_t nameLength;
+	int kind;
+
+	// Copy the specification so that it can be tokenized
+	if( length >= sizeof(buffer) ) {
+		return NULL;
+	}
+	memcpy(buffer, text, length);
+	buffer[length] = '\0';
+
+	// Look up the workload name
+	nameLength = strcspn(buffer, ":");
+	for( kind = 0; kind < (int)(sizeof(names) / sizeof(names[0])); kind++ ) {
+		if( strlen(names[kind]) == nameLength && strncmp(buffer, names[kind], nameLength) == 0 ) {
+			break;
+		}
+	}
+	if( kind == (int)(sizeof(names) / sizeof(names[0])) ) {
+		return NULL;
+	}
+
+	// Create workload with default parameters
+	Workload *workload = calloc(1, sizeof(Workload));
+	if( workload == NULL ) {
+		return NULL;
+	}
+	workload->kind = (WorkloadKind)kind;
+	workload->pages = WORKLOAD_PAGES;
+	workload->skew = WORKLOAD_SKEW;
+	workload->hotFraction = WORKLOAD_HOT;
+	workload->hotProbability = WORKLOAD_PROB;
+
+	// Parse key=value parameters
+	for( key = buffer[nameLength] ? strtok(buffer + nameLength + 1, ",") : NULL; key != NULL; key = strtok(NULL, ",") ) {
+		value = strchr(key, '=');
+		if( value == NULL ) {
+			free(workload);
+			return NULL;
+		}
+		*value++ = '\0';
+		if( strcmp(key, "pages") == 0 ) {
+			workload->pages = strtoull(value, &rest, 10);
+		}
+		else if( strcmp(key, "offset") == 0 ) {
+			workload->offset = strtoull(value, &rest, 10);
+		}
+		else if( strcmp(key, "skew") == 0 ) {
+			workload->skew = strtod(value, &rest);
+		}
+		else if( strcmp(key, "hot") == 0 ) {
+			workload->hotFraction = strtod(value, &rest);
+		}
+		else if( strcmp(key, "prob") == 0 ) {
+			workload->hotProbability = strtod(value, &rest);
+		}
+		else {
+			rest = value;
+		}
+		if( rest == value || *rest != '\0' ) {
+			free(workload);
+			return NULL;
+		}
+	}
+
+	// Validate parameters
+	if( workload->pages == 0 || !(workload->skew > 0.0) ||
+		!(workload->hotFraction > 0.0 && workload->hotFraction <= 1.0) ||
+		!(workload->hotProbability >= 0.0 && workload->hotProbability <= 1.0) ) {
+		free(workload);
+		return NULL;
+	}
+
+	// Precompute Zipf sampler constants
+	if( workload->kind == WORKLOAD_ZIPF ) {
+		workload->zipfIntegralX1 = zipfIntegral(workload, 1.5) - 1.0;
+		workload->zipfIntegralN = zipfIntegral(workload, workload->pages + 0.5);
+		workload->zipfThreshold = 2.0 - zipfIntegralInverse(workload, zipfIntegral(workload, 2.5) - zipfH(workload, 2.0));
+	}
+	return workload;
+}
+
+/***********************************************************************************
+ * uint64_t splitMix( uint64_t *state )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Advances a SplitMix64 state and returns its next output.
+ *
+ * Parameters:
+ * 	state		I/O	uint64_t *	The state to advance
+ * 	splitMix	O/P	uint64_t	64 well mixed bits
+ ***********************************************************************************/
+static uint64_t splitMix( uint64_t *state ) {
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/***********************************************************************************
+ * uint64_t philox( Rng *rng )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Generates 64 random bits in counter mode, as half of the
+ *					Philox4x32-10 block of the counter (position, draw, stream)
+ *					under the seed as key, then counts the draw.
+ *
+ * Parameters:
+ * 	rng		I/O	Rng *		The counter mode generator
+ * 	philox	O/P	uint64_t	64 random bits
+ ***********************************************************************************/
+static uint64_t philox( Rng *rng ) {
+	uint32_t c0 = (uint32_t)rng->s[2], c1 = (uint32_t)(rng->s[2] >> 32);
+	uint32_t c2 = (uint32_t)rng->s[3], c3 = (uint32_t)rng->s[1];
+	uint32_t k0 = (uint32_t)rng->s[0], k1 = (uint32_t)(rng->s[0] >> 32) ^ (uint32_t)(rng->s[1] >> 32);
+	int round;
+
+	for( round = 0; round < 10; round++ ) {
+		uint64_t p0 = (uint64_t)0xD2511F53 * c0, p1 = (uint64_t)0xCD9E8D57 * c2;
+		c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+		c1 = (uint32_t)p1;
+		c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+		c3 = (uint32_t)p0;
+		k0 += 0x9E3779B9;
+		k1 += 0xBB67AE85;
+	}
+	rng->s[3]++;
+	return ((uint64_t)c0 << 32) | c1;
+}
+
+/***********************************************************************************
+ * uint64_t zipfSample( const Workload *workload, Rng *rng )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Samples a rank in [1, pages] with probability proportional to
+ *					rank^-skew, using the rejection-inversion method of Hormann
+ *					and Derflinger. A candidate is drawn by inverting the integral
+ *					of a hat function, and almost always accepted, so sampling
+ *					takes constant expected time regardless of the number of
+ *					pages, without any table.
+ *
+ * Parameters:
+ * 	workload	I/P	const Workload *	The Zipf workload to sample
+ * 	rng			I/O	Rng *				The generator to draw from
+ * 	zipfSample	O/P	uint64_t			The sampled rank
+ ***********************************************************************************/
+static uint64_t zipfSample( const Workload *workload, Rng *rng ) {
+	for( ; ; ) {
+		// Invert the hat integral at a uniform point
+		double u = workload->zipfIntegralN + rngUniform(rng) * (workload->zipfIntegralX1 - workload->zipfIntegralN);
+		double x = zipfIntegralInverse(workload, u);
+
+		// Round to the nearest rank
+		double k = floor(x + 0.5);
+		if( k < 1.0 ) {
+			k = 1.0;
+		}
+		else if( k > (double)workload->pages ) {
+			k = (double)workload->pages;
+		}
+
+		// Accept the rank if it lies under the distribution
+		if( k - x <= workload->zipfThreshold || u >= zipfIntegral(workload, k + 0.5) - zipfH(workload, k) ) {
+			return (uint64_t)k;
+		}
+	}
+}
+
+/***********************************************************************************
+ * double zipfH( const Workload *workload, double x )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Evaluates the Zipf hat function x^-skew.
+ *
+ * Parameters:
+ * 	workload	I/P	const Workload *	The Zipf workload
+ * 	x			I/P	double				The point to evaluate
+ * 	zipfH		O/P	double				x^-skew
+ ***********************************************************************************/
+static double zipfH( const Workload *workload, double x ) {
+	return exp(-workload->skew * log(x));
+}
+
+/***********************************************************************************
+ * double zipfIntegral( const Workload *workload, double x )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Evaluates the integral of the Zipf hat function, (x^(1-skew) - 1) /
+ *					(1 - skew), which tends to log(x) as skew tends to 1. The
+ *					(e^t - 1) / t factor is expanded near 0 to stay accurate.
+ *
+ * Parameters:
+ * 	workload		I/P	const Workload *	The Zipf workload
+ * 	x				I/P	double				The point to evaluate
+ * 	zipfIntegral	O/P	double				The integral at x
+ ***********************************************************************************/
+static double zipfIntegral( const Workload *workload, double x ) {
+	double logX = log(x);
+	double t = (1.0 - workload->skew) * logX;
+	double factor = fabs(t) > 1e-8 ? expm1(t) / t : 1.0 + t * 0.5 * (1.0 + t / 3.0 * (1.0 + t * 0.25));
+	return factor * logX;
+}
+
+/***********************************************************************************
+ * double zipfIntegralInverse( const Workload *workload, double x )
+ * Author: Justin Hardy
+ * Date: 16 October 2026
+ * Description: Evaluates the inverse of zipfIntegral. The log(1 + t) / t factor
+ *					is expanded near 0 to stay accurate.
+ *
+ * Parameters:
+ * 	workload			I/P	const Workload *	The Zipf workload
+ * 	x					I/P	double				The point to evaluate
+ * 	zipfIntegralInverse	O/P	double				The inverse at x
+ ***********************************************************************************/
+static double zipfIntegralInverse( const Workload *workload, double x ) {
+	double t = x * (1.0 - workload->skew);
+	if( t < -1.0 ) {
+		// Guard against rounding errors near the lower limit
+		t = -1.0;
+	}
+	double factor = fabs(t) > 1e-8 ? log1p(t) / t : 1.0 - t * (0.5 - t * (1.0 / 3.0 - t * 0.25));
+	return exp(factor * x);
+}
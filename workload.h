@@ -0,0 +1,76 @@
+/***********************************************************************************
+ * File: workload.h
+ * Author: Justin Hardy
+ * Description: Declarations for the random number generator and the synthetic
+ *					workload generators. See workload.c for implementation and
+ *					details of the workload specification syntax.
+ ***********************************************************************************/
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+#include "pages.h"
+
+// Workload constants
+#define WORKLOAD_MAX_PARTS	8		// Maximum number of parts of a mix or phase workload
+
+// Kinds of workloads
+typedef enum workloadKind {
+	WORKLOAD_REGIONS,		// 10 regions of normally distributed pages (the original workload)
+	WORKLOAD_UNIFORM,		// Uniformly distributed pages
+	WORKLOAD_ZIPF,			// Zipf distributed pages
+	WORKLOAD_SCAN,			// A single sequential pass over new pages
+	WORKLOAD_LOOP,			// Repeated sequential passes over the same pages
+	WORKLOAD_HOTCOLD,		// A hot set receiving most references, and a cold set
+	WORKLOAD_MIX,			// Each reference drawn from a randomly chosen part
+	WORKLOAD_PHASE			// Parts take turns, each for a fixed number of references
+} WorkloadKind;
+
+// Pseudo random number generator state: xoshiro256**, or Philox4x32-10 in
+// counter mode, where s holds the key, stream, position and draw counters
+typedef struct rng {
+	uint64_t s[4];
+	int counter;				// Non-zero in counter mode
+} Rng;
+
+// Workload description, with any sampler constants precomputed
+typedef struct workload {
+	WorkloadKind kind;			// Kind of workload
+	uint64_t pages;				// Number of distinct pages
+	uint64_t offset;			// First page of the workload
+	double skew;				// Zipf exponent
+	double hotFraction;			// Fraction of pages in the hot set
+	double hotProbability;		// Probability of referencing the hot set
+	long phaseLength;			// References per phase of a phase workload
+	int parts;					// Number of parts of a mix or phase workload
+	struct workload *part[WORKLOAD_MAX_PARTS];	// Parts of a mix or phase workload
+	double weight[WORKLOAD_MAX_PARTS];			// Cumulative weights of a mix workload
+	double zipfIntegralX1;		// Zipf sampler: H(1.5) - 1
+	double zipfIntegralN;		// Zipf sampler: H(pages + 0.5)
+	double zipfThreshold;		// Zipf sampler: acceptance shortcut threshold
+} Workload;
+
+// References of a generated trace, produced on demand by a counter mode
+// generator, so that every reference is a pure function of its position
+typedef struct workloadSource {
+	PageSource source;			// Source interface; must be first
+	const Workload *workload;	// The workload
+	Rng rng;					// Counter mode generator of the trace's stream
+} WorkloadSource;
+
+void rngSeed(Rng*,uint64_t,uint64_t);				// Seeds a generator for a stream
+void rngSeedCounter(Rng*,uint64_t,uint64_t);		// Seeds a counter mode generator
+void rngSeek(Rng*,long);							// Moves a counter mode generator
+uint64_t rngNext(Rng*);								// Gets 64 random bits
+double rngUniform(Rng*);							// Gets a uniform double in [0, 1)
+uint64_t rngBelow(Rng*,uint64_t);					// Gets a uniform integer below a bound
+int normal(Rng*,int,int);							// Gets a normally distributed integer
+Workload *workloadParse(const char*);				// Parses a workload specification
+void workloadFree(Workload*);						// Frees a parsed workload
+PageKey workloadSample(const Workload*,Rng*,long);	// Samples one reference
+void workloadGenerate(const Workload*,Rng*,PageKey[],long);	// Generates a trace
+void workloadWrites(Rng*,double,uint64_t[],long);	// Draws the writes of a trace
+void workloadSourceInit(WorkloadSource*,const Workload*,uint64_t,uint64_t);	// Prepares a source
+
+#endif